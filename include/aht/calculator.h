@@ -1,6 +1,8 @@
 #pragma once
 #include <Arduino.h>
+#include "constants.h"
 #include "analysis/text_parser.h"
+#include "timing/interval_sweep.h"
 
 namespace TimeAnalysis {
     struct DurationAnalysis {
@@ -23,105 +25,44 @@ namespace TimeAnalysis {
         std::vector<TimeRange> overlaps;  // List of overlapping sections
     };
 
+    // Sweep helpers behind Analysis::TaskAnalyzer, which walks the clips
+    // once and fills the scratch itself
     class DurationCalculator {
     public:
-        static DurationAnalysis analyze(const Analysis::TextParser::ParseResult& parseResult) {
-            DurationAnalysis analysis;
-            if (parseResult.clips.empty()) return analysis;
-
-            findGlobalTimeRange(parseResult, analysis);
-            analyzeTimeframes(parseResult, analysis);
-            calculateUtilization(analysis);
-            
-            return analysis;
+        // Runs the sweep over a filled scratch
+        static void analyzeIntervals(Timing::SweepScratch& scratch, DurationAnalysis& analysis) {
+            RangeCollector collector{analysis};
+            auto totals = Timing::IntervalSweep::run(scratch, collector);
+
+            analysis.effectiveMillis = totals.coveredMillis;
+            analysis.overlapMillis = totals.overlapMillis;
+            analysis.gapMillis = totals.gapMillis;
         }
 
-        static bool validateTiming(const Analysis::TextParser::ParseResult& parseResult, 
-                                 String& errorMessage) {
-            if (parseResult.clips.empty()) {
-                errorMessage = "No clips found";
-                return false;
-            }
-
-            return validateClipSequence(parseResult, errorMessage) && 
-                   validateTimeframes(parseResult, errorMessage);
+        // Static buffer used when the caller brings no storage of its own
+        static Timing::SweepScratch defaultScratch() {
+            static Timing::SweepBuffer<Constants::Timing::MAX_SWEEP_INTERVALS> buffer;
+            return buffer.scratch();
         }
 
-    private:
-        static void findGlobalTimeRange(
-            const Analysis::TextParser::ParseResult& parseResult,
-            DurationAnalysis& analysis) {
-            
-            uint32_t globalStart = UINT32_MAX;
-            uint32_t globalEnd = 0;
-
+        static size_t countTimeframes(const Analysis::TextParser::ParseResult& parseResult) {
+            size_t count = 0;
             for (const auto& clip : parseResult.clips) {
-                for (const auto& frame : clip.timeframes) {
-                    uint32_t startMs = frame.startTime.toMillis();
-                    uint32_t endMs = frame.endTime.toMillis();
-                    
-                    globalStart = std::min(globalStart, startMs);
-                    globalEnd = std::max(globalEnd, endMs);
-                }
+                count += clip.timeframes.size();
             }
-
-            analysis.totalMillis = globalEnd - globalStart;
+            return count;
         }
 
-        static void analyzeTimeframes(
-            const Analysis::TextParser::ParseResult& parseResult,
-            DurationAnalysis& analysis) {
-            
-            std::vector<std::pair<uint32_t, int>> events;  // time, +1/-1 for start/end
-            
-            // Build timeline of events
-            for (const auto& clip : parseResult.clips) {
-                for (const auto& frame : clip.timeframes) {
-                    events.push_back(std::make_pair(frame.startTime.toMillis(), 1));
-                    events.push_back(std::make_pair(frame.endTime.toMillis(), -1));
-                }
-            }
-
-            // Sort events chronologically
-            std::sort(events.begin(), events.end());
-
-            // Analyze timeline
-            int activeFrames = 0;
-            uint32_t lastTime = events[0].first;
-            uint32_t coveredTime = 0;
-            DurationAnalysis::TimeRange currentRange = {0, 0};
+        // Tasks larger than the scratch fall back to a heap buffer
+        static void ensureCapacity(Timing::SweepScratch& scratch, size_t needed,
+                                   std::vector<uint32_t>& overflow) {
+            scratch.clear();
+            if (needed <= scratch.capacity) return;
 
-            for (const auto& event : events) {
-                uint32_t currentTime = event.first;
-                
-                if (activeFrames > 0) {
-                    coveredTime += currentTime - lastTime;
-                }
-
-                // Handle overlaps
-                if (activeFrames > 1) {
-                    analysis.overlapMillis += currentTime - lastTime;
-                    if (currentRange.startMillis == 0) {
-                        currentRange.startMillis = lastTime;
-                    }
-                } else if (activeFrames == 1 && currentRange.startMillis > 0) {
-                    currentRange.endMillis = lastTime;
-                    analysis.overlaps.push_back(currentRange);
-                    currentRange = {0, 0};
-                }
-
-                // Handle gaps
-                if (activeFrames == 0 && lastTime > events[0].first) {
-                    DurationAnalysis::TimeRange gap = {lastTime, currentTime};
-                    analysis.gaps.push_back(gap);
-                    analysis.gapMillis += currentTime - lastTime;
-                }
-
-                activeFrames += event.second;
-                lastTime = currentTime;
-            }
-
-            analysis.effectiveMillis = coveredTime;
+            overflow.resize(needed * 2);
+            scratch.starts = overflow.data();
+            scratch.ends = overflow.data() + needed;
+            scratch.capacity = needed;
         }
 
         static void calculateUtilization(DurationAnalysis& analysis) {
@@ -129,65 +70,18 @@ namespace TimeAnalysis {
                 (float)analysis.effectiveMillis / analysis.totalMillis * 100.0f : 0;
         }
 
-        static bool validateClipSequence(
-            const Analysis::TextParser::ParseResult& parseResult,
-            String& errorMessage) {
-            
-            uint32_t lastEndTime = 0;
-            int expectedClipNum = 1;
-
-            for (const auto& clip : parseResult.clips) {
-                if (clip.number != expectedClipNum) {
-                    errorMessage = "Invalid clip numbering sequence";
-                    return false;
-                }
-
-                uint32_t clipStartTime = UINT32_MAX;
-                uint32_t clipEndTime = 0;
-
-                for (const auto& frame : clip.timeframes) {
-                    uint32_t startMs = frame.startTime.toMillis();
-                    uint32_t endMs = frame.endTime.toMillis();
-
-                    if (endMs <= startMs) {
-                        errorMessage = "Invalid timeframe duration in clip " + 
-                                     String(clip.number);
-                        return false;
-                    }
-
-                    clipStartTime = std::min(clipStartTime, startMs);
-                    clipEndTime = std::max(clipEndTime, endMs);
-                }
-
-                if (lastEndTime > 0 && clipStartTime < lastEndTime) {
-                    errorMessage = "Clip " + String(clip.number) + 
-                                 " overlaps with previous clip";
-                    return false;
-                }
+    private:
+        struct RangeCollector {
+            DurationAnalysis& analysis;
 
-                lastEndTime = clipEndTime;
-                expectedClipNum++;
+            void onGap(uint32_t startMillis, uint32_t endMillis) {
+                analysis.gaps.push_back({startMillis, endMillis});
             }
 
-            return true;
-        }
-
-        static bool validateTimeframes(
-            const Analysis::TextParser::ParseResult& parseResult,
-            String& errorMessage) {
-            
-            for (const auto& clip : parseResult.clips) {
-                for (const auto& frame : clip.timeframes) {
-                    if (frame.endTime.toMillis() <= frame.startTime.toMillis()) {
-                        errorMessage = "Invalid timeframe in clip " + 
-                                     String(clip.number);
-                        return false;
-                    }
-                }
+            void onOverlap(uint32_t startMillis, uint32_t endMillis) {
+                analysis.overlaps.push_back({startMillis, endMillis});
             }
-
-            return true;
-        }
+        };
     };
 }
 
@@ -1,17 +1,9 @@
 #pragma once
 #include <Arduino.h>
-
-#ifndef DEBUG_PRINT
-    #define DEBUG_PRINT(x)
-#endif
-
-#ifndef DEBUG_PRINTLN
-    #define DEBUG_PRINTLN(x)
-#endif
+#include "aht/graph_data.h"
+#include "utils/log.h"
 
 namespace AHT {
-    constexpr uint32_t MILLIS_PER_MINUTE = 60000;
-
     // Add this struct before TimeDistributor
     struct TimeAllocation {
         uint32_t totalMillis;       // Total allocated time
@@ -107,9 +99,8 @@ namespace AHT {
         float estimatedWords;
 
         void calculateActivityTimings() {
-            DEBUG_PRINTLN("Calculating activity timings...");
-            DEBUG_PRINT("Total millis: ");
-            DEBUG_PRINTLN(totalAllocation.totalMillis);
+            LOG_DEBUG("Calculating activity timings...");
+            LOG_DEBUG("Total millis: %lu", (unsigned long)totalAllocation.totalMillis);
             
             float totalMinutes = totalAllocation.totalMillis / (float)MILLIS_PER_MINUTE;
             timings.baseWPM = estimatedWords / totalMinutes;
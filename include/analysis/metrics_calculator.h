@@ -32,104 +32,97 @@ namespace Analysis {
 
     class MetricsCalculator {
     public:
-        static TaskMetrics calculate(const TextParser::ParseResult& parseResult) {
-            TaskMetrics metrics = {};
-            if (parseResult.clips.empty()) return metrics;
-
-            // Initialize counters
-            int totalWords = 0;
-            int totalChars = 0;
-            int totalTimeframes = 0;
-            int totalCameraActions = 0;
-            uint32_t totalDuration = 0;
-            
-            // Process each clip
-            for (const auto& clip : parseResult.clips) {
-                totalWords += clip.wordCount;
-                totalChars += clip.charCount;
-                totalTimeframes += clip.timeframes.size();
-                totalCameraActions += clip.cameraMovements + clip.cameraTransitions;
-                totalDuration = max(totalDuration, clip.totalDurationMillis);
+        // Running totals for a single pass over the clips. calculate() and
+        // the fused TaskAnalyzer both feed it, so the formulas live in one place.
+        struct Totals {
+            int clips = 0;
+            int words = 0;
+            int chars = 0;
+            int timeframes = 0;
+            int cameraActions = 0;
+            int transitions = 0;
+            uint32_t maxClipDuration = 0;
+            uint32_t lastClipDuration = 0;
+            uint32_t frameDurationSum = 0;
+            uint32_t overlapSum = 0;
+
+            void addClip(const ClipData& clip) {
+                clips++;
+                words += clip.wordCount;
+                chars += clip.charCount;
+                timeframes += clip.timeframes.size();
+                cameraActions += clip.cameraMovements + clip.cameraTransitions;
+                transitions += clip.cameraTransitions;
+                maxClipDuration = max(maxClipDuration, clip.totalDurationMillis);
+                lastClipDuration = clip.totalDurationMillis;
             }
 
-            // Store basic totals
-            metrics.totalClips = parseResult.clips.size();
-            metrics.totalTimeframes = totalTimeframes;
-            metrics.totalDurationMillis = totalDuration;
-            metrics.totalWords = totalWords;
-
-            // Calculate time density metrics
-            float durationSeconds = totalDuration / 1000.0f;
-            metrics.charsPerSecond = totalChars / durationSeconds;
-            metrics.wordsPerSecond = totalWords / durationSeconds;
-            metrics.averageWordLength = totalWords > 0 ? 
-                                      (float)totalChars / totalWords : 0;
-
-            // Calculate complexity metrics
-            metrics.timeframesPerClip = (float)totalTimeframes / metrics.totalClips;
-            metrics.averageTimeframeDuration = calculateAverageTimeframeDuration(parseResult);
-            metrics.timeframeOverlapPercent = calculateTimeframeOverlap(parseResult);
-
-            // Calculate camera action metrics
-            metrics.cameraActionsPerClip = (float)totalCameraActions / metrics.totalClips;
-            metrics.cameraActionDensity = totalCameraActions / durationSeconds;
-            metrics.transitionFrequency = calculateTransitionFrequency(parseResult);
+            // next is the following timeframe in the same clip, if any
+            void addFrame(const TimeFrame& frame, const TimeFrame* next) {
+                frameDurationSum += frame.getDurationMillis();
 
-            // Calculate text length metrics
-            metrics.averageWordsPerClip = (float)totalWords / metrics.totalClips;
-            metrics.descriptionDensity = (float)totalWords / totalTimeframes;
-
-            return metrics;
-        }
+                if (next) {
+                    uint32_t endMs = frame.endTime.toMillis();
+                    uint32_t nextStartMs = next->startTime.toMillis();
+                    if (endMs > nextStartMs) {
+                        overlapSum += endMs - nextStartMs;
+                    }
+                }
+            }
+        };
 
-    private:
-        static float calculateAverageTimeframeDuration(const TextParser::ParseResult& parseResult) {
-            uint32_t totalDuration = 0;
-            int count = 0;
+        static TaskMetrics calculate(const TextParser::ParseResult& parseResult) {
+            if (parseResult.clips.empty()) return TaskMetrics{};
 
+            Totals totals;
             for (const auto& clip : parseResult.clips) {
-                for (const auto& timeframe : clip.timeframes) {
-                    totalDuration += timeframe.getDurationMillis();
-                    count++;
+                totals.addClip(clip);
+                for (size_t i = 0; i < clip.timeframes.size(); i++) {
+                    const TimeFrame* next = i + 1 < clip.timeframes.size() ?
+                                            &clip.timeframes[i + 1] : nullptr;
+                    totals.addFrame(clip.timeframes[i], next);
                 }
             }
 
-            return count > 0 ? (totalDuration / 1000.0f) / count : 0;
+            return finish(totals);
         }
 
-        static float calculateTimeframeOverlap(const TextParser::ParseResult& parseResult) {
-            uint32_t totalOverlap = 0;
-            uint32_t totalTime = 0;
+        static TaskMetrics finish(const Totals& totals) {
+            TaskMetrics metrics = {};
+            if (totals.clips == 0) return metrics;
 
-            for (const auto& clip : parseResult.clips) {
-                for (size_t i = 0; i < clip.timeframes.size(); i++) {
-                    const auto& current = clip.timeframes[i];
-                    totalTime += current.getDurationMillis();
+            // Store basic totals
+            metrics.totalClips = totals.clips;
+            metrics.totalTimeframes = totals.timeframes;
+            metrics.totalDurationMillis = totals.maxClipDuration;
+            metrics.totalWords = totals.words;
 
-                    // Check for overlap with next timeframe
-                    if (i < clip.timeframes.size() - 1) {
-                        const auto& next = clip.timeframes[i + 1];
-                        if (current.endTime.toMillis() > next.startTime.toMillis()) {
-                            totalOverlap += current.endTime.toMillis() - 
-                                          next.startTime.toMillis();
-                        }
-                    }
-                }
-            }
+            // Calculate time density metrics
+            float durationSeconds = totals.maxClipDuration / 1000.0f;
+            metrics.charsPerSecond = totals.chars / durationSeconds;
+            metrics.wordsPerSecond = totals.words / durationSeconds;
+            metrics.averageWordLength = totals.words > 0 ? 
+                                      (float)totals.chars / totals.words : 0;
 
-            return totalTime > 0 ? 
-                   (float)totalOverlap / totalTime * 100.0f : 0;
-        }
+            // Calculate complexity metrics
+            metrics.timeframesPerClip = (float)totals.timeframes / metrics.totalClips;
+            metrics.averageTimeframeDuration = totals.timeframes > 0 ?
+                (totals.frameDurationSum / 1000.0f) / totals.timeframes : 0;
+            metrics.timeframeOverlapPercent = totals.frameDurationSum > 0 ? 
+                (float)totals.overlapSum / totals.frameDurationSum * 100.0f : 0;
 
-        static float calculateTransitionFrequency(const TextParser::ParseResult& parseResult) {
-            int totalTransitions = 0;
-            for (const auto& clip : parseResult.clips) {
-                totalTransitions += clip.cameraTransitions;
-            }
+            // Calculate camera action metrics
+            metrics.cameraActionsPerClip = (float)totals.cameraActions / metrics.totalClips;
+            metrics.cameraActionDensity = totals.cameraActions / durationSeconds;
+            float durationMinutes = totals.lastClipDuration / (1000.0f * 60.0f);
+            metrics.transitionFrequency = durationMinutes > 0 ?
+                totals.transitions / durationMinutes : 0;
+
+            // Calculate text length metrics
+            metrics.averageWordsPerClip = (float)totals.words / metrics.totalClips;
+            metrics.descriptionDensity = (float)totals.words / totals.timeframes;
 
-            float durationMinutes = parseResult.clips.back().totalDurationMillis / 
-                                  (1000.0f * 60.0f);
-            return durationMinutes > 0 ? totalTransitions / durationMinutes : 0;
+            return metrics;
         }
     };
-}
\ No newline at end of file
+}
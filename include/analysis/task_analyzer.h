@@ -0,0 +1,100 @@
+#pragma once
+#include <Arduino.h>
+#include "analysis/text_parser.h"
+#include "analysis/metrics_calculator.h"
+#include "aht/calculator.h"
+
+namespace Analysis {
+    // Duration, timing validation and MetricsCalculator's metrics, from one
+    // walk over the clips
+    struct TaskAnalysis {
+        TimeAnalysis::DurationAnalysis duration;
+        uint32_t typingMillis = 0;     // Sum of TYPING timeframe durations
+        TaskMetrics metrics = {};
+        bool timingValid = false;
+        String timingError;
+    };
+
+    class TaskAnalyzer {
+    public:
+        static TaskAnalysis analyze(const TextParser::ParseResult& parseResult) {
+            return analyze(parseResult, TimeAnalysis::DurationCalculator::defaultScratch());
+        }
+
+        static TaskAnalysis analyze(const TextParser::ParseResult& parseResult,
+                                    Timing::SweepScratch scratch) {
+            TaskAnalysis result;
+            if (parseResult.clips.empty()) {
+                result.timingError = "No clips found";
+                return result;
+            }
+
+            MetricsCalculator::Totals totals;
+            std::vector<uint32_t> overflow;
+            TimeAnalysis::DurationCalculator::ensureCapacity(
+                scratch, TimeAnalysis::DurationCalculator::countTimeframes(parseResult), overflow);
+            uint32_t globalStart = UINT32_MAX;
+            uint32_t globalEnd = 0;
+
+            // Validation state, first error wins
+            uint32_t lastClipEnd = 0;
+            int expectedClipNum = 1;
+
+            for (const auto& clip : parseResult.clips) {
+                totals.addClip(clip);
+
+                if (clip.number != expectedClipNum) {
+                    fail(result, "Invalid clip numbering sequence");
+                }
+
+                uint32_t clipStart = UINT32_MAX;
+                uint32_t clipEnd = 0;
+                const auto& frames = clip.timeframes;
+
+                for (size_t i = 0; i < frames.size(); i++) {
+                    const TimeFrame& frame = frames[i];
+                    uint32_t startMs = frame.startTime.toMillis();
+                    uint32_t endMs = frame.endTime.toMillis();
+
+                    totals.addFrame(frame, i + 1 < frames.size() ? &frames[i + 1] : nullptr);
+                    scratch.add(startMs, endMs);
+
+                    globalStart = std::min(globalStart, startMs);
+                    globalEnd = std::max(globalEnd, endMs);
+                    clipStart = std::min(clipStart, startMs);
+                    clipEnd = std::max(clipEnd, endMs);
+
+                    if (frame.type == TimeFrame::Type::TYPING && endMs > startMs) {
+                        result.typingMillis += endMs - startMs;
+                    }
+                    if (endMs <= startMs) {
+                        fail(result, "Invalid timeframe duration in clip " + String(clip.number));
+                    }
+                }
+
+                if (lastClipEnd > 0 && clipStart < lastClipEnd) {
+                    fail(result, "Clip " + String(clip.number) + " overlaps with previous clip");
+                }
+
+                lastClipEnd = clipEnd;
+                expectedClipNum++;
+            }
+
+            result.timingValid = result.timingError.isEmpty();
+            result.metrics = MetricsCalculator::finish(totals);
+
+            if (scratch.count > 0) {
+                result.duration.totalMillis = globalEnd - globalStart;
+                TimeAnalysis::DurationCalculator::analyzeIntervals(scratch, result.duration);
+                TimeAnalysis::DurationCalculator::calculateUtilization(result.duration);
+            }
+
+            return result;
+        }
+
+    private:
+        static void fail(TaskAnalysis& result, const String& message) {
+            if (result.timingError.isEmpty()) result.timingError = message;
+        }
+    };
+}
@@ -0,0 +1,378 @@
+#pragma once
+#include <Arduino.h>
+#include <memory>
+#include <vector>
+#include <SPIFFS.h>
+#include "analysis/text_parser.h"
+#include "analysis/metrics_calculator.h"
+#include "analysis/difficulty_scorer.h"
+#include "aht/calculator.h"
+#include "utils/crc32.h"
+
+namespace Analysis {
+    // Binary task image (/task.bin) produced offline by tools/task_compiler
+    // from text.txt. Little-endian, every table 4-byte aligned so records
+    // are used in place from the loaded buffer without any parsing.
+    namespace TaskImageFormat {
+        constexpr uint32_t MAGIC = 0x49544B42;  // "BKTI"
+        constexpr uint16_t VERSION = 2;
+
+        struct Header {
+            uint32_t magic;
+            uint16_t version;
+            uint16_t headerSize;
+            uint32_t totalSize;
+            uint32_t sourceSize;         // Size of the text.txt it was built from
+            uint32_t sourceCrc;          // And its CRC-32
+            uint32_t clipCount;
+            uint32_t frameCount;
+            uint32_t clipTableOffset;
+            uint32_t frameTableOffset;
+            uint32_t resultsOffset;
+            uint32_t stringTableOffset;
+            uint32_t stringTableSize;
+            uint32_t videoIdOffset;      // Into the string table
+        };
+
+        // Identifies a text.txt: an image is current only when both match
+        struct SourceStamp {
+            uint32_t size;
+            uint32_t crc;
+        };
+
+        // Strings are NUL-terminated in the table, length excludes the NUL
+        struct StringRef {
+            uint32_t offset;
+            uint32_t length;
+        };
+
+        struct ClipRecord {
+            uint32_t number;
+            uint32_t firstFrame;
+            uint32_t frameCount;
+            uint32_t totalDurationMillis;
+            uint32_t wordCount;
+            uint32_t charCount;
+            uint16_t cameraMovements;
+            uint16_t cameraTransitions;
+            uint32_t actionDescriptions;
+            StringRef mainDescription;
+        };
+
+        struct FrameRecord {
+            uint32_t startMillis;
+            uint32_t endMillis;
+            uint8_t type;                // TimeFrame::Type
+            uint8_t reserved[3];
+            StringRef content;
+        };
+
+        struct DurationRecord {
+            uint32_t totalMillis;
+            uint32_t effectiveMillis;
+            uint32_t overlapMillis;
+            uint32_t gapMillis;
+            uint32_t typingMillis;
+            float utilizationPercent;
+        };
+
+        struct AhtRecord {
+            uint32_t isValid;
+            float targetMinutes;
+            float lowerBoundMinutes;
+            float upperBoundMinutes;
+        };
+
+        struct Results {
+            DurationRecord duration;
+            TaskMetrics metrics;
+            DifficultyScores difficulty;
+            AhtRecord aht;
+        };
+
+        // Metrics and scores are stored verbatim; bump VERSION if they change
+        static_assert(sizeof(TaskMetrics) == 60, "TaskMetrics layout changed");
+        static_assert(sizeof(DifficultyScores) == 44, "DifficultyScores layout changed");
+        static_assert(sizeof(FrameRecord) == 20, "FrameRecord must stay packed");
+    }
+
+    // Device-side loader. The whole image is read into one buffer and all
+    // accessors point into it.
+    class TaskImage {
+    public:
+        using Header = TaskImageFormat::Header;
+        using ClipRecord = TaskImageFormat::ClipRecord;
+        using FrameRecord = TaskImageFormat::FrameRecord;
+        using Results = TaskImageFormat::Results;
+
+        using SourceStamp = TaskImageFormat::SourceStamp;
+
+        static constexpr const char* DEFAULT_PATH = "/task.bin";
+
+        // Size and CRC-32 of a source file, read through a small buffer
+        static bool stampSource(const char* path, SourceStamp& stamp) {
+            File file = SPIFFS.open(path, "r");
+            if (!file) return false;
+
+            Utils::Crc32 crc;
+            uint8_t buffer[256];
+            size_t n;
+            stamp.size = 0;
+            while ((n = file.read(buffer, sizeof(buffer))) > 0) {
+                crc.update(buffer, n);
+                stamp.size += n;
+            }
+            file.close();
+            stamp.crc = crc.value();
+            return true;
+        }
+
+        // source: stamp of the current text.txt, nullptr to skip the
+        // staleness check
+        bool load(const char* path = DEFAULT_PATH, const SourceStamp* source = nullptr) {
+            release();
+
+            File file = SPIFFS.open(path, "r");
+            if (!file) return false;
+
+            size_t size = file.size();
+            if (size < sizeof(Header)) {
+                file.close();
+                return false;
+            }
+
+            data.reset(new uint8_t[size]);
+            size_t bytesRead = file.read(data.get(), size);
+            file.close();
+
+            if (bytesRead != size || !validate(size)) {
+                release();
+                return false;
+            }
+            if (source && (header()->sourceSize != source->size || header()->sourceCrc != source->crc)) {
+                release();
+                return false;
+            }
+            return true;
+        }
+
+        void release() {
+            data.reset();
+        }
+
+        bool isLoaded() const { return data != nullptr; }
+
+        // Lookup
+        const Header* header() const {
+            return reinterpret_cast<const Header*>(data.get());
+        }
+
+        int clipCount() const { return isLoaded() ? header()->clipCount : 0; }
+
+        const char* videoId() const { return stringAt(header()->videoIdOffset); }
+
+        const ClipRecord* clip(int clipNumber) const {
+            if (clipNumber < 1 || clipNumber > clipCount()) return nullptr;
+            return clipTable() + (clipNumber - 1);
+        }
+
+        const FrameRecord* frames(const ClipRecord& clip) const {
+            return frameTable() + clip.firstFrame;
+        }
+
+        const char* string(const TaskImageFormat::StringRef& ref) const {
+            return stringAt(ref.offset);
+        }
+
+        const Results& results() const {
+            return *reinterpret_cast<const Results*>(data.get() + header()->resultsOffset);
+        }
+
+        AHT::CalculationResult aht() const {
+            const auto& record = results().aht;
+            return {record.isValid != 0, record.targetMinutes,
+                    record.lowerBoundMinutes, record.upperBoundMinutes};
+        }
+
+        // Materializes one clip in the parser's model
+        bool loadClip(int clipNumber, ClipData& out) const {
+            const ClipRecord* record = clip(clipNumber);
+            if (!record) return false;
+
+            out = ClipData();
+            out.number = record->number;
+            out.totalDurationMillis = record->totalDurationMillis;
+            out.wordCount = record->wordCount;
+            out.charCount = record->charCount;
+            out.cameraMovements = record->cameraMovements;
+            out.cameraTransitions = record->cameraTransitions;
+            out.actionDescriptions = record->actionDescriptions;
+            out.mainDescription = string(record->mainDescription);
+
+            const FrameRecord* frame = frames(*record);
+            out.timeframes.reserve(record->frameCount);
+            for (uint32_t i = 0; i < record->frameCount; i++, frame++) {
+                TimeFrame tf;
+                tf.startTime = TimeFrame::TimeStamp::fromMillis(frame->startMillis);
+                tf.endTime = TimeFrame::TimeStamp::fromMillis(frame->endMillis);
+                tf.type = static_cast<TimeFrame::Type>(frame->type);
+                tf.content = string(frame->content);
+                out.timeframes.push_back(tf);
+            }
+            return true;
+        }
+
+    private:
+        std::unique_ptr<uint8_t[]> data;
+
+        const ClipRecord* clipTable() const {
+            return reinterpret_cast<const ClipRecord*>(data.get() + header()->clipTableOffset);
+        }
+
+        const FrameRecord* frameTable() const {
+            return reinterpret_cast<const FrameRecord*>(data.get() + header()->frameTableOffset);
+        }
+
+        const char* stringAt(uint32_t offset) const {
+            return reinterpret_cast<const char*>(data.get() + header()->stringTableOffset + offset);
+        }
+
+        bool fits(uint32_t offset, uint64_t length, size_t size) const {
+            return offset % 4 == 0 && offset + length <= size;
+        }
+
+        bool validate(size_t size) const {
+            const Header* h = header();
+            if (h->magic != TaskImageFormat::MAGIC) return false;
+            if (h->version != TaskImageFormat::VERSION) return false;
+            if (h->headerSize != sizeof(Header) || h->totalSize != size) return false;
+
+            if (!fits(h->clipTableOffset, (uint64_t)h->clipCount * sizeof(ClipRecord), size) ||
+                !fits(h->frameTableOffset, (uint64_t)h->frameCount * sizeof(FrameRecord), size) ||
+                !fits(h->resultsOffset, sizeof(Results), size) ||
+                !fits(h->stringTableOffset, h->stringTableSize, size)) {
+                return false;
+            }
+
+            // String table must end with a terminator so every entry is bounded
+            const char* strings = stringAt(0);
+            if (h->stringTableSize == 0 || strings[h->stringTableSize - 1] != '\0') return false;
+            if (h->videoIdOffset >= h->stringTableSize) return false;
+
+            const ClipRecord* clips = clipTable();
+            for (uint32_t i = 0; i < h->clipCount; i++) {
+                if ((uint64_t)clips[i].firstFrame + clips[i].frameCount > h->frameCount) return false;
+                if (clips[i].mainDescription.offset >= h->stringTableSize) return false;
+            }
+
+            const FrameRecord* frames = frameTable();
+            for (uint32_t i = 0; i < h->frameCount; i++) {
+                if (frames[i].content.offset >= h->stringTableSize) return false;
+            }
+            return true;
+        }
+    };
+
+    // Host-side builder used by the task compiler
+    class TaskImageWriter {
+    public:
+        struct Inputs {
+            TimeAnalysis::DurationAnalysis duration;
+            TaskMetrics metrics;
+            DifficultyScores difficulty;
+            AHT::CalculationResult aht;
+            TaskImageFormat::SourceStamp source;
+        };
+
+        static std::vector<uint8_t> build(const TextParser::ParseResult& parseResult,
+                                          const Inputs& inputs) {
+            using namespace TaskImageFormat;
+
+            std::vector<ClipRecord> clips;
+            std::vector<FrameRecord> frames;
+            std::vector<uint8_t> strings;
+            uint32_t typingMillis = 0;
+
+            uint32_t videoIdOffset = addString(strings, parseResult.videoId).offset;
+
+            for (const auto& clip : parseResult.clips) {
+                ClipRecord record = {};
+                record.number = clip.number;
+                record.firstFrame = frames.size();
+                record.frameCount = clip.timeframes.size();
+                record.totalDurationMillis = clip.totalDurationMillis;
+                record.wordCount = clip.wordCount;
+                record.charCount = clip.charCount;
+                record.cameraMovements = clip.cameraMovements;
+                record.cameraTransitions = clip.cameraTransitions;
+                record.actionDescriptions = clip.actionDescriptions;
+                record.mainDescription = addString(strings, clip.mainDescription);
+                clips.push_back(record);
+
+                for (const auto& frame : clip.timeframes) {
+                    FrameRecord fr = {};
+                    fr.startMillis = frame.startTime.toMillis();
+                    fr.endMillis = frame.endTime.toMillis();
+                    fr.type = static_cast<uint8_t>(frame.type);
+                    fr.content = addString(strings, frame.content);
+                    frames.push_back(fr);
+
+                    if (frame.type == TimeFrame::Type::TYPING) {
+                        typingMillis += frame.getDurationMillis();
+                    }
+                }
+            }
+
+            Results results = {};
+            results.duration.totalMillis = inputs.duration.totalMillis;
+            results.duration.effectiveMillis = inputs.duration.effectiveMillis;
+            results.duration.overlapMillis = inputs.duration.overlapMillis;
+            results.duration.gapMillis = inputs.duration.gapMillis;
+            results.duration.typingMillis = typingMillis;
+            results.duration.utilizationPercent = inputs.duration.utilizationPercent;
+            results.metrics = inputs.metrics;
+            results.difficulty = inputs.difficulty;
+            results.aht = {inputs.aht.isValid ? 1u : 0u, inputs.aht.targetMinutes,
+                           inputs.aht.lowerBoundMinutes, inputs.aht.upperBoundMinutes};
+
+            Header header = {};
+            header.magic = MAGIC;
+            header.version = VERSION;
+            header.headerSize = sizeof(Header);
+            header.sourceSize = inputs.source.size;
+            header.sourceCrc = inputs.source.crc;
+            header.clipCount = clips.size();
+            header.frameCount = frames.size();
+            header.videoIdOffset = videoIdOffset;
+
+            std::vector<uint8_t> image;
+            append(image, &header, sizeof(header));
+            header.clipTableOffset = append(image, clips.data(), clips.size() * sizeof(ClipRecord));
+            header.frameTableOffset = append(image, frames.data(), frames.size() * sizeof(FrameRecord));
+            header.resultsOffset = append(image, &results, sizeof(results));
+            header.stringTableOffset = append(image, strings.data(), strings.size());
+            header.stringTableSize = strings.size();
+            header.totalSize = image.size();
+
+            memcpy(image.data(), &header, sizeof(header));
+            return image;
+        }
+
+    private:
+        static TaskImageFormat::StringRef addString(std::vector<uint8_t>& table, const String& str) {
+            TaskImageFormat::StringRef ref = {(uint32_t)table.size(), str.length()};
+            table.insert(table.end(), str.c_str(), str.c_str() + str.length());
+            table.push_back('\0');
+            return ref;
+        }
+
+        // Appends at the next 4-byte boundary and returns the offset used
+        static uint32_t append(std::vector<uint8_t>& image, const void* src, size_t size) {
+            while (image.size() % 4 != 0) image.push_back(0);
+            uint32_t offset = image.size();
+            const uint8_t* bytes = static_cast<const uint8_t*>(src);
+            image.insert(image.end(), bytes, bytes + size);
+            return offset;
+        }
+    };
+}
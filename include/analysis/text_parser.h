@@ -3,6 +3,7 @@
 #include <vector>
 #include <SPIFFS.h>
 #include "constants.h"
+#include "analysis/text_tokenizer.h"
 
 namespace Analysis {
     struct TimeFrame {
@@ -16,6 +17,10 @@ namespace Analysis {
             }
             
             static TimeStamp fromString(const String& str);
+
+            static TimeStamp fromMillis(uint32_t millis) {
+                return {millis / 60000, (millis / 1000) % 60, millis % 1000};
+            }
         };
 
         enum class Type {
@@ -29,6 +34,12 @@ namespace Analysis {
         TimeStamp endTime;
         Type type;
         String content;
+
+        uint32_t getDurationMillis() const {
+            uint32_t startMs = startTime.toMillis();
+            uint32_t endMs = endTime.toMillis();
+            return endMs > startMs ? endMs - startMs : 0;
+        }
     };
 
     struct ClipData {
@@ -45,6 +56,8 @@ namespace Analysis {
 
     class TextParser {
     public:
+        static constexpr const char* DEFAULT_PATH = "/text.txt";
+
         struct ParseResult {
             String videoId;
             std::vector<ClipData> clips;
@@ -55,122 +68,123 @@ namespace Analysis {
         static ParseResult parseFile() {
             ParseResult result;
             result.isValid = false;
-            
-            File file = SPIFFS.open("/text.txt", "r");
-            if (!file) {
-                result.errorMessage = "Failed to open text.txt";
+
+            ModelBuilder builder(result);
+            String error;
+            if (!visitFile(builder, error)) {
+                result.errorMessage = error;
                 return result;
             }
 
-            // Read video ID from first line
-            String line = file.readStringUntil('\n');
-            if (line.startsWith("Video ")) {
-                String idStr = line.substring(6);
-                idStr.trim();
-                result.videoId = idStr;
-            } else {
-                result.errorMessage = "Invalid file format: Missing Video ID";
-                file.close();
-                return result;
+            result.isValid = true;
+            return result;
+        }
+
+        // SAX-style entry point: streams /text.txt through the visitor
+        // without materializing a ParseResult
+        template<typename Visitor>
+        static bool visitFile(Visitor& visitor, String& errorMessage) {
+            File file = SPIFFS.open(DEFAULT_PATH, "r");
+            if (!file) {
+                errorMessage = "Failed to open text.txt";
+                return false;
             }
 
-            ClipData currentClip;
-            bool inClip = false;
-            String contentBuffer;
+            TextTokenizer<> tokenizer;
+            bool ok = tokenizer.tokenize(file, visitor);
+            file.close();
 
-            // Process file line by line
-            while (file.available()) {
-                line = file.readStringUntil('\n');
-                String trimmedLine = line;
-                trimmedLine.trim();
+            if (!ok) errorMessage = tokenizer.errorMessage();
+            return ok;
+        }
 
-                if (trimmedLine.startsWith("Clip #")) {
-                    if (inClip) {
-                        finalizeClip(currentClip);
-                        result.clips.push_back(currentClip);
-                    }
-                    currentClip = ClipData();
-                    inClip = true;
-                    parseClipHeader(trimmedLine, currentClip);
-                }
-                else if (inClip) {
-                    if (trimmedLine.indexOf('<') >= 0) {
-                        if (!contentBuffer.isEmpty()) {
-                            currentClip.mainDescription = contentBuffer;
-                            contentBuffer = "";
-                        }
-                        parseTimeFrame(trimmedLine, currentClip);
-                    }
-                    else if (!trimmedLine.isEmpty()) {
-                        contentBuffer += trimmedLine + "\n";
-                    }
-                }
+    private:
+        // Builds the clip model from tokenizer callbacks. Description lines
+        // before the first timeframe form the clip's main description; lines
+        // after a timeframe are that timeframe's content.
+        struct ModelBuilder : TextVisitor {
+            ParseResult& result;
+            String* target = nullptr;
+            bool pendingNewline = false;
+
+            explicit ModelBuilder(ParseResult& out) : result(out) {}
+
+            void onVideoId(TextSpan id) {
+                result.videoId = toString(id);
             }
 
-            // Handle last clip
-            if (inClip) {
-                finalizeClip(currentClip);
-                result.clips.push_back(currentClip);
+            void onClipHeader(int number, uint32_t startMs, uint32_t endMs,
+                              uint32_t lineOffset, uint32_t bodyOffset) {
+                finishClip();
+
+                result.clips.push_back(ClipData());
+                ClipData& clip = result.clips.back();
+                clip.number = number;
+
+                TimeFrame boundary;
+                boundary.type = TimeFrame::Type::CLIP_BOUNDARY;
+                boundary.startTime = TimeFrame::TimeStamp::fromMillis(startMs);
+                boundary.endTime = TimeFrame::TimeStamp::fromMillis(endMs);
+                clip.timeframes.push_back(boundary);
+
+                startText(clip.mainDescription);
             }
 
-            file.close();
-            result.isValid = true;
-            return result;
-        }
+            void onTimeframe(Marker marker, uint32_t startMs, uint32_t endMs,
+                             TextSpan inlineContent, uint32_t lineOffset) {
+                if (result.clips.empty()) return;
+                ClipData& clip = result.clips.back();
+
+                TimeFrame frame;
+                switch (marker) {
+                    case Marker::CAMERA_MOVEMENT:
+                        frame.type = TimeFrame::Type::CAMERA_MOVEMENT;
+                        clip.cameraMovements++;
+                        break;
+                    case Marker::CAMERA_TRANSITION:
+                        frame.type = TimeFrame::Type::CAMERA_TRANSITION;
+                        clip.cameraTransitions++;
+                        break;
+                    default:
+                        frame.type = TimeFrame::Type::TYPING;
+                        clip.actionDescriptions++;
+                        break;
+                }
+                frame.startTime = TimeFrame::TimeStamp::fromMillis(startMs);
+                frame.endTime = TimeFrame::TimeStamp::fromMillis(endMs);
+                clip.timeframes.push_back(frame);
 
-    private:
-        static void parseClipHeader(const String& line, ClipData& clip) {
-            int numStart = line.indexOf('#') + 1;
-            int numEnd = line.indexOf('<');
-            clip.number = line.substring(numStart, numEnd).toInt();
-            
-            // Parse boundary timeframe
-            TimeFrame boundary;
-            boundary.type = TimeFrame::Type::CLIP_BOUNDARY;
-            parseTimeStamps(line, boundary);
-            clip.timeframes.push_back(boundary);
-        }
+                startText(clip.timeframes.back().content);
+                if (!inlineContent.isEmpty()) onDescription(inlineContent, true);
+            }
 
-        static void parseTimeFrame(const String& line, ClipData& clip) {
-            TimeFrame frame;
-            
-            // Determine frame type
-            if (line.indexOf("[CM]") >= 0) {
-                frame.type = TimeFrame::Type::CAMERA_MOVEMENT;
-                clip.cameraMovements++;
-            } else if (line.indexOf("[CT]") >= 0) {
-                frame.type = TimeFrame::Type::CAMERA_TRANSITION;
-                clip.cameraTransitions++;
-            } else {
-                frame.type = TimeFrame::Type::TYPING;
-                clip.actionDescriptions++;
+            void onDescription(TextSpan text, bool lineEnd) {
+                if (!target) return;
+                if (pendingNewline) *target += '\n';
+                target->concat(text.data, text.length);
+                pendingNewline = lineEnd;
             }
 
-            parseTimeStamps(line, frame);
-            
-            // Extract content after timeframe
-            int contentStart = line.indexOf('>') + 1;
-            if (contentStart < line.length()) {
-                String contentStr = line.substring(contentStart);
-                contentStr.trim();
-                frame.content = contentStr;
+            void onEnd(uint32_t totalBytes) {
+                finishClip();
             }
-            
-            clip.timeframes.push_back(frame);
-        }
 
-        static void parseTimeStamps(const String& line, TimeFrame& frame) {
-            int firstStart = line.indexOf('<') + 1;
-            int firstEnd = line.indexOf('>');
-            int secondStart = line.indexOf('<', firstEnd) + 1;
-            int secondEnd = line.indexOf('>', secondStart);
+            void startText(String& text) {
+                target = &text;
+                pendingNewline = false;
+            }
 
-            String startTimeStr = line.substring(firstStart, firstEnd);
-            String endTimeStr = line.substring(secondStart, secondEnd);
+            void finishClip() {
+                if (!result.clips.empty()) finalizeClip(result.clips.back());
+                target = nullptr;
+            }
 
-            frame.startTime = TimeFrame::TimeStamp::fromString(startTimeStr);
-            frame.endTime = TimeFrame::TimeStamp::fromString(endTimeStr);
-        }
+            static String toString(TextSpan span) {
+                String str;
+                str.concat(span.data, span.length);
+                return str;
+            }
+        };
 
         static void finalizeClip(ClipData& clip) {
             // Calculate total duration
@@ -181,12 +195,19 @@ namespace Analysis {
                                          firstFrame.startTime.toMillis();
             }
 
-            // Count words and characters in main description
+            // Count words and characters across everything that gets typed
             clip.wordCount = 0;
             clip.charCount = 0;
+            countText(clip.mainDescription, clip);
+            for (const auto& frame : clip.timeframes) {
+                countText(frame.content, clip);
+            }
+        }
+
+        static void countText(const String& text, ClipData& clip) {
             bool inWord = false;
 
-            for (char c : clip.mainDescription) {
+            for (char c : text) {
                 if (isAlphaNumeric(c)) {
                     if (!inWord) {
                         clip.wordCount++;
@@ -199,4 +220,8 @@ namespace Analysis {
             }
         }
     };
+
+    inline TimeFrame::TimeStamp TimeFrame::TimeStamp::fromString(const String& str) {
+        return fromMillis(TextTokenizer<>::parseMillis(str.c_str(), str.length()));
+    }
 }
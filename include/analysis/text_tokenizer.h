@@ -0,0 +1,315 @@
+#pragma once
+#include <Arduino.h>
+
+namespace Analysis {
+    // Non-owning view into the tokenizer's read buffer. Only valid for the
+    // duration of the visitor callback that received it.
+    struct TextSpan {
+        const char* data = nullptr;
+        size_t length = 0;
+
+        bool isEmpty() const { return length == 0; }
+
+        bool startsWith(const char* prefix) const {
+            size_t n = strlen(prefix);
+            return n <= length && memcmp(data, prefix, n) == 0;
+        }
+
+        int indexOf(char c, size_t from = 0) const {
+            for (size_t i = from; i < length; i++) {
+                if (data[i] == c) return i;
+            }
+            return -1;
+        }
+
+        int indexOf(const char* needle, size_t from = 0) const {
+            size_t n = strlen(needle);
+            for (size_t i = from; i + n <= length; i++) {
+                if (memcmp(data + i, needle, n) == 0) return i;
+            }
+            return -1;
+        }
+
+        TextSpan sub(size_t start, size_t end) const {
+            if (end > length) end = length;
+            if (start > end) start = end;
+            return {data + start, end - start};
+        }
+
+        TextSpan trimmed() const {
+            size_t start = 0;
+            size_t end = length;
+            while (start < end && isspace((unsigned char)data[start])) start++;
+            while (end > start && isspace((unsigned char)data[end - 1])) end--;
+            return sub(start, end);
+        }
+
+        long toInt() const {
+            long value = 0;
+            for (size_t i = 0; i < length; i++) {
+                if (isdigit((unsigned char)data[i])) value = value * 10 + (data[i] - '0');
+                else if (value > 0) break;
+            }
+            return value;
+        }
+    };
+
+    // Base visitor with empty handlers; derive and hide the ones you need.
+    // Dispatch is static (the tokenizer is templated on the visitor type).
+    struct TextVisitor {
+        enum class Marker { NONE, CAMERA_MOVEMENT, CAMERA_TRANSITION };
+
+        void onVideoId(TextSpan id) {}
+        void onClipHeader(int number, uint32_t startMs, uint32_t endMs,
+                          uint32_t lineOffset, uint32_t bodyOffset) {}
+        void onTimeframe(Marker marker, uint32_t startMs, uint32_t endMs,
+                         TextSpan inlineContent, uint32_t lineOffset) {}
+        // Description text inside a clip. Lines longer than the read buffer
+        // arrive as several spans; lineEnd is set on the last one.
+        void onDescription(TextSpan text, bool lineEnd) {}
+        void onEnd(uint32_t totalBytes) {}
+    };
+
+    // Streaming tokenizer for the text.txt format. Reads through a fixed
+    // buffer and never allocates, so peak memory is BufferSize regardless
+    // of file length. Source needs size_t read(uint8_t*, size_t).
+    template<size_t BufferSize = 256>
+    class TextTokenizer {
+    public:
+        template<typename Source, typename Visitor>
+        bool tokenize(Source& source, Visitor& visitor) {
+            reset();
+
+            while (true) {
+                size_t lineEnd = findNewline();
+                bool lastLine = false;
+
+                if (lineEnd == NOT_FOUND) {
+                    if (fill(source)) continue;
+
+                    if (head == tail) break;
+                    if (!eof) {
+                        // Buffer full without a newline: hand out a chunk
+                        emitChunk(visitor, tail, false);
+                        if (error) return false;
+                        continue;
+                    }
+                    lineEnd = tail;
+                    lastLine = true;
+                }
+
+                emitChunk(visitor, lineEnd, true);
+                if (!lastLine) consume(1);  // the '\n'
+                if (error) return false;
+            }
+
+            if (!sawVideoId) {
+                error = "Invalid file format: Missing Video ID";
+                return false;
+            }
+
+            visitor.onEnd(consumedBytes);
+            return true;
+        }
+
+        const char* errorMessage() const { return error ? error : ""; }
+
+        // Parses "MM:SS.mmm" or "HH:MM:SS.mmm"; stray spaces are ignored
+        static uint32_t parseMillis(const char* text, size_t length) {
+            uint32_t fields[3] = {0, 0, 0};
+            int fieldCount = 1;
+            uint32_t fraction = 0;
+            int fractionDigits = 0;
+            bool inFraction = false;
+
+            for (size_t i = 0; i < length; i++) {
+                char c = text[i];
+                if (c == ':' && !inFraction && fieldCount < 3) {
+                    fieldCount++;
+                } else if (c == '.') {
+                    inFraction = true;
+                } else if (isdigit((unsigned char)c)) {
+                    if (inFraction) {
+                        if (fractionDigits < 3) {
+                            fraction = fraction * 10 + (c - '0');
+                            fractionDigits++;
+                        }
+                    } else {
+                        fields[fieldCount - 1] = fields[fieldCount - 1] * 10 + (c - '0');
+                    }
+                }
+            }
+
+            while (fractionDigits < 3) {
+                fraction *= 10;
+                fractionDigits++;
+            }
+
+            uint32_t seconds = 0;
+            for (int i = 0; i < fieldCount; i++) {
+                seconds = seconds * 60 + fields[i];
+            }
+            return seconds * 1000 + fraction;
+        }
+
+        // Reads the first two "<...>" stamps of a header or timeframe line
+        static bool parseStampPair(TextSpan line, uint32_t& startMs, uint32_t& endMs,
+                                   int* afterSecond = nullptr) {
+            int firstStart = line.indexOf('<');
+            int firstEnd = line.indexOf('>', firstStart + 1);
+            if (firstStart < 0 || firstEnd < 0) return false;
+
+            int secondStart = line.indexOf('<', firstEnd + 1);
+            int secondEnd = line.indexOf('>', secondStart + 1);
+            if (secondStart < 0 || secondEnd < 0) return false;
+
+            startMs = parseMillis(line.data + firstStart + 1, firstEnd - firstStart - 1);
+            endMs = parseMillis(line.data + secondStart + 1, secondEnd - secondStart - 1);
+            if (afterSecond) *afterSecond = secondEnd + 1;
+            return true;
+        }
+
+    private:
+        static constexpr size_t NOT_FOUND = (size_t)-1;
+
+        char buffer[BufferSize];
+        size_t head = 0;            // Start of unconsumed data
+        size_t tail = 0;            // End of valid data
+        size_t scanned = 0;         // Bytes past head already searched for '\n'
+        uint32_t consumedBytes = 0; // Absolute offset of buffer[head]
+        uint32_t lineStartOffset = 0;
+        bool eof = false;
+        bool sawVideoId = false;
+        bool inClip = false;
+        bool continuingLine = false;
+        bool continuingDescription = false;
+        const char* error = nullptr;
+
+        void reset() {
+            head = tail = scanned = 0;
+            consumedBytes = lineStartOffset = 0;
+            eof = sawVideoId = inClip = false;
+            continuingLine = continuingDescription = false;
+            error = nullptr;
+        }
+
+        size_t findNewline() {
+            for (size_t i = head + scanned; i < tail; i++) {
+                if (buffer[i] == '\n') return i;
+            }
+            scanned = tail - head;
+            return NOT_FOUND;
+        }
+
+        // Compacts the buffer and reads more; false when nothing was added
+        template<typename Source>
+        bool fill(Source& source) {
+            if (eof) return false;
+
+            if (head > 0) {
+                memmove(buffer, buffer + head, tail - head);
+                tail -= head;
+                head = 0;
+            }
+            if (tail == BufferSize) return false;
+
+            size_t n = source.read(reinterpret_cast<uint8_t*>(buffer + tail), BufferSize - tail);
+            if (n == 0) {
+                eof = true;
+                return false;
+            }
+            tail += n;
+            return true;
+        }
+
+        void consume(size_t count) {
+            head += count;
+            consumedBytes += count;
+            scanned = 0;
+        }
+
+        template<typename Visitor>
+        void emitChunk(Visitor& visitor, size_t end, bool lineEnd) {
+            TextSpan chunk = {buffer + head, end - head};
+            if (!continuingLine) lineStartOffset = consumedBytes;
+
+            if (continuingLine) {
+                // Tail of an overlong line: leading whitespace is significant
+                if (continuingDescription) {
+                    TextSpan text = lineEnd ? rightTrimmed(chunk) : chunk;
+                    visitor.onDescription(text, lineEnd);
+                }
+            } else {
+                classifyLine(visitor, chunk, lineEnd);
+            }
+
+            consume(end - head);
+            continuingLine = !lineEnd;
+            if (lineEnd) continuingDescription = false;
+        }
+
+        template<typename Visitor>
+        void classifyLine(Visitor& visitor, TextSpan raw, bool lineEnd) {
+            TextSpan line = lineEnd ? raw.trimmed() : leftTrimmed(raw);
+            if (line.isEmpty()) return;
+
+            if (!sawVideoId) {
+                if (!line.startsWith("Video ")) {
+                    error = "Invalid file format: Missing Video ID";
+                    return;
+                }
+                sawVideoId = true;
+                visitor.onVideoId(line.sub(6, line.length).trimmed());
+                return;
+            }
+
+            uint32_t startMs = 0;
+            uint32_t endMs = 0;
+
+            if (line.startsWith("Clip #")) {
+                inClip = true;
+                int numEnd = line.indexOf('<');
+                int number = line.sub(6, numEnd < 0 ? line.length : numEnd).toInt();
+                parseStampPair(line, startMs, endMs);
+                uint32_t bodyOffset = lineStartOffset + (raw.length + (lineEnd ? 1 : 0));
+                visitor.onClipHeader(number, startMs, endMs, lineStartOffset, bodyOffset);
+                return;
+            }
+
+            if (!inClip) return;
+
+            int contentStart = 0;
+            if (line.indexOf('<') >= 0 && parseStampPair(line, startMs, endMs, &contentStart)) {
+                TextVisitor::Marker marker = TextVisitor::Marker::NONE;
+                if (line.indexOf("[CM]") >= 0) {
+                    marker = TextVisitor::Marker::CAMERA_MOVEMENT;
+                } else if (line.indexOf("[CT]") >= 0) {
+                    marker = TextVisitor::Marker::CAMERA_TRANSITION;
+                }
+
+                TextSpan content = line.sub(contentStart, line.length).trimmed();
+                if (content.startsWith("[CM]") || content.startsWith("[CT]")) {
+                    content = content.sub(4, content.length).trimmed();
+                }
+                visitor.onTimeframe(marker, startMs, endMs, content, lineStartOffset);
+                continuingDescription = !lineEnd;
+                return;
+            }
+
+            visitor.onDescription(line, lineEnd);
+            continuingDescription = !lineEnd;
+        }
+
+        static TextSpan leftTrimmed(TextSpan span) {
+            size_t start = 0;
+            while (start < span.length && isspace((unsigned char)span.data[start])) start++;
+            return span.sub(start, span.length);
+        }
+
+        static TextSpan rightTrimmed(TextSpan span) {
+            size_t end = span.length;
+            while (end > 0 && isspace((unsigned char)span.data[end - 1])) end--;
+            return span.sub(0, end);
+        }
+    };
+}
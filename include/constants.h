@@ -16,12 +16,35 @@ namespace AHT {
     };
 }
 
+// Compile-time log level (include/utils/log.h). Calls above it compile
+// to nothing, format strings included. Override in build_flags, e.g.
+// -DLOG_LEVEL=LOG_LEVEL_INFO
+#define LOG_LEVEL_NONE 0
+#define LOG_LEVEL_ERROR 1
+#define LOG_LEVEL_WARN 2
+#define LOG_LEVEL_INFO 3
+#define LOG_LEVEL_DEBUG 4
+#ifndef LOG_LEVEL
+#define LOG_LEVEL LOG_LEVEL_DEBUG
+#endif
+
 namespace Constants {
     namespace Debug {
-        const bool ENABLE_SERIAL_DEBUG = true;
-        const bool ENABLE_DETAILED_TIMING = true;
-        const bool ENABLE_SPEED_DEBUG = true;
-        const int DEBUG_UPDATE_INTERVAL = 1000;
+        constexpr bool ENABLE_SERIAL_DEBUG = LOG_LEVEL >= LOG_LEVEL_DEBUG;
+        constexpr bool ENABLE_DETAILED_TIMING = true;
+        constexpr bool ENABLE_SPEED_DEBUG = true;
+        constexpr int DEBUG_UPDATE_INTERVAL = 1000;
+    }
+
+    // Deferred log records, formatted by a low-priority task
+    namespace Log {
+        constexpr size_t QUEUE = 64;                // Records, power of two
+        constexpr size_t MAX_ARGS = 6;
+        constexpr size_t PAYLOAD = 48;              // Argument bytes per record, strings copied in
+        constexpr uint32_t TASK_STACK = 3072;
+        constexpr UBaseType_t TASK_PRIORITY = 0;    // Only when nothing else wants core 0
+        constexpr BaseType_t TASK_CORE = 0;
+        constexpr uint32_t POLL = 20;               // Writer sleep once the queue is empty
     }
 
     namespace Hardware {
@@ -36,9 +59,19 @@ namespace Constants {
         const int PROGRESS_UPDATE_INTERVAL = 250;
         const int ERROR_BLINK_SPEED = 200;
         const int SUCCESS_BLINK_SPEED = 300;
+        const int SPEED_PULSE = 250;            // Half a breath of the speed indicator
+        const int LED_FADE = 120;               // Into a steady pattern or level
+
+        // LED PWM; channels 2/3 share a timer, clear of the buzzer's
+        const int RED_LED_CHANNEL = 2;
+        const int BLUE_LED_CHANNEL = 3;
+        const int LED_PWM_FREQ = 5000;
+        constexpr int LED_PWM_BITS = 12;
+        constexpr bool LED_ACTIVE_LOW = true;
         
         // Sound constants
         const bool BUZZER_ENABLED = true;
+        const int BUZZER_CHANNEL = 0;   // LEDC channel; channel 1 shares its timer, keep it free
         const int SECTION_COMPLETE_BEEP = 200;
         const int ERROR_BEEP = 100;
         const int SUCCESS_BEEP = 50;
@@ -46,9 +79,34 @@ namespace Constants {
         const int PROGRESS_BEEP = 25;
         
         // Button constants
-        const int DEBOUNCE_DELAY = 200;
+        const int DEBOUNCE_DELAY = 20;          // Edges this soon after an accepted one are bounce
         const int LONG_PRESS_DURATION = 1000;
-        const int DOUBLE_PRESS_WINDOW = 300;
+        const int DOUBLE_PRESS_WINDOW = 300;    // From a release to the next press
+        constexpr size_t BUTTON_EDGE_QUEUE = 16;   // Interrupt -> UI task, power of two
+    }
+
+    namespace Scheduler {
+        constexpr size_t MAX_TASKS = 8;
+        constexpr uint32_t COMMAND_POLL = 10;       // Engine check for UI commands
+        constexpr uint32_t STATUS_REPORT = 1000;    // State heartbeat and serial state line period
+        constexpr uint32_t LOOP_IDLE = 50;          // Longest main loop sleep
+    }
+
+    // Typing engine (loop task, core 1) <-> UI task (button, LEDs, buzzer)
+    namespace Ui {
+        constexpr size_t COMMAND_QUEUE = 16;        // Power of two, one slot unused
+        constexpr size_t STATUS_QUEUE = 16;
+        constexpr uint32_t TASK_STACK = 4096;
+        constexpr UBaseType_t TASK_PRIORITY = 1;    // Below the HID output task on the same core
+        constexpr BaseType_t TASK_CORE = 0;
+        constexpr uint32_t POLL = 10;               // Button sampling and LED update period
+        constexpr uint32_t PROGRESS_INTERVAL = 250; // Min time between progress messages
+    }
+
+    // Hot-path event trace (include/utils/trace.h)
+    namespace Trace {
+        constexpr bool ENABLED = true;
+        constexpr size_t CAPACITY = 1024;           // Records of 16 bytes, power of two
     }
 
     namespace Navigation {
@@ -57,6 +115,18 @@ namespace Constants {
         const int CLIP_DELAY = 1000;
         const int MIN_TAB_DELAY = 140;
         const int MAX_TAB_DELAY = 400;
+        const bool BURST_NAVIGATION = true;   // Tabs back to back at report spacing instead of human delays
+    }
+
+    namespace Hid {
+        constexpr size_t OUTPUT_QUEUE_SIZE = 64;       // Power of two, one slot unused
+        constexpr uint32_t OUTPUT_TASK_STACK = 4096;
+        constexpr UBaseType_t OUTPUT_TASK_PRIORITY = 2;
+        constexpr BaseType_t OUTPUT_TASK_CORE = 0;     // Loop task runs on core 1
+        constexpr uint32_t OUTPUT_IDLE_POLL = 10;      // Max sleep when the queue is empty
+        constexpr uint32_t MIN_REPORT_SPACING_US = 7500;  // One BLE connection event (7.5 ms minimum interval)
+        constexpr uint32_t NAVIGATION_TIMEOUT = 5000;     // Give up waiting on a navigation burst
+        constexpr size_t LOOPBACK_CAPACITY = 4096;        // Reports kept by the host loopback transport
     }
 
     namespace Typing {
@@ -68,6 +138,8 @@ namespace Constants {
         const float MIN_SPEED_MULTIPLIER = 0.5f;
         const float MAX_SPEED_MULTIPLIER = 2.0f;
         const float SPEED_ADJUSTMENT_STEP = 0.1f;
+        constexpr size_t STATS_WINDOW = 64;          // Keystrokes in the rolling statistics window
+        constexpr float STATS_EWMA_ALPHA = 0.1f;     // Weight of the newest interval in the smoothed rate
     }
 
     namespace HumanBehavior {
@@ -101,5 +173,6 @@ namespace Constants {
     namespace Timing {
         constexpr float MIN_SPEED_MULTIPLIER = 0.5f;
         constexpr float MAX_SPEED_MULTIPLIER = 1.5f;
+        constexpr size_t MAX_SWEEP_INTERVALS = 256;  // Static sweep scratch, larger tasks fall back to heap
     }
 }
@@ -4,6 +4,14 @@
 #include "timing/progress_tracker.h"
 #include "aht/calculator.h"
 #include "keyboard.h"
+#include "ui/button_classifier.h"
+#include "ui/buzzer_sequencer.h"
+#include "ui/led_animator.h"
+#include "utils/log.h"
+#include "utils/spsc_queue.h"
+#ifdef ARDUINO
+#include <esp_timer.h>
+#endif
 
 class Hardware {
 public:
@@ -28,13 +36,7 @@ public:
         PROGRESS_MILESTONE
     };
 
-    enum class ButtonEvent {
-        NONE,
-        SINGLE_PRESS,
-        DOUBLE_PRESS,
-        LONG_PRESS,
-        TRIPLE_PRESS
-    };
+    using ButtonEvent = Ui::ButtonEvent;
 
     struct LedStatus {
         bool redOn;
@@ -50,13 +52,16 @@ public:
     ButtonEvent handleButton();
     bool isButtonPressed();
     
-    // LED control
+    // LED control; patterns are keyframe tables the LEDC fades and a
+    // timer play out, no update() needed
     void setLedPattern(Pattern pattern);
+    static const Ui::LedPattern& ledPattern(Pattern pattern);
     void setLedBrightness(float red, float blue);
     LedStatus getLedStatus() const;
     
-    // Sound control
+    // Sound control; returns at once, the pattern plays from a timer
     void playSound(SoundType type);
+    static const Ui::SoundPattern& soundPattern(SoundType type);
     void enableSound(bool enable);
     
     // Progress indication
@@ -66,6 +71,9 @@ public:
     void showSuccess(const String& message);
     void showAHTStatus(const AHT::CalculationResult& aht);
 
+    // Presses of a sequence not yet classified (see ButtonClassifier)
+    uint8_t pendingPresses() const { return buttonClassifier.pendingPresses(); }
+
     // Status getters
     bool isPaused() const { return paused; }
     bool isSectionComplete() const { return sectionComplete; }
@@ -93,33 +101,47 @@ private:
 
     // LED state
     Pattern currentPattern = Pattern::ALL_OFF;
-    bool ledState = false;
+    bool ledOverride = false;       // setLedBrightness() since the last pattern
     float progressBrightness = 0.0f;
     float speedIndicatorValue = 0.0f;
+    const Ui::LedPattern* speedShown = nullptr;
 
     // Timing
-    unsigned long lastLedToggle = 0;
-    unsigned long lastProgressUpdate = 0;
-    unsigned long lastDebounceTime = 0;
+    unsigned long lastDebugPrint = 0;
+
+    // Button: edges from the GPIO interrupt, classified on the UI task
+    Utils::SpscQueue<Ui::ButtonEdge, Constants::Hardware::BUTTON_EDGE_QUEUE> buttonEdges;
+    Ui::ButtonClassifier buttonClassifier;
+    static void onButtonEdge(void* param);
 
-    // Button state
-    int lastButtonState = HIGH;
-    unsigned long lastButtonPressTime = 0;
-    int buttonPressCount = 0;
-    bool longPressActive = false;
+    // Buzzer: tone patterns on LEDC, stepped by an esp_timer (on the
+    // host by update())
+    using Buzzer = Ui::BuzzerSequencer<Ui::LedcBuzzer>;
+    Ui::LedcBuzzer buzzerPwm{Constants::Hardware::BUZZER_PIN, Constants::Hardware::BUZZER_CHANNEL};
+    Buzzer buzzer{buzzerPwm};
+#ifdef ARDUINO
+    esp_timer_handle_t buzzerTimer = nullptr;
+    static void onBuzzerTimer(void* param);
+#endif
+    void startBuzzer();
+
+    // LEDs: keyframes faded by LEDC, stepped by an esp_timer (on the
+    // host by update()); levels shadowed in the animator
+    using Leds = Ui::LedAnimator<Ui::LedcLeds>;
+    Ui::LedcLeds ledPwm{Constants::Hardware::RED_LED, Constants::Hardware::RED_LED_CHANNEL,
+                        Constants::Hardware::BLUE_LED, Constants::Hardware::BLUE_LED_CHANNEL};
+    Leds leds{ledPwm};
+#ifdef ARDUINO
+    esp_timer_handle_t ledTimer = nullptr;
+    static void onLedTimer(void* param);
+#endif
+    void startLeds();
 
     // Private helpers
-    void handleProgressPattern();
-    void handleSpeedPattern();
-    void handleErrorPattern();
-    void handleSuccessPattern();
+    void showLevels(float red, float blue, uint16_t fadeMillis);
+    void showProgress();
+    void showSpeed();
     ButtonEvent detectButtonEvent();
-    void resetButtonState();
-
-    // LED control helpers
-    void setPhysicalLed(uint8_t pin, bool state);
-    void setPhysicalLedBrightness(uint8_t pin, float brightness);
-    void pulseLed(uint8_t pin, int duration, int pulseCount);
 
     // Debug helpers
     void printDebugInfo();
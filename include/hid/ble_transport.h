@@ -0,0 +1,23 @@
+#pragma once
+#include <BleKeyboard.h>
+
+namespace Hid {
+    // Transport for the real device: reports go out through BleKeyboard.
+    // Keyboard only calls begin(), isConnected() and sendReport(), so any
+    // class with those three and a Report type can stand in for this one.
+    class BleTransport {
+    public:
+        using Report = KeyReport;
+
+        BleTransport(const char* name = "PRO X TSL", const char* manufacturer = "Logitech",
+                     uint8_t batteryLevel = 100)
+            : device(name, manufacturer, batteryLevel) {}
+
+        void begin() { device.begin(); }
+        bool isConnected() { return device.isConnected(); }
+        void sendReport(Report* report) { device.sendReport(report); }
+
+    private:
+        BleKeyboard device;
+    };
+}
@@ -0,0 +1,19 @@
+#pragma once
+#include <Arduino.h>
+
+namespace Hid {
+    // 8-byte boot keyboard report, laid out like BleKeyboard's KeyReport.
+    // Transports that do not talk to the BLE library use this one.
+    struct BootReport {
+        uint8_t modifiers;
+        uint8_t reserved;
+        uint8_t keys[6];
+    };
+    static_assert(sizeof(BootReport) == 8, "Boot keyboard report is 8 bytes");
+
+    // A report as it left the keyboard, for loopback capture and dumps
+    struct ReportRecord {
+        uint32_t timestampMicros;
+        BootReport report;
+    };
+}
@@ -0,0 +1,117 @@
+#pragma once
+#include <Arduino.h>
+#include <FS.h>
+#include <atomic>
+#include "hid/boot_report.h"
+
+namespace Hid {
+    // Dump file layout: "HIDR", u16 version, u16 record size, then one
+    // record per report: u32 timestamp (micros, little-endian) followed by
+    // the 8 report bytes.
+    namespace ReportDump {
+        constexpr char MAGIC[4] = {'H', 'I', 'D', 'R'};
+        constexpr uint16_t VERSION = 1;
+        constexpr uint16_t RECORD_SIZE = 4 + sizeof(BootReport);
+        constexpr size_t HEADER_SIZE = 8;
+    }
+
+    // Transport that appends every report to a file for later replay.
+    // The file is opened by begin() and written from the output task.
+    class FileDumpTransport {
+    public:
+        using Report = BootReport;
+
+        FileDumpTransport(fs::FS& fs, const char* path) : fs(fs), path(path) {}
+
+        void begin() {
+            file = fs.open(path, "w");
+            if (!file) return;
+            uint8_t header[ReportDump::HEADER_SIZE];
+            memcpy(header, ReportDump::MAGIC, 4);
+            header[4] = ReportDump::VERSION & 0xFF;
+            header[5] = ReportDump::VERSION >> 8;
+            header[6] = ReportDump::RECORD_SIZE & 0xFF;
+            header[7] = ReportDump::RECORD_SIZE >> 8;
+            file.write(header, sizeof(header));
+        }
+
+        bool isConnected() const { return (bool)file; }
+
+        void sendReport(const Report* report) {
+            uint8_t record[ReportDump::RECORD_SIZE];
+            uint32_t now = micros();
+            for (int i = 0; i < 4; i++) record[i] = (now >> (8 * i)) & 0xFF;
+            memcpy(record + 4, report, sizeof(Report));
+            if (file.write(record, sizeof(record)) == sizeof(record)) {
+                written.fetch_add(1, std::memory_order_release);
+            }
+        }
+
+        // Closes the file; call once the keyboard is flushed
+        void end() { file.close(); }
+
+        // Reports written so far
+        uint32_t total() const { return written.load(std::memory_order_acquire); }
+
+    private:
+        fs::FS& fs;
+        String path;
+        File file;
+        std::atomic<uint32_t> written{0};
+    };
+
+    // Reads a dump back, record by record
+    class ReportDumpReader {
+    public:
+        bool open(fs::FS& fs, const char* path) {
+            file = fs.open(path, "r");
+            if (!file) return false;
+
+            uint8_t header[ReportDump::HEADER_SIZE];
+            if (file.read(header, sizeof(header)) != sizeof(header) ||
+                memcmp(header, ReportDump::MAGIC, 4) != 0 ||
+                (header[4] | (header[5] << 8)) != ReportDump::VERSION ||
+                (header[6] | (header[7] << 8)) != ReportDump::RECORD_SIZE) {
+                file.close();
+                return false;
+            }
+            return true;
+        }
+
+        bool next(ReportRecord& out) {
+            uint8_t record[ReportDump::RECORD_SIZE];
+            if (!file || file.read(record, sizeof(record)) != sizeof(record)) return false;
+            out.timestampMicros = record[0] | (record[1] << 8) | (record[2] << 16) |
+                                  ((uint32_t)record[3] << 24);
+            memcpy(&out.report, record + 4, sizeof(BootReport));
+            return true;
+        }
+
+        // Sends every remaining record to another transport, optionally
+        // keeping the recorded spacing. Returns the number of reports sent.
+        template<typename Transport>
+        uint32_t replay(Transport& target, bool keepTiming) {
+            static_assert(sizeof(typename Transport::Report) == sizeof(BootReport),
+                          "Replay needs an 8-byte boot report");
+            ReportRecord record;
+            typename Transport::Report report;
+            uint32_t sent = 0;
+            uint32_t previous = 0;
+            while (next(record)) {
+                if (keepTiming && sent > 0) {
+                    uint32_t gap = record.timestampMicros - previous;
+                    if (gap >= 1000) delay(gap / 1000);
+                    delayMicroseconds(gap % 1000);
+                }
+                previous = record.timestampMicros;
+                memcpy(&report, &record.report, sizeof(report));
+                target.sendReport(&report);
+                sent++;
+            }
+            return sent;
+        }
+
+    private:
+        File file;
+    };
+}
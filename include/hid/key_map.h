@@ -0,0 +1,104 @@
+#pragma once
+#include <Arduino.h>
+#include <array>
+
+namespace Hid {
+    // Modifier bits in byte 0 of a boot keyboard report
+    namespace Modifier {
+        constexpr uint8_t LEFT_CTRL = 0x01;
+        constexpr uint8_t LEFT_SHIFT = 0x02;
+        constexpr uint8_t LEFT_ALT = 0x04;
+        constexpr uint8_t LEFT_GUI = 0x08;
+    }
+
+    struct KeyCode {
+        uint8_t usage;       // HID usage id, 0 = none
+        uint8_t modifiers;   // Modifier bits to hold with it
+    };
+
+    // Byte -> HID usage for a US layout, using the same key numbering as
+    // BleKeyboard: 0x00-0x7F ASCII, 0x80-0x87 modifiers, 0x88 and up are
+    // raw usages offset by 0x88 (KEY_TAB, KEY_BACKSPACE, arrows, ...).
+    // Built at compile time so a lookup is one indexed load.
+    namespace KeyMapTable {
+        constexpr uint8_t FIRST_MODIFIER = 0x80;
+        constexpr uint8_t FIRST_RAW_USAGE = 0x88;
+
+        constexpr KeyCode plain(uint8_t usage) { return {usage, 0}; }
+        constexpr KeyCode shifted(uint8_t usage) { return {usage, Modifier::LEFT_SHIFT}; }
+
+        constexpr std::array<KeyCode, 256> build() {
+            std::array<KeyCode, 256> table = {};
+
+            table['\b'] = plain(0x2A);
+            table['\t'] = plain(0x2B);
+            table['\n'] = plain(0x28);
+            table['\r'] = plain(0x28);
+            table[0x1B] = plain(0x29);   // Escape
+            table[' '] = plain(0x2C);
+
+            for (int c = 'a'; c <= 'z'; c++) table[c] = plain(0x04 + (c - 'a'));
+            for (int c = 'A'; c <= 'Z'; c++) table[c] = shifted(0x04 + (c - 'A'));
+            for (int c = '1'; c <= '9'; c++) table[c] = plain(0x1E + (c - '1'));
+            table['0'] = plain(0x27);
+
+            // Shifted digit row
+            const char digitShift[] = "!@#$%^&*()";
+            for (int i = 0; i < 10; i++) table[(uint8_t)digitShift[i]] = shifted(0x1E + i);
+
+            // Punctuation keys 0x2D-0x38 (0x32 is the non-US hash key)
+            const char unshifted[] = "-=[]\\\0;'`,./";
+            const char withShift[] = "_+{}|\0:\"~<>?";
+            for (int i = 0; i < 12; i++) {
+                if (unshifted[i]) table[(uint8_t)unshifted[i]] = plain(0x2D + i);
+                if (withShift[i]) table[(uint8_t)withShift[i]] = shifted(0x2D + i);
+            }
+
+            // Modifier keys carry only their bit
+            for (int k = FIRST_MODIFIER; k < FIRST_RAW_USAGE; k++) {
+                table[k] = {0, (uint8_t)(1 << (k - FIRST_MODIFIER))};
+            }
+            for (int k = FIRST_RAW_USAGE; k < 256; k++) table[k] = plain(k - FIRST_RAW_USAGE);
+
+            return table;
+        }
+
+        inline constexpr std::array<KeyCode, 256> TABLE = build();
+
+        constexpr bool coversPrintable() {
+            for (int c = 0x20; c < 0x7F; c++) {
+                if (TABLE[c].usage == 0) return false;
+            }
+            return true;
+        }
+
+        constexpr bool usagesUnique() {
+            // No two printable characters may share a usage and shift state
+            for (int a = 0x20; a < 0x7F; a++) {
+                for (int b = a + 1; b < 0x7F; b++) {
+                    if (TABLE[a].usage == TABLE[b].usage &&
+                        TABLE[a].modifiers == TABLE[b].modifiers) return false;
+                }
+            }
+            return true;
+        }
+
+        static_assert(coversPrintable(), "Every printable ASCII character needs a key");
+        static_assert(usagesUnique(), "Two characters map to the same key");
+        static_assert(TABLE['a'].usage == 0x04 && TABLE['z'].usage == 0x1D, "Letter row");
+        static_assert(TABLE['A'].modifiers == Modifier::LEFT_SHIFT, "Capitals need shift");
+        static_assert(TABLE['0'].usage == 0x27 && TABLE[')'].usage == 0x27, "Digit row");
+        static_assert(TABLE['\n'].usage == 0x28 && TABLE['\t'].usage == 0x2B, "Control keys");
+        static_assert(TABLE['/'].usage == 0x38 && TABLE['?'].modifiers == Modifier::LEFT_SHIFT,
+                      "Punctuation row");
+    }
+
+    class KeyMap {
+    public:
+        static constexpr KeyCode lookup(uint8_t key) { return KeyMapTable::TABLE[key]; }
+
+        static constexpr bool isModifier(uint8_t key) {
+            return key >= KeyMapTable::FIRST_MODIFIER && key < KeyMapTable::FIRST_RAW_USAGE;
+        }
+    };
+}
@@ -0,0 +1,321 @@
+#pragma once
+#include <Arduino.h>
+#include <algorithm>
+#include <vector>
+#include "constants.h"
+#include "utils/pause_map.h"
+
+namespace Hid {
+    // Compact keystroke bytecode. A program is a byte stream of opcodes
+    // followed by their operands (multi-byte operands little-endian):
+    //
+    //   END                      stop
+    //   KEY k                    press and release key k
+    //   TEXT n c1..cn            KEY for each of n bytes
+    //   REPEAT k n               KEY k, n times
+    //   PRESS k / RELEASE k      hold / let go of key k (modifiers too)
+    //   RELEASE_ALL
+    //   WAIT ms16                extra delay before the next key
+    //   PACE ms16                minimum gap between keys from here on
+    //   CHECKPOINT id32          marks a position (e.g. a text offset)
+    //
+    // A key goes out max(pace, accumulated waits) after the previous one.
+    enum class Op : uint8_t {
+        END = 0,
+        KEY,
+        TEXT,
+        REPEAT,
+        PRESS,
+        RELEASE,
+        RELEASE_ALL,
+        WAIT,
+        PACE,
+        CHECKPOINT
+    };
+
+    // Emits a program into a reusable buffer; back-to-back keys are packed
+    // into TEXT runs and consecutive waits are merged
+    class ProgramBuilder {
+    public:
+        void clear() {
+            code.clear();
+            runStart = NO_RUN;
+            pendingWait = 0;
+        }
+
+        void key(uint8_t k) {
+            flushWait();
+            if (runStart != NO_RUN) {
+                if (code[runStart] == (uint8_t)Op::KEY) {
+                    // Second key in a row: KEY k1 becomes TEXT 2 k1 k2
+                    uint8_t first = code[runStart + 1];
+                    code[runStart] = (uint8_t)Op::TEXT;
+                    code[runStart + 1] = 2;
+                    code.push_back(first);
+                    code.push_back(k);
+                    return;
+                }
+                if (code[runStart + 1] < MAX_RUN) {
+                    code[runStart + 1]++;
+                    code.push_back(k);
+                    return;
+                }
+            }
+            runStart = code.size();
+            code.push_back((uint8_t)Op::KEY);
+            code.push_back(k);
+        }
+
+        void repeat(uint8_t k, uint8_t count) {
+            emit(Op::REPEAT);
+            code.push_back(k);
+            code.push_back(count);
+        }
+
+        void press(uint8_t k) { emit(Op::PRESS); code.push_back(k); }
+        void release(uint8_t k) { emit(Op::RELEASE); code.push_back(k); }
+        void releaseAll() { emit(Op::RELEASE_ALL); }
+
+        void wait(uint32_t ms) {
+            pendingWait = std::min<uint32_t>(pendingWait + ms, UINT16_MAX);
+            runStart = NO_RUN;
+        }
+
+        void pace(uint16_t ms) { emit(Op::PACE); push16(ms); }
+        void checkpoint(uint32_t id) { emit(Op::CHECKPOINT); push32(id); }
+
+        // Terminates the program; data()/size() are valid afterwards
+        void end() { emit(Op::END); }
+
+        // Removes and returns the waits not yet followed by a key. A program
+        // played in pieces moves them to the next piece, since the VM drops
+        // a wait at END.
+        uint32_t takePendingWait() {
+            uint32_t ms = pendingWait;
+            pendingWait = 0;
+            return ms;
+        }
+
+        const uint8_t* data() const { return code.data(); }
+        size_t size() const { return code.size(); }
+
+    private:
+        static constexpr size_t NO_RUN = SIZE_MAX;
+        static constexpr uint8_t MAX_RUN = 255;
+
+        std::vector<uint8_t> code;
+        size_t runStart = NO_RUN;     // Offset of the open TEXT op
+        uint32_t pendingWait = 0;
+
+        void emit(Op op) {
+            flushWait();
+            runStart = NO_RUN;
+            code.push_back((uint8_t)op);
+        }
+
+        void flushWait() {
+            if (pendingWait == 0) return;
+            code.push_back((uint8_t)Op::WAIT);
+            push16(pendingWait);
+            pendingWait = 0;
+            runStart = NO_RUN;
+        }
+
+        void push16(uint16_t value) {
+            code.push_back(value & 0xFF);
+            code.push_back(value >> 8);
+        }
+
+        void push32(uint32_t value) {
+            push16(value & 0xFFFF);
+            push16(value >> 16);
+        }
+    };
+
+    // Plays a program. Sink receives key(k, gap), press(k, gap),
+    // release(k, gap), releaseAll(gap) and checkpoint(id); gap is the
+    // delay in ms since the previous key. Each op is one switch dispatch
+    // with no allocation. Returns the number of ops executed.
+    class KeystrokeVM {
+    public:
+        template<typename Sink>
+        static uint32_t run(const uint8_t* code, size_t length, Sink& sink, uint16_t pace = 0) {
+            const uint8_t* pc = code;
+            const uint8_t* end = code + length;
+            uint32_t wait = 0;
+            uint32_t ops = 0;
+
+            auto gap = [&]() -> uint16_t {
+                uint16_t g = std::min<uint32_t>(std::max<uint32_t>(pace, wait), UINT16_MAX);
+                wait = 0;
+                return g;
+            };
+
+            while (pc < end) {
+                Op op = static_cast<Op>(*pc++);
+                ops++;
+                switch (op) {
+                    case Op::END:
+                        return ops;
+                    case Op::KEY:
+                        if (end - pc < 1) return ops;
+                        sink.key(pc[0], gap());
+                        pc += 1;
+                        break;
+                    case Op::TEXT: {
+                        if (end - pc < 1 || end - pc - 1 < pc[0]) return ops;
+                        uint8_t n = *pc++;
+                        for (uint8_t i = 0; i < n; i++) sink.key(pc[i], gap());
+                        pc += n;
+                        break;
+                    }
+                    case Op::REPEAT:
+                        if (end - pc < 2) return ops;
+                        for (uint8_t i = 0; i < pc[1]; i++) sink.key(pc[0], gap());
+                        pc += 2;
+                        break;
+                    case Op::PRESS:
+                        if (end - pc < 1) return ops;
+                        sink.press(pc[0], gap());
+                        pc += 1;
+                        break;
+                    case Op::RELEASE:
+                        if (end - pc < 1) return ops;
+                        sink.release(pc[0], gap());
+                        pc += 1;
+                        break;
+                    case Op::RELEASE_ALL:
+                        sink.releaseAll(gap());
+                        break;
+                    case Op::WAIT:
+                        if (end - pc < 2) return ops;
+                        wait += read16(pc);
+                        pc += 2;
+                        break;
+                    case Op::PACE:
+                        if (end - pc < 2) return ops;
+                        pace = read16(pc);
+                        pc += 2;
+                        break;
+                    case Op::CHECKPOINT:
+                        if (end - pc < 4) return ops;
+                        sink.checkpoint(read32(pc));
+                        pc += 4;
+                        break;
+                    default:
+                        return ops;  // Unknown opcode: stop rather than guess
+                }
+            }
+            return ops;
+        }
+
+        static uint16_t read16(const uint8_t* p) {
+            return p[0] | (p[1] << 8);
+        }
+
+        static uint32_t read32(const uint8_t* p) {
+            return read16(p) | ((uint32_t)read16(p + 2) << 16);
+        }
+    };
+
+    // Straight text-to-program compiler: fixed pace, sentence and comma
+    // pauses, a checkpoint after every word (id = offset in the text)
+    class KeystrokeCompiler {
+    public:
+        struct Pacing {
+            uint16_t charGapMillis = Constants::Typing::BASE_CHAR_DELAY;
+            uint16_t wordPauseMillis = Constants::Typing::WORD_PAUSE;
+            uint16_t sentencePauseMillis = Constants::Typing::SENTENCE_PAUSE;
+        };
+
+        static void compile(const char* text, size_t length, const Pacing& pacing,
+                            ProgramBuilder& out, Utils::PauseMap& pauses) {
+            pauses.build(text, length);
+            out.pace(pacing.charGapMillis);
+
+            for (size_t i = 0; i < length; i++) {
+                char c = text[i];
+                out.key(c);
+
+                switch (pauses.at(i)) {
+                    case Utils::PauseMap::Pause::SENTENCE:
+                        out.wait(pacing.sentencePauseMillis);
+                        break;
+                    case Utils::PauseMap::Pause::WORD:
+                        out.wait(pacing.wordPauseMillis);
+                        break;
+                    default:
+                        break;
+                }
+                if (c == ' ' || c == '\n') out.checkpoint(i);
+            }
+            out.end();
+        }
+    };
+
+    // Human-readable listing, one op per line
+    inline void disassemble(const uint8_t* code, size_t length, Print& out) {
+        static const char* const NAMES[] = {
+            "END", "KEY", "TEXT", "REPEAT", "PRESS", "RELEASE",
+            "RELEASE_ALL", "WAIT", "PACE", "CHECKPOINT"
+        };
+
+        auto printKey = [&](uint8_t k) {
+            if (k >= 0x20 && k < 0x7F) out.printf(" '%c'", k);
+            else out.printf(" 0x%02X", k);
+        };
+
+        size_t pc = 0;
+        while (pc < length) {
+            uint8_t op = code[pc];
+            if (op >= sizeof(NAMES) / sizeof(NAMES[0])) {
+                out.printf("%04u  ??? 0x%02X\n", (unsigned)pc, op);
+                return;
+            }
+            out.printf("%04u  %-11s", (unsigned)pc, NAMES[op]);
+            pc++;
+
+            switch (static_cast<Op>(op)) {
+                case Op::KEY:
+                case Op::PRESS:
+                case Op::RELEASE:
+                    if (pc < length) printKey(code[pc]);
+                    pc += 1;
+                    break;
+                case Op::TEXT: {
+                    uint8_t n = pc < length ? code[pc] : 0;
+                    out.printf(" %u \"", n);
+                    for (uint8_t i = 0; i < n && pc + 1 + i < length; i++) {
+                        char c = code[pc + 1 + i];
+                        if (c == '\n') out.print("\\n");
+                        else if (c >= 0x20 && c < 0x7F) out.printf("%c", c);
+                        else out.printf("\\x%02X", (uint8_t)c);
+                    }
+                    out.print("\"");
+                    pc += 1 + n;
+                    break;
+                }
+                case Op::REPEAT:
+                    if (pc + 1 < length) {
+                        printKey(code[pc]);
+                        out.printf(" x%u", code[pc + 1]);
+                    }
+                    pc += 2;
+                    break;
+                case Op::WAIT:
+                case Op::PACE:
+                    if (pc + 1 < length) out.printf(" %u", KeystrokeVM::read16(code + pc));
+                    pc += 2;
+                    break;
+                case Op::CHECKPOINT:
+                    if (pc + 3 < length) out.printf(" %u", (unsigned)KeystrokeVM::read32(code + pc));
+                    pc += 4;
+                    break;
+                default:
+                    break;
+            }
+            out.println();
+            if (static_cast<Op>(op) == Op::END) return;
+        }
+    }
+}
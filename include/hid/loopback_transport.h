@@ -0,0 +1,47 @@
+#pragma once
+#include <Arduino.h>
+#include <atomic>
+#include "hid/boot_report.h"
+
+namespace Hid {
+    // Transport that sends nothing and keeps the last Capacity reports with
+    // their send time instead, so report rate and spacing can be measured
+    // without a board. Written by the output task only; read the records
+    // after Keyboard::flush(). total() keeps counting past Capacity.
+    template<size_t Capacity>
+    class LoopbackTransport {
+    public:
+        static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0,
+                      "Capacity must be a power of two");
+        using Report = BootReport;
+
+        void begin() {}
+        bool isConnected() const { return connected.load(std::memory_order_relaxed); }
+
+        // Simulates the host dropping the link
+        void setConnected(bool value) { connected.store(value, std::memory_order_relaxed); }
+
+        void sendReport(const Report* report) {
+            uint32_t n = count.load(std::memory_order_relaxed);
+            records[n & (Capacity - 1)] = {(uint32_t)micros(), *report};
+            count.store(n + 1, std::memory_order_release);
+        }
+
+        uint32_t total() const { return count.load(std::memory_order_acquire); }
+        size_t size() const { return min<size_t>(total(), Capacity); }
+
+        // 0 is the oldest record still kept
+        const ReportRecord& at(size_t i) const {
+            uint32_t n = total();
+            uint32_t first = n > Capacity ? n - Capacity : 0;
+            return records[(first + i) & (Capacity - 1)];
+        }
+
+        void clear() { count.store(0, std::memory_order_release); }
+
+    private:
+        ReportRecord records[Capacity];
+        std::atomic<uint32_t> count{0};
+        std::atomic<bool> connected{true};
+    };
+}
@@ -0,0 +1,74 @@
+#pragma once
+#include <Arduino.h>
+
+namespace Hid {
+    // Remembers how far typed output got before the link dropped, so the
+    // interrupted clip resumes there instead of being retyped or lost.
+    // A position is (clip, timeframe, byte offset into that text); timeframe
+    // 0 is the clip's main description, n is timeframe n. Offsets come from
+    // the word-boundary CHECKPOINTs the consumer actually passed, so
+    // everything before a position is known to have been sent.
+    class OutputJournal {
+    public:
+        struct Position {
+            int clip = 0;
+            uint16_t timeframe = 0;
+            uint32_t offset = 0;
+        };
+
+        struct Stats {
+            uint32_t interruptions = 0;
+            uint32_t wastedKeystrokes = 0;   // Sent past a checkpoint, plus their erasure
+            uint32_t lastOutageMillis = 0;   // Interruption to resume
+            uint32_t lastResumeMillis = 0;   // Resume to output back in place
+        };
+
+        // Output stopped after `at`. keysLost were sent past it, `erase`
+        // characters of which are still on screen.
+        void record(const Position& at, uint16_t keysLost, uint16_t erase) {
+            resumePoint = at;
+            pendingErase = erase;
+            pending = true;
+            interruptedAt = millis();
+            stats.interruptions++;
+            stats.wastedKeystrokes += keysLost;
+        }
+
+        // Where a clip's output starts: its resume point when an interrupted
+        // run of it is pending, otherwise its beginning. A resume point for
+        // another clip is discarded. Returns true when resuming.
+        bool resumeFrom(int clip, Position& from) {
+            bool resuming = pending && resumePoint.clip == clip;
+            pending = false;
+            if (!resuming) {
+                from = Position{clip, 0, 0};
+                pendingErase = 0;
+                return false;
+            }
+            from = resumePoint;
+            stats.lastOutageMillis = millis() - interruptedAt;
+            return true;
+        }
+
+        // Characters to backspace over before resuming
+        uint16_t getPendingErase() const { return pendingErase; }
+
+        // Output is back at the resume point
+        void resumed(uint32_t latencyMillis) {
+            stats.wastedKeystrokes += pendingErase;
+            stats.lastResumeMillis = latencyMillis;
+            pendingErase = 0;
+        }
+
+        bool hasResumePoint() const { return pending; }
+        const Position& getResumePoint() const { return resumePoint; }
+        const Stats& getStats() const { return stats; }
+
+    private:
+        Position resumePoint;
+        uint16_t pendingErase = 0;
+        bool pending = false;
+        unsigned long interruptedAt = 0;
+        Stats stats;
+    };
+}
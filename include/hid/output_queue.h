@@ -0,0 +1,197 @@
+#pragma once
+#include <Arduino.h>
+#include <algorithm>
+#include <atomic>
+#include "hid/key_map.h"
+#include "utils/spsc_queue.h"
+
+namespace Hid {
+    struct KeyEvent {
+        enum class Action : uint8_t {
+            WRITE,        // Press and release
+            PRESS,
+            RELEASE,
+            RELEASE_ALL,
+            CHECKPOINT    // Sends nothing, records checkpointId when reached
+        };
+
+        Action action;
+        uint8_t key;
+        union {
+            uint16_t gapMillis;     // Minimum time since the previous keystroke
+            uint32_t checkpointId;  // CHECKPOINT only
+        };
+        uint32_t ticket;      // Completion id handed back to the producer
+    };
+
+    // Timed keystroke queue between the code that decides what to type
+    // (producer) and the task that owns the HID device (consumer). Sink is
+    // anything with BleKeyboard's write/press/release/releaseAll/isConnected.
+    //
+    // Producer: enqueue() returns a ticket, or 0 when the queue is full
+    // (backpressure). isDone(ticket) reports completion.
+    // Consumer: call service() in a loop; it never blocks.
+    //
+    // While the sink is disconnected keys are held, not dropped, and
+    // isStalled() is true; the producer either waits for the link or
+    // cancels. The consumer also counts what it sent since the last
+    // CHECKPOINT so the producer can tell how far output really got.
+    template<typename Sink, size_t Capacity>
+    class OutputQueue {
+    public:
+        explicit OutputQueue(Sink& sink) : sink(sink) {}
+
+        // Producer side. value is the gap in milliseconds, or for a
+        // CHECKPOINT its id.
+        uint32_t enqueue(KeyEvent::Action action, uint8_t key = 0, uint32_t value = 0) {
+            uint32_t ticket = nextTicket + 1;
+            if (ticket == 0) ticket = 1;
+
+            KeyEvent event;
+            event.action = action;
+            event.key = key;
+            if (action == KeyEvent::Action::CHECKPOINT) event.checkpointId = value;
+            else event.gapMillis = std::min<uint32_t>(value, UINT16_MAX);
+            event.ticket = ticket;
+            if (!events.push(event)) return 0;
+
+            nextTicket = ticket;
+            issuedTicket.store(ticket, std::memory_order_release);
+            return ticket;
+        }
+
+        bool isDone(uint32_t ticket) const {
+            return (int32_t)(completedTicket.load(std::memory_order_acquire) - ticket) >= 0;
+        }
+
+        bool isIdle() const { return isDone(issuedTicket.load(std::memory_order_acquire)); }
+        bool hasSpace() const { return !events.isFull(); }
+        size_t pending() const { return events.size(); }
+
+        // Everything queued so far is discarded instead of sent
+        void cancelPending() {
+            cancelTicket.store(issuedTicket.load(std::memory_order_acquire),
+                               std::memory_order_release);
+        }
+
+        // Consumer side. Sends the next event if its gap has elapsed;
+        // returns true when an event was consumed.
+        bool service(uint32_t now) {
+            const KeyEvent* event = events.peek();
+            if (!event) return false;
+
+            bool cancelled = (int32_t)(cancelTicket.load(std::memory_order_acquire) - event->ticket) >= 0;
+            if (event->action == KeyEvent::Action::CHECKPOINT) {
+                if (!cancelled) {
+                    lastCheckpoint.store(event->checkpointId, std::memory_order_relaxed);
+                    keysSinceCheckpoint.store(0, std::memory_order_relaxed);
+                    charsSinceCheckpoint.store(0, std::memory_order_relaxed);
+                    checkpointCount.fetch_add(1, std::memory_order_release);
+                }
+            } else if (cancelled) {
+                droppedCount++;
+            } else if (!sink.isConnected()) {
+                stalled.store(true, std::memory_order_release);
+                return false;
+            } else {
+                if (now - lastSendTime < event->gapMillis) return false;
+                send(*event);
+                lastSendTime = now;
+                sentCount++;
+                countSent(*event);
+            }
+
+            stalled.store(false, std::memory_order_release);
+            completedTicket.store(event->ticket, std::memory_order_release);
+            events.drop();
+            return true;
+        }
+
+        // How long the consumer may sleep before the front event is due
+        uint32_t millisUntilDue(uint32_t now) const {
+            const KeyEvent* event = events.peek();
+            if (!event) return UINT32_MAX;
+            if (event->action == KeyEvent::Action::CHECKPOINT) return 0;
+            uint32_t waited = now - lastSendTime;
+            return waited >= event->gapMillis ? 0 : event->gapMillis - waited;
+        }
+
+        // True while the front key is held for a lost link
+        bool isStalled() const { return stalled.load(std::memory_order_acquire); }
+
+        // Id of the last CHECKPOINT the consumer passed
+        uint32_t getLastCheckpoint() const {
+            return lastCheckpoint.load(std::memory_order_acquire);
+        }
+
+        // CHECKPOINTs passed so far, and what was sent after the last one:
+        // keys, and the net characters they left (backspace counts -1).
+        // Exact once the queue is idle.
+        uint32_t getCheckpointCount() const { return checkpointCount.load(std::memory_order_acquire); }
+        uint16_t getKeysSinceCheckpoint() const { return keysSinceCheckpoint.load(std::memory_order_acquire); }
+        int16_t getCharsSinceCheckpoint() const { return charsSinceCheckpoint.load(std::memory_order_acquire); }
+
+        // Producer, only while idle: start counting from zero again
+        void resetSinceCheckpoint() {
+            keysSinceCheckpoint.store(0, std::memory_order_relaxed);
+            charsSinceCheckpoint.store(0, std::memory_order_release);
+        }
+
+        uint32_t getSentCount() const { return sentCount; }
+        uint32_t getDroppedCount() const { return droppedCount; }
+
+    private:
+        Sink& sink;
+        Utils::SpscQueue<KeyEvent, Capacity> events;
+
+        // Producer-owned
+        uint32_t nextTicket = 0;
+
+        // Shared
+        std::atomic<uint32_t> issuedTicket{0};
+        std::atomic<uint32_t> completedTicket{0};
+        std::atomic<uint32_t> cancelTicket{0};
+        std::atomic<uint32_t> lastCheckpoint{0};
+        std::atomic<uint32_t> checkpointCount{0};
+        std::atomic<uint16_t> keysSinceCheckpoint{0};
+        std::atomic<int16_t> charsSinceCheckpoint{0};
+        std::atomic<bool> stalled{false};
+
+        // Consumer-owned
+        uint32_t lastSendTime = 0;
+        uint32_t sentCount = 0;
+        uint32_t droppedCount = 0;
+
+        static constexpr uint8_t BACKSPACE_USAGE = KeyMap::lookup('\b').usage;
+
+        void countSent(const KeyEvent& event) {
+            keysSinceCheckpoint.store(keysSinceCheckpoint.load(std::memory_order_relaxed) + 1,
+                                      std::memory_order_relaxed);
+            if (event.action != KeyEvent::Action::WRITE) return;
+
+            int16_t chars = charsSinceCheckpoint.load(std::memory_order_relaxed);
+            if (KeyMap::lookup(event.key).usage == BACKSPACE_USAGE) chars--;
+            else if (event.key < 0x80) chars++;
+            charsSinceCheckpoint.store(chars, std::memory_order_relaxed);
+        }
+
+        void send(const KeyEvent& event) {
+            switch (event.action) {
+                case KeyEvent::Action::WRITE:
+                    sink.write(event.key);
+                    break;
+                case KeyEvent::Action::PRESS:
+                    sink.press(event.key);
+                    break;
+                case KeyEvent::Action::RELEASE:
+                    sink.release(event.key);
+                    break;
+                case KeyEvent::Action::RELEASE_ALL:
+                    sink.releaseAll();
+                    break;
+                case KeyEvent::Action::CHECKPOINT:
+                    break;
+            }
+        }
+    };
+}
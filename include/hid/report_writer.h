@@ -0,0 +1,103 @@
+#pragma once
+#include <Arduino.h>
+#include "hid/key_map.h"
+
+namespace Hid {
+    // Keeps the current keyboard report and sends it through
+    // Device::sendReport(Report*) whenever it changes, using the compile-
+    // time KeyMap instead of the HID library's own per-key translation.
+    // Device is a keyboard transport (hid/ble_transport.h and friends) and
+    // Report its 8-byte boot report type. Offers the write/press/release/
+    // releaseAll/isConnected set OutputQueue expects of its sink.
+    //
+    // Consecutive reports are spaced at least minSpacingMicros apart so
+    // each lands in its own BLE connection event instead of being dropped
+    // or merged by the stack; the wait happens on the calling (output) task.
+    template<typename Device, typename Report>
+    class ReportWriter {
+    public:
+        explicit ReportWriter(Device& device) : device(device), report{} {}
+
+        bool isConnected() { return device.isConnected(); }
+
+        size_t press(uint8_t key) {
+            if (!addKey(KeyMap::lookup(key))) return 0;
+            send();
+            return 1;
+        }
+
+        size_t release(uint8_t key) {
+            removeKey(KeyMap::lookup(key));
+            send();
+            return 1;
+        }
+
+        // Press and release, two reports. A key that could not be pressed
+        // (unmapped, or six keys down) sends nothing: its release would
+        // only let go of an earlier press of the same key.
+        size_t write(uint8_t key) {
+            size_t n = press(key);
+            if (n == 0) return 0;
+            release(key);
+            return n;
+        }
+
+        void releaseAll() {
+            report = Report{};
+            send();
+        }
+
+        void setMinSpacing(uint32_t micros) { minSpacingMicros = micros; }
+
+        const Report& current() const { return report; }
+        uint32_t getReportCount() const { return reportCount; }
+
+    private:
+        Device& device;
+        Report report;
+        uint32_t minSpacingMicros = 0;
+        uint32_t lastReportMicros = 0;
+        uint32_t reportCount = 0;
+
+        bool addKey(KeyCode code) {
+            if (code.usage == 0 && code.modifiers == 0) return false;
+            report.modifiers |= code.modifiers;
+            if (code.usage == 0) return true;
+
+            for (uint8_t& slot : report.keys) {
+                if (slot == code.usage) return true;
+            }
+            for (uint8_t& slot : report.keys) {
+                if (slot == 0) {
+                    slot = code.usage;
+                    return true;
+                }
+            }
+            return false;  // Six keys already down
+        }
+
+        void removeKey(KeyCode code) {
+            report.modifiers &= ~code.modifiers;
+            if (code.usage == 0) return;
+            for (uint8_t& slot : report.keys) {
+                if (slot == code.usage) slot = 0;
+            }
+        }
+
+        void send() {
+            if (minSpacingMicros > 0 && reportCount > 0) {
+                // Sleep whole milliseconds, busy-wait only the remainder
+                uint32_t since = micros() - lastReportMicros;
+                if (since < minSpacingMicros) {
+                    uint32_t remaining = minSpacingMicros - since;
+                    if (remaining >= 1000) delay(remaining / 1000);
+                    since = micros() - lastReportMicros;
+                    if (since < minSpacingMicros) delayMicroseconds(minSpacingMicros - since);
+                }
+            }
+            device.sendReport(&report);
+            lastReportMicros = micros();
+            reportCount++;
+        }
+    };
+}
@@ -1,10 +1,16 @@
 #pragma once
 #include "keyboard.h"
-#include "hardware.h"
+#include "ui/ui_link.h"
 #include "constants.h"
 #include "aht/time_distributor.h"
 #include "timing/progress_tracker.h"
 #include "timing/speed_adjuster.h"
+#include "analysis/task_image.h"
+#include "analysis/task_analyzer.h"
+#include "utils/log.h"
+#include "utils/pause_map.h"
+#include "utils/random.h"
+#include "hid/output_journal.h"
 #include <SPIFFS.h>
 
 namespace Analysis {
@@ -41,6 +47,9 @@ public:
         float correctionRate;
         float speedCompliance;
         float timeUtilization;
+        uint32_t navigationMillis;   // Achieved latency of the last clip navigation
+        uint32_t resumeMillis;       // Last resume after a dropped link
+        uint32_t wastedKeystrokes;   // Sent past the journal and taken back
     };
 
     // Behavioral configurations
@@ -59,17 +68,23 @@ public:
         int maxWordsBeforeBreak;
     };
 
-    HumanSimulator(Keyboard& kb, Hardware& hw) 
+    // Every random decision (typos, pauses, delays, the keyboard's tab
+    // delays) draws from rng, so a fixed seed reproduces a session
+    HumanSimulator(Keyboard& kb, Ui::Link& link, Utils::Random& rng)
         : keyboard(kb)
-        , hardware(hw) {}
+        , ui(link)
+        , rng(rng) {
+        kb.setRandom(rng);
+    }
 
     // Initialization and setup
     void init();
-    void loadTask(const String& videoId);
+    void loadTask(const String& videoId = "");
     void reset();
 
-    // Task processing
-    void processClip(int clipNumber);
+    // Task processing. Returns true once the clip is fully typed; an
+    // interrupted clip resumes from the journal on the next call.
+    bool processClip(int clipNumber);
     void pause();
     void resume();
     bool isComplete() const;
@@ -78,6 +93,7 @@ public:
     TaskInfo getTaskInfo() const;
     BehaviorState getBehaviorState() const;
     PerformanceMetrics getPerformanceMetrics() const;
+    Timing::ProgressSnapshot getProgress() const;
 
     // Add this method
     int getTotalClips() const { return totalClips; }
@@ -85,7 +101,8 @@ public:
 private:
     // Core components
     Keyboard& keyboard;
-    Hardware& hardware;
+    Ui::Link& ui;        // Progress and errors for the UI core
+    Utils::Random& rng;
     TaskInfo taskInfo;
     BehaviorState behavior;
     PerformanceMetrics metrics;
@@ -95,22 +112,37 @@ private:
     std::unique_ptr<Timing::ProgressTracker> progressTracker;
     std::unique_ptr<Timing::SpeedAdjuster> speedAdjuster;
 
+    // Precompiled task (/task.bin), used instead of parsing when present
+    Analysis::TaskImage taskImage;
+    Timing::DurationAnalysis taskDuration;  // Referenced by progressTracker
+
+    // Parsed clips kept from loadTask(); empty when the image is used
+    std::vector<Analysis::ClipData> clips;
+    Analysis::ClipData imageClip;
+
     // Configuration
     SpeedConfig speedConfig;
     BehaviorConfig behaviorConfig;
 
     // Text processing
-    void typeText(const String& text);
+    // These return false when output stopped early (paused or link lost)
+    // `separate` starts the text on a new line, after an earlier one
+    bool typeText(const String& text, size_t from = 0, bool separate = false);
     void handleTypos(const String& word);
-    void processTimeframe(const Analysis::TimeFrame& frame);
-    void navigateToClip(int clipNumber);
+    bool processTimeframe(const Analysis::TimeFrame& frame, size_t from, bool separate);
+    bool navigateToClip(int clipNumber);
+
+    // Dropped link handling
+    bool resumeOutput(const Hid::OutputJournal::Position& from);
+    void recordInterruption(uint32_t from, uint32_t checkpointsBefore);
+    bool playChunk();       // Plays what is compiled so far; false when output stopped
 
     // Behavior simulation
     void applyFatigue();
     void updateAlertness();
     void simulateThinking();
     void simulateTypingDelay();
-    void handleNaturalPauses(const String& text);
+    void handleNaturalPauses(size_t start, size_t end);  // Punctuation of a typed word
     
     // Performance monitoring
     void updatePerformanceMetrics();
@@ -118,13 +150,17 @@ private:
     void checkProgressCompliance();
     
     // Utility methods
-    String readClipContent(int clipNumber);
+    bool loadTaskImage();
     void parseClipData(const String& content);
     void validateTimeframes();
     void logProgress();
 
     // Internal state tracking
-    String currentWord;
+    Utils::PauseMap pauseMap;  // Punctuation of the text being typed
+    Hid::ProgramBuilder program;  // Keystrokes compiled by typeText()
+    Hid::OutputJournal journal;   // How far output got before a dropped link
+    Hid::OutputJournal::Position outputPosition;  // Clip and timeframe being typed
+    Analysis::TextSpan currentWord;  // View into the text being typed
     int wordsInBurst;
     bool isPaused;
     int totalClips;
@@ -132,14 +168,13 @@ private:
     unsigned long lastActivityTime;
 
     // Add missing method declarations
-    void handleWord(const String& word);
-    void makeTypo(const String& word);
-    void correctTypo(const String& word, int typoPos);
-    bool decideCorrectionStrategy(const String& word, int typoPos);
-    void countClips();
+    void handleWord(Analysis::TextSpan word);
+    void makeTypo(Analysis::TextSpan word);
+    void correctTypo(Analysis::TextSpan word, int typoPos);
+    bool decideCorrectionStrategy(Analysis::TextSpan word, int typoPos);
     bool validateClipNumber(int clipNumber);
     char getRandomTypo(char originalChar);
-    void typeWordNormally(const String& word);
-    std::vector<Analysis::TimeFrame> parseTimeframes(const String& content);
+    void typeWordNormally(Analysis::TextSpan word);
+    const Analysis::ClipData* getClipData(int clipNumber);
     uint32_t estimateWordCount() const;
 };
\ No newline at end of file
@@ -1,45 +1,156 @@
 #pragma once
 #include <BleKeyboard.h>
+#include <utility>
 #include "constants.h"
+#include "hid/output_queue.h"
+#include "hid/keystroke_program.h"
+#include "hid/report_writer.h"
+#include "hid/ble_transport.h"
+#include "hid/loopback_transport.h"
+#include "hid/file_dump_transport.h"
+#include "timing/keystroke_stats.h"
+#include "utils/seqlock.h"
+#include "utils/scheduler.h"
+#include "utils/random.h"
+#include "utils/trace.h"
 
-class Keyboard {
+// Keyboard is generic over where its HID reports go. Transport needs a
+// Report type plus begin(), isConnected() and sendReport(Report*); it is
+// a template parameter so the output task calls it directly. The device
+// build uses BLE, host builds record into a loopback buffer.
+#ifdef ARDUINO
+using DefaultTransport = Hid::BleTransport;
+#else
+using DefaultTransport = Hid::LoopbackTransport<Constants::Hid::LOOPBACK_CAPACITY>;
+#endif
+
+template<typename Transport>
+class BasicKeyboard {
 public:
-    // Statistics structure
-    struct TypingStats {
-        uint32_t charactersTyped = 0;
-        uint32_t wordsTyped = 0;
-        float currentWPM = 0;
-        float averageWPM = 0;
+    // Arguments are handed to the transport's constructor
+    template<typename... Args>
+    explicit BasicKeyboard(Args&&... args) : transport(std::forward<Args>(args)...) {}
+
+    // Statistics of the characters actually sent, measured by the output
+    // task over a rolling window (see timing/keystroke_stats.h)
+    using KeystrokeStats = Timing::KeystrokeStats<Constants::Typing::STATS_WINDOW>;
+    using TypingStats = KeystrokeStats::Snapshot;
+
+    // Who services the output queue: a dedicated FreeRTOS task, or the
+    // main loop's Utils::Scheduler (host runs on a virtual clock)
+    enum class OutputMode {
+        TASK,
+        SCHEDULER
     };
 
-    void init();
+    void init(OutputMode mode = OutputMode::TASK);
     bool isConnected();
+    Transport& getTransport() { return transport; }
+    void setReportSpacing(uint32_t micros);  // Call before init()
     
     // Typing functions
     void type(const String& text, float speedMultiplier = 1.0f);
+    void type(const char* text, size_t length, float speedMultiplier = 1.0f);
+    void type(char c, float speedMultiplier = 1.0f);
     void pressKey(uint8_t key);
     void releaseKey(uint8_t key);
     
+    // Plays a compiled keystroke program (see hid/keystroke_program.h)
+    void play(const uint8_t* code, size_t length);
+    void play(const Hid::ProgramBuilder& program) { play(program.data(), program.size()); }
+    uint32_t lastCheckpoint() const;  // Last CHECKPOINT actually reached
+
+    // Output queue. Keys are sent by a dedicated task; these calls only
+    // enqueue and return unless the queue is full.
+    bool flush(uint32_t timeoutMs = UINT32_MAX);  // Wait until everything is sent
+    void cancelPending();   // Drop keys not yet sent, stop the program being queued
+    size_t pendingKeys() const;
+
+    // Lost link. Queued keys are held while it is down; a flush, or an
+    // enqueue into a full queue, gives up instead of waiting and
+    // isInterrupted() stays true until abandonOutput().
+    struct Delivery {
+        uint32_t checkpointCount = 0;      // CHECKPOINTs reached so far
+        uint32_t checkpoint = 0;           // Id of the last one
+        uint16_t keysSinceCheckpoint = 0;  // Sent after it
+        int16_t charsSinceCheckpoint = 0;  // Net characters those left on screen
+    };
+
+    bool isInterrupted() const;
+    Delivery getDelivery() const;
+    Delivery abandonOutput();   // Drops unsent keys, returns what got through
+
     // Navigation
+    struct NavigationResult {
+        int keys = 0;
+        uint32_t latencyMillis = 0;   // First key queued to last report sent
+        bool completed = false;
+    };
+
     void navigate(int tabCount);
     void navigateWithSpeed(int tabCount, float speedMultiplier);
+    // Tabs back to back, limited only by report spacing; waits until sent
+    NavigationResult navigateBurst(int tabCount, uint8_t key = KEY_TAB);
+    NavigationResult getLastNavigation() const { return lastNavigation; }
     void simulateTabDelay();
+    // Source of the human tab delays; HumanSimulator passes its own so
+    // one seed covers the whole session
+    void setRandom(Utils::Random& source) { rng = &source; }
     
     // Speed control
     void setBaseSpeed(float wpm);
     void adjustSpeed(float multiplier);
     
-    // Statistics
+    // Statistics. One consistent snapshot, safe to call from any task.
     TypingStats getTypingStats() const;
     void resetStats();
 
 private:
-    BleKeyboard bleKeyboard{"PRO X TSL", "Logitech", 100};
-    TypingStats stats;
+    using ReportWriter = Hid::ReportWriter<Transport, typename Transport::Report>;
+
+    Transport transport;
+    ReportWriter reports{transport};   // Raw reports from Hid::KeyMap
+    // Records every typed character in the stats as it is sent
+    struct StatsSink {
+        BasicKeyboard& keyboard;
+        bool isConnected() { return keyboard.reports.isConnected(); }
+        size_t write(uint8_t key);
+        size_t press(uint8_t key) { return keyboard.reports.press(key); }
+        size_t release(uint8_t key) { return keyboard.reports.release(key); }
+        void releaseAll() { keyboard.reports.releaseAll(); }
+    };
+
+    StatsSink statsSink{*this};
+    Hid::OutputQueue<StatsSink, Constants::Hid::OUTPUT_QUEUE_SIZE> output{statsSink};
+    TaskHandle_t outputTaskHandle = nullptr;
+    NavigationResult lastNavigation;
+    bool interrupted = false;   // Producer gave up on a stalled queue
+    bool cancelRequested = false;  // cancelPending() during a play or burst
+    uint32_t reportSpacingMicros = Constants::Hid::MIN_REPORT_SPACING_US;
+    KeystrokeStats stats{Constants::Typing::STATS_EWMA_ALPHA};  // Output task only
+    Utils::Seqlock<TypingStats> publishedStats;
+    std::atomic<bool> statsResetRequested{false};
     float currentSpeedMultiplier = 1.0f;
     float baseWPM = Constants::Typing::BASE_WPM;
-    unsigned long lastTypeTime = 0;
+    Utils::Random ownRandom;
+    Utils::Random* rng = &ownRandom;
+
+    // Feeds VM output into the queue
+    struct ProgramSink {
+        BasicKeyboard& keyboard;
+        void key(uint8_t k, uint16_t gap);
+        void press(uint8_t k, uint16_t gap);
+        void release(uint8_t k, uint16_t gap);
+        void releaseAll(uint16_t gap);
+        void checkpoint(uint32_t id);
+    };
 
-    void updateStats(char c);
+    uint32_t enqueue(Hid::KeyEvent::Action action, uint8_t key, uint32_t value = 0);
+    size_t typeChar(char c, float speedMultiplier);
+    uint32_t serviceOutput();   // One pass of the output loop, returns ms to sleep
+    static void outputTask(void* param);
+    static uint32_t scheduledOutput(void* param);
     int calculateDelay() const;
-};
\ No newline at end of file
+};
+
+using Keyboard = BasicKeyboard<DefaultTransport>;
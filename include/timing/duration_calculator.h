@@ -1,5 +1,6 @@
 #pragma once
 #include "analysis/text_parser.h"
+#include "analysis/task_analyzer.h"
 
 namespace Timing {
     struct DurationAnalysis {
@@ -20,10 +21,34 @@ namespace Timing {
 
     class DurationCalculator {
     public:
-        static DurationAnalysis analyze(const Analysis::TextParser::ParseResult& parseResult);
+        static DurationAnalysis analyze(const Analysis::TextParser::ParseResult& parseResult) {
+            return fromAnalysis(Analysis::TaskAnalyzer::analyze(parseResult));
+        }
+
         static bool validateTiming(const Analysis::TextParser::ParseResult& parseResult, 
-                                 String& errorMessage);
-    private:
-        // ... rest of the implementation
+                                 String& errorMessage) {
+            auto analysis = Analysis::TaskAnalyzer::analyze(parseResult);
+            if (!analysis.timingValid) errorMessage = analysis.timingError;
+            return analysis.timingValid;
+        }
+
+        // Converts the fused analysis result, for callers that already ran it
+        static DurationAnalysis fromAnalysis(const Analysis::TaskAnalysis& analysis) {
+            DurationAnalysis result;
+            result.totalMillis = analysis.duration.totalMillis;
+            result.effectiveMillis = analysis.duration.effectiveMillis;
+            result.overlapMillis = analysis.duration.overlapMillis;
+            result.gapMillis = analysis.duration.gapMillis;
+            result.typingMillis = analysis.typingMillis;
+            result.utilizationPercent = analysis.duration.utilizationPercent;
+
+            for (const auto& gap : analysis.duration.gaps) {
+                result.gaps.push_back({gap.startMillis, gap.endMillis});
+            }
+            for (const auto& overlap : analysis.duration.overlaps) {
+                result.overlaps.push_back({overlap.startMillis, overlap.endMillis});
+            }
+            return result;
+        }
     };
-}
\ No newline at end of file
+}
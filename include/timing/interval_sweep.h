@@ -0,0 +1,134 @@
+#pragma once
+#include <Arduino.h>
+#include <algorithm>
+
+namespace Timing {
+    // Caller-owned start/end arrays for IntervalSweep. The sweep sorts them
+    // in place and never allocates.
+    struct SweepScratch {
+        uint32_t* starts = nullptr;
+        uint32_t* ends = nullptr;
+        size_t capacity = 0;
+        size_t count = 0;
+
+        bool add(uint32_t startMillis, uint32_t endMillis) {
+            if (count >= capacity) return false;
+            starts[count] = startMillis;
+            ends[count] = endMillis;
+            count++;
+            return true;
+        }
+
+        void clear() { count = 0; }
+        bool isFull() const { return count >= capacity; }
+    };
+
+    template<size_t Capacity>
+    struct SweepBuffer {
+        uint32_t starts[Capacity];
+        uint32_t ends[Capacity];
+
+        SweepScratch scratch() {
+            SweepScratch s;
+            s.starts = starts;
+            s.ends = ends;
+            s.capacity = Capacity;
+            return s;
+        }
+    };
+
+    // Sweep line over a set of intervals: coverage, gaps between intervals
+    // and regions where two or more overlap. Start and end streams are
+    // sorted separately (cheaply when already in order) and merged.
+    class IntervalSweep {
+    public:
+        struct Totals {
+            uint32_t coveredMillis = 0;   // Time with at least one interval
+            uint32_t overlapMillis = 0;   // Time with two or more
+            uint32_t gapMillis = 0;       // Uncovered time between intervals
+            size_t gapCount = 0;
+            size_t overlapCount = 0;
+        };
+
+        // Visitor is called with onGap(start, end) and onOverlap(start, end)
+        template<typename Visitor>
+        static Totals run(SweepScratch& scratch, Visitor& visitor) {
+            Totals totals;
+            size_t n = scratch.count;
+            if (n == 0) return totals;
+
+            sortNearlySorted(scratch.starts, n);
+            sortNearlySorted(scratch.ends, n);
+
+            const uint32_t* starts = scratch.starts;
+            const uint32_t* ends = scratch.ends;
+            size_t si = 0;
+            size_t ei = 0;
+            int active = 0;
+            uint32_t lastTime = starts[0];
+            uint32_t overlapStart = 0;
+            uint32_t gapStart = 0;
+            bool inGap = false;
+
+            while (ei < n) {
+                // Ends sort before starts at the same instant, unless nothing
+                // is open yet (zero-length intervals)
+                bool isStart = si < n && (active == 0 || starts[si] < ends[ei]);
+                uint32_t now = isStart ? starts[si] : ends[ei];
+
+                uint32_t elapsed = now - lastTime;
+                if (active > 0) totals.coveredMillis += elapsed;
+                if (active > 1) totals.overlapMillis += elapsed;
+
+                if (isStart) {
+                    if (inGap && now > gapStart) {
+                        visitor.onGap(gapStart, now);
+                        totals.gapMillis += now - gapStart;
+                        totals.gapCount++;
+                    }
+                    inGap = false;
+                    if (++active == 2) overlapStart = now;
+                    si++;
+                } else {
+                    if (active-- == 2 && now > overlapStart) {
+                        visitor.onOverlap(overlapStart, now);
+                        totals.overlapCount++;
+                    }
+                    if (active == 0) {
+                        inGap = true;
+                        gapStart = now;
+                    }
+                    ei++;
+                }
+
+                lastTime = now;
+            }
+
+            return totals;
+        }
+
+        // Insertion sort while every value lands within MAX_DISPLACEMENT
+        // places of where it is (a few timeframes listed late); the place
+        // is found by binary search over the sorted prefix before anything
+        // moves. The first value that is further off hands the whole array
+        // to in-place std::sort, so a rotated or shuffled array costs
+        // O(n log n), never insertion sort's O(n^2).
+        static void sortNearlySorted(uint32_t* values, size_t count) {
+            for (size_t i = 1; i < count; i++) {
+                uint32_t value = values[i];
+                if (value >= values[i - 1]) continue;
+
+                uint32_t* slot = std::upper_bound(values, values + i, value);
+                if ((size_t)(values + i - slot) > MAX_DISPLACEMENT) {
+                    std::sort(values, values + count);
+                    return;
+                }
+                std::copy_backward(slot, values + i, values + i + 1);
+                *slot = value;
+            }
+        }
+
+    private:
+        static constexpr size_t MAX_DISPLACEMENT = 32;
+    };
+}
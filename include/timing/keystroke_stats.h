@@ -0,0 +1,120 @@
+#pragma once
+#include <Arduino.h>
+
+namespace Timing {
+    // Typing statistics over the last Window keystrokes. record() is O(1):
+    // a ring of timestamps gives the windowed rate, an EWMA of the
+    // inter-key interval gives a smoothed rate, and a log-scale histogram
+    // of the intervals in the window gives percentiles (within 12.5%).
+    // snapshot() walks the histogram's 64 bins once.
+    template<size_t Window>
+    class KeystrokeStats {
+        static_assert(Window >= 2, "Need at least one interval in the window");
+
+    public:
+        struct Snapshot {
+            uint32_t charactersTyped = 0;
+            uint32_t wordsTyped = 0;
+            float charsPerSecond = 0;     // Over the window
+            float currentWPM = 0;         // Over the window
+            float smoothedWPM = 0;        // From the EWMA interval
+            float averageWPM = 0;         // Since the first keystroke
+            uint32_t p50IntervalMillis = 0;
+            uint32_t p95IntervalMillis = 0;
+        };
+
+        explicit KeystrokeStats(float ewmaAlpha = 0.1f) : alpha(ewmaAlpha) {}
+
+        void record(char c, uint32_t now) {
+            if (charactersTyped == 0) {
+                firstTime = now;
+            } else {
+                uint32_t interval = now - times[newest()];
+                ewmaInterval = intervalCount == 0 ? interval
+                             : ewmaInterval + alpha * (interval - ewmaInterval);
+                if (intervalCount == Window) {
+                    // Oldest interval leaves the window with its timestamp
+                    histogram[bin(times[(head + 1) % SLOTS] - times[head])]--;
+                    head = (head + 1) % SLOTS;
+                    intervalCount--;
+                }
+                histogram[bin(interval)]++;
+                intervalCount++;
+            }
+
+            times[(head + intervalCount) % SLOTS] = now;
+            charactersTyped++;
+            if (c == ' ' || c == '\n') wordsTyped++;
+        }
+
+        Snapshot snapshot() const {
+            Snapshot s;
+            s.charactersTyped = charactersTyped;
+            s.wordsTyped = wordsTyped;
+            if (intervalCount == 0) return s;
+
+            uint32_t span = times[newest()] - times[head];
+            if (span > 0) {
+                s.charsPerSecond = intervalCount * 1000.0f / span;
+                s.currentWPM = s.charsPerSecond * 60.0f / CHARS_PER_WORD;
+            }
+            if (ewmaInterval > 0) s.smoothedWPM = 60000.0f / CHARS_PER_WORD / ewmaInterval;
+
+            uint32_t elapsed = times[newest()] - firstTime;
+            if (elapsed > 0) {
+                s.averageWPM = (charactersTyped - 1) * 60000.0f / CHARS_PER_WORD / elapsed;
+            }
+
+            s.p50IntervalMillis = percentile(50);
+            s.p95IntervalMillis = percentile(95);
+            return s;
+        }
+
+        void reset() { *this = KeystrokeStats(alpha); }
+
+        // Histogram bins: exact below 8 ms, then four per power of two
+        static constexpr size_t BINS = 64;
+
+        static uint8_t bin(uint32_t millis) {
+            if (millis < 8) return millis;
+            int msb = 31 - __builtin_clz(millis);
+            uint32_t sub = (millis >> (msb - 2)) & 3;
+            return min<uint32_t>(4 * (msb - 1) + sub, BINS - 1);
+        }
+
+        // Middle of a bin's range
+        static uint32_t binValue(uint8_t b) {
+            if (b < 8) return b;
+            int msb = b / 4 + 1;
+            uint32_t width = 1u << (msb - 2);
+            return ((4 + b % 4) << (msb - 2)) + (width - 1) / 2;
+        }
+
+    private:
+        static constexpr size_t SLOTS = Window + 1;   // Window intervals need one more timestamp
+        static constexpr float CHARS_PER_WORD = 5.0f;
+
+        float alpha;
+        uint32_t times[SLOTS] = {};
+        size_t head = 0;              // Oldest timestamp in the window
+        size_t intervalCount = 0;
+        uint16_t histogram[BINS] = {};
+        float ewmaInterval = 0;
+        uint32_t firstTime = 0;
+        uint32_t charactersTyped = 0;
+        uint32_t wordsTyped = 0;
+
+        size_t newest() const { return (head + intervalCount) % SLOTS; }
+
+        uint32_t percentile(uint32_t p) const {
+            // Smallest bin holding at least p% of the intervals
+            uint32_t rank = (intervalCount * p + 99) / 100;
+            uint32_t seen = 0;
+            for (size_t b = 0; b < BINS; b++) {
+                seen += histogram[b];
+                if (seen >= rank) return binValue(b);
+            }
+            return binValue(BINS - 1);
+        }
+    };
+}
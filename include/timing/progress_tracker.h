@@ -11,6 +11,10 @@ namespace Timing {
         uint32_t estimatedRemaining = 0;   // Estimated time to completion
         float currentSpeed = 0.0f;         // Current WPM
 
+        // What is being typed, as set by the caller
+        int clipNumber = 0;                // 0 before the first clip
+        int timeframe = 0;                 // 0 main description, n the clip's nth timeframe
+
         // Component Progress
         struct {
             float typing = 0.0f;           // % of typing complete
@@ -40,7 +44,16 @@ namespace Timing {
             , startTime(0)
             , lastPauseTime(0)
             , totalPausedTime(0)
-            , isRunning(false) {
+            , isRunning(false)
+            , clipNumber(0)
+            , timeframe(0) {
+        }
+
+        // The clip and timeframe whose text is going out now. Elapsed time
+        // says nothing about this: typing runs far longer than the video.
+        void setPosition(int clip, int frame) {
+            clipNumber = clip;
+            timeframe = frame;
         }
 
         void start() {
@@ -94,6 +107,8 @@ namespace Timing {
 
             calculateElapsedTime(snapshot);
             calculateProgress(snapshot);
+            snapshot.clipNumber = clipNumber;
+            snapshot.timeframe = timeframe;
             calculateCompliance(snapshot);
             calculateETA(snapshot);
             updateStatusFlags(snapshot);
@@ -117,6 +132,8 @@ namespace Timing {
         uint32_t lastPauseTime;
         uint32_t totalPausedTime;
         bool isRunning;
+        int clipNumber;
+        int timeframe;
 
         void calculateElapsedTime(ProgressSnapshot& snapshot) const {
             uint32_t currentTime = millis();
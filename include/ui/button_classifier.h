@@ -0,0 +1,131 @@
+#pragma once
+#include <Arduino.h>
+#include "constants.h"
+
+namespace Ui {
+    enum class ButtonEvent : uint8_t {
+        NONE,
+        SINGLE_PRESS,
+        DOUBLE_PRESS,
+        LONG_PRESS,
+        TRIPLE_PRESS
+    };
+
+    // One level change of the button, stamped when it happened (by the
+    // GPIO interrupt), not when it was looked at
+    struct ButtonEdge {
+        uint32_t millis;
+        bool pressed;
+    };
+
+    // Turns timestamped edges into press events. Debouncing is a lockout:
+    // an edge within debounceMillis of the last accepted one is bounce, so
+    // a press registers on its first edge. Because timing comes from the
+    // edges, events do not depend on how often the caller looks.
+    //
+    //   long press    held for longPressMillis, reported while still held
+    //   triple press  on the third release
+    //   single/double multiPressWindowMillis after the last release with
+    //                 no further press
+    //
+    // Feed edges in order with edge(), call poll() periodically for the
+    // timers, and sync() with the pin level to recover from lost edges.
+    class ButtonClassifier {
+    public:
+        struct Timing {
+            uint32_t debounceMillis = Constants::Hardware::DEBOUNCE_DELAY;
+            uint32_t multiPressWindowMillis = Constants::Hardware::DOUBLE_PRESS_WINDOW;
+            uint32_t longPressMillis = Constants::Hardware::LONG_PRESS_DURATION;
+        };
+
+        static constexpr uint8_t MAX_PRESSES = 3;
+
+        ButtonClassifier() = default;
+        explicit ButtonClassifier(const Timing& timing) : timing(timing) {}
+
+        // Returns the event of a sequence this edge completes or that timed
+        // out before it; at most one per edge
+        ButtonEvent edge(const ButtonEdge& e) {
+            // Same level again: a lost edge or noise
+            if (e.pressed == down) return ButtonEvent::NONE;
+            if (hasEdge && e.millis - lastEdge < timing.debounceMillis) return ButtonEvent::NONE;
+
+            ButtonEvent event = poll(e.millis);
+            lastEdge = e.millis;
+            hasEdge = true;
+            down = e.pressed;
+
+            if (e.pressed) {
+                presses = state == State::RELEASED ? presses + 1 : 1;
+                pressedAt = e.millis;
+                state = State::PRESSED;
+            } else if (state == State::HELD) {
+                state = State::IDLE;            // Long press already reported
+            } else if (state == State::PRESSED) {
+                if (presses >= MAX_PRESSES) {
+                    state = State::IDLE;
+                    return ButtonEvent::TRIPLE_PRESS;
+                }
+                releasedAt = e.millis;
+                state = State::RELEASED;
+            }
+            return event;
+        }
+
+        // Fires the long-press and multi-press timers due by now
+        ButtonEvent poll(uint32_t now) {
+            switch (state) {
+                case State::PRESSED:
+                    if (now - pressedAt >= timing.longPressMillis) {
+                        state = State::HELD;
+                        return ButtonEvent::LONG_PRESS;
+                    }
+                    break;
+                case State::RELEASED:
+                    if (now - releasedAt > timing.multiPressWindowMillis) {
+                        state = State::IDLE;
+                        return presses == 1 ? ButtonEvent::SINGLE_PRESS : ButtonEvent::DOUBLE_PRESS;
+                    }
+                    break;
+                default:
+                    break;
+            }
+            return ButtonEvent::NONE;
+        }
+
+        // The pin disagrees with the last edge and has for the debounce
+        // time: take it as an edge that was missed (queue full, or a
+        // release inside the lockout)
+        ButtonEvent sync(bool pressedNow, uint32_t now) {
+            if (pressedNow == down) return ButtonEvent::NONE;
+            if (hasEdge && now - lastEdge < timing.debounceMillis) return ButtonEvent::NONE;
+            return edge({now, pressedNow});
+        }
+
+        bool isDown() const { return down; }
+
+        // Presses of the sequence still waiting for its event; 0 when
+        // idle or once a long press was reported. Becomes 1 on the first
+        // press edge, a window before SINGLE_PRESS or DOUBLE_PRESS.
+        uint8_t pendingPresses() const {
+            return state == State::PRESSED || state == State::RELEASED ? presses : 0;
+        }
+
+    private:
+        enum class State : uint8_t {
+            IDLE,
+            PRESSED,      // Down, long-press timer running
+            HELD,         // Down, long press reported
+            RELEASED      // Up, waiting for another press
+        };
+
+        Timing timing;
+        State state = State::IDLE;
+        bool down = false;
+        bool hasEdge = false;
+        uint8_t presses = 0;
+        uint32_t lastEdge = 0;
+        uint32_t pressedAt = 0;
+        uint32_t releasedAt = 0;
+    };
+}
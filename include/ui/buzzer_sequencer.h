@@ -0,0 +1,94 @@
+#pragma once
+#include <Arduino.h>
+#include <atomic>
+
+namespace Ui {
+    struct Tone {
+        uint16_t hz;        // 0 = rest
+        uint16_t millis;
+    };
+
+    struct SoundPattern {
+        const Tone* tones;
+        uint8_t length;
+    };
+
+    // Buzzer on an LEDC PWM channel (Arduino-ESP32 2.x API): a tone is a
+    // square wave at 50% duty, silence is duty 0
+    class LedcBuzzer {
+    public:
+        LedcBuzzer(uint8_t pin, uint8_t channel) : pin(pin), channel(channel) {}
+
+        void begin() {
+            ledcSetup(channel, 2000, 10);
+            ledcAttachPin(pin, channel);
+            ledcWrite(channel, 0);
+        }
+
+        void tone(uint16_t hz) { ledcWriteTone(channel, hz); }
+
+    private:
+        uint8_t pin;
+        uint8_t channel;
+    };
+
+    // Plays SoundPatterns on Driver (anything with tone(hz), 0 = off)
+    // without blocking anyone. play() only posts the pattern and may be
+    // called from any task; advance(now), called from a single timer
+    // context, starts it and steps through the tones, and returns how
+    // long until it needs to run again. Tone boundaries are kept on the
+    // pattern's own timeline, so a late call does not stretch the rest.
+    template<typename Driver>
+    class BuzzerSequencer {
+    public:
+        static constexpr uint32_t IDLE = UINT32_MAX;
+        static constexpr SoundPattern SILENCE = {nullptr, 0};
+
+        explicit BuzzerSequencer(Driver& driver) : driver(driver) {}
+
+        // Replaces whatever is playing once the timer next runs
+        void play(const SoundPattern& pattern) {
+            pending.store(&pattern, std::memory_order_release);
+        }
+
+        // Timer side
+        uint32_t advance(uint32_t now) {
+            const SoundPattern* next = pending.exchange(nullptr, std::memory_order_acq_rel);
+            if (next) {
+                pattern = next;
+                index = 0;
+                toneStart = now;
+                if (pattern->length > 0) driver.tone(pattern->tones[0].hz);
+            }
+            if (!pattern) return IDLE;
+
+            while (index < pattern->length && now - toneStart >= pattern->tones[index].millis) {
+                toneStart += pattern->tones[index].millis;
+                if (++index < pattern->length) driver.tone(pattern->tones[index].hz);
+            }
+            if (index >= pattern->length) {
+                driver.tone(0);
+                pattern = nullptr;
+                playing.store(false, std::memory_order_release);
+                return IDLE;
+            }
+            playing.store(true, std::memory_order_release);
+            return pattern->tones[index].millis - (now - toneStart);
+        }
+
+        bool isPlaying() const {
+            return playing.load(std::memory_order_acquire) ||
+                   pending.load(std::memory_order_acquire) != nullptr;
+        }
+
+    private:
+        Driver& driver;
+        std::atomic<const SoundPattern*> pending{nullptr};
+        std::atomic<bool> playing{false};
+
+        // Timer-owned
+        const SoundPattern* pattern = nullptr;
+        uint8_t index = 0;
+        uint32_t toneStart = 0;
+    };
+}
@@ -0,0 +1,201 @@
+#pragma once
+#include <Arduino.h>
+#include <atomic>
+#include "constants.h"
+#ifdef ARDUINO
+#include <driver/ledc.h>
+#endif
+
+namespace Ui {
+    // A keyframe: fade both LEDs to these levels (0-255, perceptual) over
+    // fadeMillis, then hold for holdMillis
+    struct LedFrame {
+        uint8_t red;
+        uint8_t blue;
+        uint16_t fadeMillis;
+        uint16_t holdMillis;
+    };
+
+    struct LedPattern {
+        const LedFrame* frames;
+        uint8_t length;
+        bool repeat;        // Loop forever, else hold the last frame
+    };
+
+    enum LedIndex : uint8_t { LED_RED, LED_BLUE, LED_COUNT };
+
+    // Perceptual level to 12-bit duty, gamma 2.2; non-zero levels stay lit
+    constexpr uint16_t GAMMA[256] = {
+           0,    1,    1,    1,    1,    1,    1,    2,    2,    3,    3,    4,    5,    6,    7,    8,
+           9,   11,   12,   14,   15,   17,   19,   21,   23,   25,   27,   29,   32,   34,   37,   40,
+          43,   46,   49,   52,   55,   59,   62,   66,   70,   73,   77,   82,   86,   90,   95,   99,
+         104,  109,  114,  119,  124,  129,  135,  140,  146,  152,  158,  164,  170,  176,  182,  189,
+         196,  202,  209,  216,  224,  231,  238,  246,  254,  261,  269,  277,  286,  294,  302,  311,
+         320,  328,  337,  347,  356,  365,  375,  384,  394,  404,  414,  424,  435,  445,  456,  467,
+         477,  488,  500,  511,  522,  534,  545,  557,  569,  581,  594,  606,  619,  631,  644,  657,
+         670,  683,  697,  710,  724,  738,  752,  766,  780,  794,  809,  823,  838,  853,  868,  884,
+         899,  914,  930,  946,  962,  978,  994, 1011, 1027, 1044, 1061, 1078, 1095, 1112, 1130, 1147,
+        1165, 1183, 1201, 1219, 1237, 1256, 1274, 1293, 1312, 1331, 1350, 1370, 1389, 1409, 1429, 1449,
+        1469, 1489, 1509, 1530, 1551, 1572, 1593, 1614, 1635, 1657, 1678, 1700, 1722, 1744, 1766, 1789,
+        1811, 1834, 1857, 1880, 1903, 1926, 1950, 1974, 1997, 2021, 2045, 2070, 2094, 2119, 2143, 2168,
+        2193, 2219, 2244, 2270, 2295, 2321, 2347, 2373, 2400, 2426, 2453, 2479, 2506, 2534, 2561, 2588,
+        2616, 2644, 2671, 2700, 2728, 2756, 2785, 2813, 2842, 2871, 2900, 2930, 2959, 2989, 3019, 3049,
+        3079, 3109, 3140, 3170, 3201, 3232, 3263, 3295, 3326, 3358, 3390, 3421, 3454, 3486, 3518, 3551,
+        3584, 3617, 3650, 3683, 3716, 3750, 3784, 3818, 3852, 3886, 3920, 3955, 3990, 4025, 4060, 4095,
+    };
+
+    // LEDs on LEDC channels (Arduino-ESP32 2.x setup, ESP-IDF fades). The
+    // fade runs in the LEDC peripheral, so the LED keeps moving smoothly
+    // whatever the CPU is doing. On the host the target duty is written
+    // at once.
+    class LedcLeds {
+    public:
+        LedcLeds(uint8_t redPin, uint8_t redChannel, uint8_t bluePin, uint8_t blueChannel)
+            : pins{redPin, bluePin}, channels{redChannel, blueChannel} {}
+
+        void begin() {
+            for (uint8_t i = 0; i < LED_COUNT; i++) {
+                ledcSetup(channels[i], Constants::Hardware::LED_PWM_FREQ,
+                          Constants::Hardware::LED_PWM_BITS);
+                ledcAttachPin(pins[i], channels[i]);
+                ledcWrite(channels[i], duty(0));
+            }
+#ifdef ARDUINO
+            ledc_fade_func_install(0);
+#endif
+        }
+
+        void fade(uint8_t led, uint8_t level, uint16_t millis) {
+            uint32_t target = duty(level);
+#ifdef ARDUINO
+            // The S3 has only low-speed channels; Arduino channel n is
+            // IDF channel n there
+            ledc_channel_t channel = (ledc_channel_t)channels[led];
+            if (millis == 0) {
+                ledc_set_duty(LEDC_LOW_SPEED_MODE, channel, target);
+                ledc_update_duty(LEDC_LOW_SPEED_MODE, channel);
+            } else {
+                ledc_set_fade_with_time(LEDC_LOW_SPEED_MODE, channel, target, millis);
+                ledc_fade_start(LEDC_LOW_SPEED_MODE, channel, LEDC_FADE_NO_WAIT);
+            }
+#else
+            ledcWrite(channels[led], target);
+#endif
+        }
+
+    private:
+        uint8_t pins[LED_COUNT];
+        uint8_t channels[LED_COUNT];
+
+        static uint32_t duty(uint8_t level) {
+            static_assert(Constants::Hardware::LED_PWM_BITS == 12, "GAMMA is for 12-bit duty");
+            uint32_t on = GAMMA[level];
+            return Constants::Hardware::LED_ACTIVE_LOW ? 4095 - on : on;
+        }
+    };
+
+    // Plays LedPatterns on Driver (anything with fade(led, level, millis))
+    // the way BuzzerSequencer plays sounds: play() and show() only post,
+    // advance(now) runs from a single timer context at keyframe
+    // boundaries and returns how long until the next one. Fades happen in
+    // the driver, so nothing runs between keyframes. Boundaries stay on
+    // the pattern's own timeline, and a timer that falls whole cycles
+    // behind skips them instead of replaying.
+    //
+    // The levels of the current keyframe are shadowed here, so reading
+    // the LED state back never touches the pins.
+    template<typename Driver>
+    class LedAnimator {
+    public:
+        static constexpr uint32_t IDLE = UINT32_MAX;
+
+        explicit LedAnimator(Driver& driver) : driver(driver) {
+            for (uint8_t i = 0; i < 2; i++) levelPatterns[i] = {&levelFrames[i], 1, false};
+        }
+
+        void play(const LedPattern& pattern) {
+            pending.store(&pattern, std::memory_order_release);
+        }
+
+        // Fades to fixed levels. Alternates between two frames so the one
+        // the timer may be reading is not rewritten; a third call before
+        // the timer runs can still show a mixed frame for one keyframe.
+        void show(uint8_t red, uint8_t blue, uint16_t fadeMillis) {
+            levelSlot ^= 1;
+            levelFrames[levelSlot] = {red, blue, fadeMillis, 0};
+            play(levelPatterns[levelSlot]);
+        }
+
+        // Timer side
+        uint32_t advance(uint32_t now) {
+            const LedPattern* next = pending.exchange(nullptr, std::memory_order_acq_rel);
+            if (next) {
+                pattern = next->length > 0 ? next : nullptr;
+                index = 0;
+                frameStart = now;
+                if (pattern) startFrame();
+            }
+            if (!pattern) return IDLE;
+
+            uint32_t elapsed = now - frameStart;
+            if (elapsed < frameLength(index)) return frameLength(index) - elapsed;
+
+            while (now - frameStart >= frameLength(index)) {
+                frameStart += frameLength(index);
+                if (++index < pattern->length) continue;
+                if (!pattern->repeat || cycleLength() == 0) {
+                    // Last frame's levels stay; land on them if a late
+                    // call skipped past
+                    index = pattern->length - 1;
+                    if (shown != index) startFrame();
+                    pattern = nullptr;
+                    return IDLE;
+                }
+                index = 0;
+                uint32_t cycle = cycleLength();
+                frameStart += (now - frameStart) / cycle * cycle;
+            }
+            startFrame();
+            return frameLength(index) - (now - frameStart);
+        }
+
+        uint8_t level(uint8_t led) const {
+            return levels[led].load(std::memory_order_relaxed);
+        }
+
+    private:
+        Driver& driver;
+        std::atomic<const LedPattern*> pending{nullptr};
+        std::atomic<uint8_t> levels[LED_COUNT] = {};
+
+        // show() buffers, UI side
+        LedFrame levelFrames[2] = {};
+        LedPattern levelPatterns[2];
+        uint8_t levelSlot = 0;
+
+        // Timer-owned
+        const LedPattern* pattern = nullptr;
+        uint8_t index = 0;
+        uint8_t shown = 0;          // Frame last sent to the driver
+        uint32_t frameStart = 0;
+
+        uint32_t frameLength(uint8_t i) const {
+            return (uint32_t)pattern->frames[i].fadeMillis + pattern->frames[i].holdMillis;
+        }
+
+        uint32_t cycleLength() const {
+            uint32_t total = 0;
+            for (uint8_t i = 0; i < pattern->length; i++) total += frameLength(i);
+            return total;
+        }
+
+        void startFrame() {
+            const LedFrame& frame = pattern->frames[index];
+            shown = index;
+            driver.fade(LED_RED, frame.red, frame.fadeMillis);
+            driver.fade(LED_BLUE, frame.blue, frame.fadeMillis);
+            levels[LED_RED].store(frame.red, std::memory_order_relaxed);
+            levels[LED_BLUE].store(frame.blue, std::memory_order_relaxed);
+        }
+    };
+}
@@ -0,0 +1,47 @@
+#pragma once
+#include <Arduino.h>
+#include "constants.h"
+#include "hardware.h"
+#include "ui/ui_link.h"
+
+namespace Ui {
+    // The UI side of the split: owns the Hardware (button, LEDs, buzzer)
+    // and the serial state line. Button events go to the engine as
+    // commands; LEDs and sounds follow the engine's status messages. A
+    // triple press dumps the event trace (utils/trace.h) to serial.
+    // Nothing here waits on the engine, so a beep or an LED frame never
+    // holds up typing and a busy engine never delays the button.
+    class Panel {
+    public:
+        // Who runs service(): a FreeRTOS task on Constants::Ui::TASK_CORE,
+        // or the main loop's Utils::Scheduler (host, single thread)
+        enum class Mode {
+            TASK,
+            SCHEDULER
+        };
+
+        Panel(Hardware& hardware, Link& link) : hardware(hardware), link(link) {}
+
+        // Hardware belongs to the panel from here on
+        void begin(Mode mode = Mode::TASK);
+
+        // One pass: button, engine messages, LED frame. Returns ms to sleep.
+        uint32_t service();
+
+    private:
+        Hardware& hardware;
+        Link& link;
+        Status state;                // Last STATE from the engine
+        unsigned long lastReport = 0;
+        bool earlyPause = false;     // PAUSE sent on the first press of a sequence
+
+        void handleButton();
+        void undoEarlyPause(bool pausedEarly);
+        void apply(const Status& status);
+        void showState();
+        void report();
+
+        static void task(void* param);
+        static uint32_t scheduled(void* param);
+    };
+}
@@ -0,0 +1,114 @@
+#pragma once
+#include <Arduino.h>
+#include "constants.h"
+#include "timing/progress_tracker.h"
+#include "utils/spsc_queue.h"
+
+namespace Ui {
+    // UI -> engine
+    struct Command {
+        enum class Type : uint8_t {
+            PAUSE,
+            RESUME,
+            SKIP,      // Toggle the section-complete hold
+            RESET      // Paused, hold cleared
+        };
+
+        Type type;
+        uint32_t sentMicros;   // For the send-to-handled latency
+    };
+
+    // Engine -> UI. One message type, tagged; only the fields of its
+    // type are meaningful.
+    struct Status {
+        enum class Type : uint8_t {
+            STATE,              // Engine state changed, or heartbeat
+            PROGRESS,
+            SECTION_COMPLETE,
+            ERROR
+        };
+
+        Type type = Type::STATE;
+
+        // STATE
+        bool connected = false;
+        bool paused = true;
+        bool sectionComplete = false;
+        bool finished = false;
+        int clip = 0;
+        uint32_t maxCommandMicros = 0;   // Worst send-to-handled time so far
+
+        // PROGRESS
+        Timing::ProgressSnapshot progress;
+
+        // ERROR, a string literal
+        const char* message = nullptr;
+    };
+
+    // The two queues between the typing engine (loop task, core 1) and
+    // the UI task (core 0). Each has exactly one producer and one
+    // consumer, so neither core ever blocks on the other: a full queue
+    // drops the message and counts it. Methods are marked with the side
+    // that may call them.
+    class Link {
+    public:
+        // UI side
+        bool send(Command::Type type) {
+            Command command = {type, (uint32_t)micros()};
+            if (commands.push(command)) return true;
+            droppedCommands++;
+            return false;
+        }
+
+        bool nextStatus(Status& status) { return statuses.pop(status); }
+        uint32_t getDroppedCommands() const { return droppedCommands; }
+
+        // Engine side
+        bool nextCommand(Command& command) {
+            if (!commands.pop(command)) return false;
+            uint32_t latency = (uint32_t)micros() - command.sentMicros;
+            if (latency > maxCommandMicros) maxCommandMicros = latency;
+            return true;
+        }
+
+        bool publish(const Status& status) {
+            if (statuses.push(status)) return true;
+            droppedStatus++;
+            return false;
+        }
+
+        // Progress is only a display hint: rate limited, lossy
+        void publishProgress(const Timing::ProgressSnapshot& progress) {
+            uint32_t now = millis();
+            if (progressSent && now - lastProgressMillis < Constants::Ui::PROGRESS_INTERVAL) return;
+            Status status;
+            status.type = Status::Type::PROGRESS;
+            status.progress = progress;
+            progressSent = publish(status);
+            lastProgressMillis = now;
+        }
+
+        void publishEvent(Status::Type type, const char* message = nullptr) {
+            Status status;
+            status.type = type;
+            status.message = message;
+            publish(status);
+        }
+
+        uint32_t getMaxCommandMicros() const { return maxCommandMicros; }
+        uint32_t getDroppedStatus() const { return droppedStatus; }
+
+    private:
+        Utils::SpscQueue<Command, Constants::Ui::COMMAND_QUEUE> commands;
+        Utils::SpscQueue<Status, Constants::Ui::STATUS_QUEUE> statuses;
+
+        // UI-owned
+        uint32_t droppedCommands = 0;
+
+        // Engine-owned
+        uint32_t maxCommandMicros = 0;
+        uint32_t droppedStatus = 0;
+        uint32_t lastProgressMillis = 0;
+        bool progressSent = false;
+    };
+}
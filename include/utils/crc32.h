@@ -0,0 +1,29 @@
+#pragma once
+#include <Arduino.h>
+
+namespace Utils {
+    // CRC-32 (IEEE 802.3, the one zlib and `crc32` compute), fed in pieces
+    // so a file can be checked through a small buffer. Four bits per step
+    // from a 16-entry table: 64 bytes of flash instead of 1 KB.
+    class Crc32 {
+    public:
+        void update(const uint8_t* data, size_t length) {
+            for (size_t i = 0; i < length; i++) {
+                crc = TABLE[(crc ^ data[i]) & 0x0F] ^ (crc >> 4);
+                crc = TABLE[(crc ^ (data[i] >> 4)) & 0x0F] ^ (crc >> 4);
+            }
+        }
+
+        uint32_t value() const { return ~crc; }
+
+    private:
+        static constexpr uint32_t TABLE[16] = {
+            0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC,
+            0x76DC4190, 0x6B6B51F4, 0x4DB26158, 0x5005713C,
+            0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C,
+            0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C
+        };
+
+        uint32_t crc = 0xFFFFFFFF;
+    };
+}
@@ -0,0 +1,309 @@
+#pragma once
+#include <Arduino.h>
+#include <atomic>
+#include <type_traits>
+#include "constants.h"
+#include "utils/scheduler.h"
+
+namespace Utils {
+    // Deferred logging. A LOG_* call does no formatting and never waits:
+    // it copies the format pointer and its arguments (strings included)
+    // into a fixed record and queues it; a low-priority task formats the
+    // records onto Serial later. A full queue drops the message and counts
+    // it, so logging cannot hold up the typing path. Levels above
+    // LOG_LEVEL (constants.h) compile to nothing, format strings included.
+    //
+    // Formats are printf's, checked at compile time; length modifiers are
+    // ignored and each argument is printed as the type it was logged with.
+    // One line per call, the newline is added. Not from interrupts.
+    class Logger {
+    public:
+        // Who runs the writer, as for Ui::Panel
+        enum class Mode {
+            TASK,
+            SCHEDULER
+        };
+
+        static constexpr size_t CAPACITY = Constants::Log::QUEUE;
+        static constexpr size_t MAX_ARGS = Constants::Log::MAX_ARGS;
+        static constexpr size_t PAYLOAD = Constants::Log::PAYLOAD;
+
+        static Logger& instance() {
+            static Logger logger;
+            return logger;
+        }
+
+        void begin(Mode mode = Mode::TASK) {
+            if (mode == Mode::SCHEDULER) {
+                Scheduler::instance().add("log", scheduled, this);
+                return;
+            }
+            xTaskCreatePinnedToCore(task, "log", Constants::Log::TASK_STACK, this,
+                                    Constants::Log::TASK_PRIORITY, nullptr,
+                                    Constants::Log::TASK_CORE);
+        }
+
+        // Any task. Arguments that do not fit the payload print as "?".
+        template<typename... Args>
+        void write(const char* format, Args... args) {
+            static_assert(sizeof...(Args) <= MAX_ARGS, "Too many log arguments");
+            uint32_t position;
+            Record* record = claim(position);
+            if (!record) return;
+            record->format = format;
+            record->count = 0;
+            [[maybe_unused]] size_t used = 0;
+            (put(*record, used, args), ...);
+            record->sequence.store(position + 1, std::memory_order_release);
+        }
+
+        // Writer side, one task only: formats the oldest record. False when
+        // the queue is empty.
+        bool formatNext(Print& out) {
+            uint32_t missed = dropped.exchange(0, std::memory_order_relaxed);
+            if (missed) out.printf("(%u log messages dropped)\n", (unsigned)missed);
+
+            Record& record = records[tail & MASK];
+            if (record.sequence.load(std::memory_order_acquire) != tail + 1) return false;
+            format(record, out);
+            record.sequence.store(tail + CAPACITY, std::memory_order_release);
+            tail++;
+            return true;
+        }
+
+        size_t drain(Print& out) {
+            size_t n = 0;
+            while (formatNext(out)) n++;
+            return n;
+        }
+
+        // printf's format check for the LOG_* macros; never called
+        static void check(const char*, ...) __attribute__((format(printf, 1, 2))) {}
+
+    private:
+        enum class Type : uint8_t {
+            INT,
+            UINT,
+            INT64,
+            UINT64,
+            DOUBLE,
+            STRING,         // Length byte, then the characters
+            MISSING         // Did not fit
+        };
+
+        struct Record {
+            std::atomic<uint32_t> sequence;
+            const char* format;
+            uint8_t count;
+            uint8_t types[MAX_ARGS];
+            uint8_t payload[PAYLOAD];
+        };
+
+        static constexpr uint32_t MASK = CAPACITY - 1;
+        static_assert((CAPACITY & MASK) == 0, "Log queue size must be a power of two");
+
+        // Bounded multi-producer queue: a slot is free for position p when
+        // its sequence is p, holds a record for the writer at p + 1
+        Record records[CAPACITY];
+        std::atomic<uint32_t> head{0};
+        std::atomic<uint32_t> dropped{0};
+        uint32_t tail = 0;
+
+        Logger() {
+            for (uint32_t i = 0; i < CAPACITY; i++) records[i].sequence.store(i, std::memory_order_relaxed);
+        }
+
+        Record* claim(uint32_t& position) {
+            position = head.load(std::memory_order_relaxed);
+            for (;;) {
+                Record& record = records[position & MASK];
+                int32_t diff = (int32_t)(record.sequence.load(std::memory_order_acquire) - position);
+                if (diff == 0) {
+                    if (head.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                        return &record;
+                    }
+                } else if (diff < 0) {
+                    dropped.fetch_add(1, std::memory_order_relaxed);
+                    return nullptr;
+                } else {
+                    position = head.load(std::memory_order_relaxed);
+                }
+            }
+        }
+
+        template<typename T>
+        static void put(Record& record, size_t& used, T value) {
+            uint8_t& type = record.types[record.count++];
+            if constexpr (std::is_same<T, const char*>::value || std::is_same<T, char*>::value) {
+                const char* text = value ? value : "(null)";
+                size_t length = strlen(text);
+                if (used + 1 >= PAYLOAD) {
+                    type = (uint8_t)Type::MISSING;
+                    return;
+                }
+                if (length > PAYLOAD - used - 1) length = PAYLOAD - used - 1;
+                if (length > 255) length = 255;
+                record.payload[used++] = length;
+                memcpy(record.payload + used, text, length);
+                used += length;
+                type = (uint8_t)Type::STRING;
+            } else if constexpr (std::is_floating_point<T>::value) {
+                store(record, used, type, Type::DOUBLE, (double)value);
+            } else if constexpr (std::is_enum<T>::value) {
+                store(record, used, type, Type::INT, (int32_t)value);
+            } else if constexpr (sizeof(T) > 4) {
+                if (std::is_signed<T>::value) store(record, used, type, Type::INT64, (int64_t)value);
+                else store(record, used, type, Type::UINT64, (uint64_t)value);
+            } else {
+                if (std::is_signed<T>::value) store(record, used, type, Type::INT, (int32_t)value);
+                else store(record, used, type, Type::UINT, (uint32_t)value);
+            }
+        }
+
+        template<typename V>
+        static void store(Record& record, size_t& used, uint8_t& type, Type as, V value) {
+            if (used + sizeof(V) > PAYLOAD) {
+                type = (uint8_t)Type::MISSING;
+                return;
+            }
+            memcpy(record.payload + used, &value, sizeof(V));
+            used += sizeof(V);
+            type = (uint8_t)as;
+        }
+
+        template<typename V>
+        static V load(const Record& record, size_t& offset) {
+            V value;
+            memcpy(&value, record.payload + offset, sizeof(V));
+            offset += sizeof(V);
+            return value;
+        }
+
+        // Walks the format and prints each conversion with its stored
+        // argument, widened to long long or double
+        static void format(const Record& record, Print& out) {
+            const char* p = record.format;
+            size_t offset = 0;
+            uint8_t arg = 0;
+            while (*p) {
+                const char* percent = strchr(p, '%');
+                if (!percent) {
+                    out.print(p);
+                    break;
+                }
+                out.write(reinterpret_cast<const uint8_t*>(p), percent - p);
+                p = percent + 1;
+                if (*p == '%') {
+                    out.print('%');
+                    p++;
+                    continue;
+                }
+
+                // %[flags][width][.precision][length]conversion
+                char spec[16] = "%";
+                size_t n = 1;
+                while (*p && strchr("-+ #0123456789.", *p) && n < sizeof(spec) - 4) spec[n++] = *p++;
+                while (*p && strchr("hlLqjzt", *p)) p++;
+                char conversion = *p;
+                if (!conversion) break;
+                p++;
+
+                Type type = arg < record.count ? (Type)record.types[arg] : Type::MISSING;
+                arg++;
+                if (type == Type::MISSING) {
+                    out.print('?');
+                    continue;
+                }
+                long long integer = 0;
+                double real = 0;
+                char text[PAYLOAD + 1];
+                switch (type) {
+                    case Type::INT: integer = load<int32_t>(record, offset); break;
+                    case Type::UINT: integer = load<uint32_t>(record, offset); break;
+                    case Type::INT64: integer = load<int64_t>(record, offset); break;
+                    case Type::UINT64: integer = (long long)load<uint64_t>(record, offset); break;
+                    case Type::DOUBLE: real = load<double>(record, offset); break;
+                    case Type::STRING: {
+                        uint8_t length = record.payload[offset++];
+                        memcpy(text, record.payload + offset, length);
+                        text[length] = '\0';
+                        offset += length;
+                        break;
+                    }
+                    default: break;
+                }
+                if (type == Type::DOUBLE) integer = (long long)real;
+                else real = (double)integer;
+
+                if (conversion == 's') {
+                    spec[n++] = 's';
+                    spec[n] = '\0';
+                    out.printf(spec, type == Type::STRING ? text : "?");
+                } else if (strchr("fFeEgGaA", conversion)) {
+                    spec[n++] = conversion;
+                    spec[n] = '\0';
+                    out.printf(spec, real);
+                } else if (strchr("diouxXc", conversion)) {
+                    if (conversion != 'c') {
+                        spec[n++] = 'l';
+                        spec[n++] = 'l';
+                    }
+                    spec[n++] = conversion;
+                    spec[n] = '\0';
+                    if (conversion == 'c') out.printf(spec, (int)integer);
+                    else out.printf(spec, integer);
+                } else {
+                    out.print('?');
+                }
+            }
+            out.print('\n');
+        }
+
+        static void task(void* param) {
+            Logger* logger = static_cast<Logger*>(param);
+            for (;;) {
+                logger->drain(Serial);
+                vTaskDelay(pdMS_TO_TICKS(Constants::Log::POLL));
+            }
+        }
+
+        static uint32_t scheduled(void* param) {
+            static_cast<Logger*>(param)->drain(Serial);
+            return Constants::Log::POLL;
+        }
+    };
+}
+
+#define LOG_WRITE(format, ...)                                              \
+    do {                                                                    \
+        if (false) Utils::Logger::check(format, ##__VA_ARGS__);             \
+        Utils::Logger::instance().write(format, ##__VA_ARGS__);             \
+    } while (0)
+
+// Unevaluated: no code and no string, but the format is still checked
+#define LOG_DISCARD(format, ...) \
+    do { (void)sizeof((Utils::Logger::check(format, ##__VA_ARGS__), 0)); } while (0)
+
+#if LOG_LEVEL >= LOG_LEVEL_ERROR
+#define LOG_ERROR(format, ...) LOG_WRITE(format, ##__VA_ARGS__)
+#else
+#define LOG_ERROR(format, ...) LOG_DISCARD(format, ##__VA_ARGS__)
+#endif
+
+#if LOG_LEVEL >= LOG_LEVEL_WARN
+#define LOG_WARN(format, ...) LOG_WRITE(format, ##__VA_ARGS__)
+#else
+#define LOG_WARN(format, ...) LOG_DISCARD(format, ##__VA_ARGS__)
+#endif
+
+#if LOG_LEVEL >= LOG_LEVEL_INFO
+#define LOG_INFO(format, ...) LOG_WRITE(format, ##__VA_ARGS__)
+#else
+#define LOG_INFO(format, ...) LOG_DISCARD(format, ##__VA_ARGS__)
+#endif
+
+#if LOG_LEVEL >= LOG_LEVEL_DEBUG
+#define LOG_DEBUG(format, ...) LOG_WRITE(format, ##__VA_ARGS__)
+#else
+#define LOG_DEBUG(format, ...) LOG_DISCARD(format, ##__VA_ARGS__)
+#endif
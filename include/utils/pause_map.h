@@ -0,0 +1,64 @@
+#pragma once
+#include <Arduino.h>
+#include <vector>
+
+namespace Utils {
+    // Punctuation positions of one piece of text, two bits per character.
+    // Built once before typing so the per-character pause check is a bit
+    // test instead of a scan. Storage is reused across builds.
+    class PauseMap {
+    public:
+        enum class Pause : uint8_t {
+            NONE = 0,
+            WORD = 1,       // After a comma
+            SENTENCE = 2    // After '.', '!' or '?'
+        };
+
+        void build(const String& text) {
+            build(text.c_str(), text.length());
+        }
+
+        void build(const char* text, size_t length) {
+            size_t words = (length + CHARS_PER_WORD - 1) / CHARS_PER_WORD;
+            bits.assign(words, 0);
+            count = length;
+
+            for (size_t i = 0; i < length; i++) {
+                Pause pause = classify(text[i]);
+                if (pause != Pause::NONE) {
+                    bits[i / CHARS_PER_WORD] |= (uint32_t)pause << shift(i);
+                }
+            }
+        }
+
+        size_t size() const { return count; }
+
+        Pause at(size_t position) const {
+            if (position >= count) return Pause::NONE;
+            return static_cast<Pause>((bits[position / CHARS_PER_WORD] >> shift(position)) & 0x3);
+        }
+
+    private:
+        static constexpr size_t CHARS_PER_WORD = 16;  // 2 bits each in a uint32_t
+
+        std::vector<uint32_t> bits;
+        size_t count = 0;
+
+        static size_t shift(size_t position) {
+            return (position % CHARS_PER_WORD) * 2;
+        }
+
+        static Pause classify(char c) {
+            switch (c) {
+                case '.':
+                case '!':
+                case '?':
+                    return Pause::SENTENCE;
+                case ',':
+                    return Pause::WORD;
+                default:
+                    return Pause::NONE;
+            }
+        }
+    };
+}
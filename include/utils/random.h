@@ -0,0 +1,76 @@
+#pragma once
+#include <Arduino.h>
+
+namespace Utils {
+    // Small seeded generator for the typing simulation: xoshiro128**
+    // (Blackman & Vigna), 16 bytes of state, a few shifts and one multiply
+    // per draw on the 32-bit core. The same seed gives the same sequence
+    // on the device and on the host, so simulated sessions reproduce.
+    // Not for anything security related. One owner task; not thread safe.
+    class Random {
+    public:
+        static constexpr uint64_t DEFAULT_SEED = 0x9E3779B97F4A7C15ull;
+
+        explicit Random(uint64_t seed = DEFAULT_SEED) { this->seed(seed); }
+
+        // Expands the seed with splitmix64, which never yields the
+        // all-zero state xoshiro cannot leave
+        void seed(uint64_t value) {
+            for (int i = 0; i < 4; i += 2) {
+                uint64_t z = (value += 0x9E3779B97F4A7C15ull);
+                z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+                z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+                z ^= z >> 31;
+                state[i] = (uint32_t)z;
+                state[i + 1] = (uint32_t)(z >> 32);
+            }
+        }
+
+        uint32_t next() {
+            uint32_t result = rotl(state[1] * 5, 7) * 9;
+            uint32_t t = state[1] << 9;
+            state[2] ^= state[0];
+            state[3] ^= state[1];
+            state[1] ^= state[2];
+            state[0] ^= state[3];
+            state[2] ^= t;
+            state[3] = rotl(state[3], 11);
+            return result;
+        }
+
+        // Uniform in [0, bound), Lemire's multiply-shift: no division
+        // except on the rare rejection path, and no modulo bias
+        uint32_t below(uint32_t bound) {
+            if (bound == 0) return 0;
+            uint64_t m = (uint64_t)next() * bound;
+            uint32_t low = (uint32_t)m;
+            if (low < bound) {
+                uint32_t threshold = (0u - bound) % bound;
+                while (low < threshold) {
+                    m = (uint64_t)next() * bound;
+                    low = (uint32_t)m;
+                }
+            }
+            return (uint32_t)(m >> 32);
+        }
+
+        // Uniform in [low, high); low when the range is empty, like
+        // Arduino's random(low, high)
+        int32_t between(int32_t low, int32_t high) {
+            if (high <= low) return low;
+            return low + (int32_t)below((uint32_t)(high - low));
+        }
+
+        // True with probability p; 24-bit resolution, no float division
+        bool chance(float p) {
+            if (p <= 0.0f) return false;
+            if (p >= 1.0f) return true;
+            return (next() >> 8) < (uint32_t)(p * 16777216.0f);
+        }
+
+    private:
+        uint32_t state[4];
+
+        static uint32_t rotl(uint32_t x, int k) { return (x << k) | (x >> (32 - k)); }
+    };
+}
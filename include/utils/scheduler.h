@@ -0,0 +1,124 @@
+#pragma once
+#include <Arduino.h>
+#include "constants.h"
+
+namespace Utils {
+    // Cooperative scheduler for the main loop task. A task is a function
+    // and a context pointer; it runs once its deadline has passed and
+    // returns the delay until its next run, or STOP. Nothing is preempted:
+    // long-running code yields through sleepFor(), which runs whatever else
+    // is due instead of blocking in delay(). A task that sleeps is not
+    // re-entered until it returns.
+    //
+    // Time comes from millis() and delay(), so on the host (tools/host)
+    // setVirtualClock(true) makes every sleep instant and a whole session
+    // runs without waiting. Only call from one task: the HID output task
+    // and other FreeRTOS tasks keep using delay()/vTaskDelay().
+    class Scheduler {
+    public:
+        using Callback = uint32_t (*)(void* context);
+        static constexpr uint32_t STOP = UINT32_MAX;
+        static constexpr size_t MAX_TASKS = Constants::Scheduler::MAX_TASKS;
+
+        struct TaskStats {
+            const char* name = nullptr;
+            uint32_t runs = 0;
+            uint32_t maxLateMillis = 0;   // Worst start after the deadline
+            uint32_t maxRunMillis = 0;    // Worst time before handing back
+        };
+
+        static Scheduler& instance() {
+            static Scheduler scheduler;
+            return scheduler;
+        }
+
+        // Returns the task id, or -1 when the table is full
+        int add(const char* name, Callback callback, void* context = nullptr,
+                uint32_t firstDelay = 0) {
+            for (size_t i = 0; i < MAX_TASKS; i++) {
+                if (tasks[i].callback) continue;
+                tasks[i] = Task();
+                tasks[i].callback = callback;
+                tasks[i].context = context;
+                tasks[i].due = millis() + firstDelay;
+                tasks[i].stats.name = name;
+                return i;
+            }
+            return -1;
+        }
+
+        void remove(int id) {
+            if (isValid(id)) tasks[id].callback = nullptr;
+        }
+
+        // Runs the task on the next pass
+        void wake(int id) {
+            if (isValid(id)) tasks[id].due = millis();
+        }
+
+        // Runs every task that is due once
+        void runDue() {
+            for (size_t i = 0; i < MAX_TASKS; i++) {
+                Task& task = tasks[i];
+                uint32_t start = millis();
+                if (!task.callback || task.running || (int32_t)(task.due - start) > 0) continue;
+
+                task.running = true;
+                uint32_t next = task.callback(task.context);
+                uint32_t end = millis();
+                task.running = false;
+
+                task.stats.runs++;
+                task.stats.maxLateMillis = max(task.stats.maxLateMillis, start - task.due);
+                task.stats.maxRunMillis = max(task.stats.maxRunMillis, end - start);
+                if (next == STOP) task.callback = nullptr;
+                else task.due = end + next;
+            }
+        }
+
+        // Milliseconds until the next task is due, STOP if there is none
+        uint32_t untilNextDue() const {
+            uint32_t now = millis();
+            uint32_t next = STOP;
+            for (const Task& task : tasks) {
+                if (!task.callback || task.running) continue;
+                int32_t until = task.due - now;
+                next = min<uint32_t>(next, until > 0 ? until : 0);
+            }
+            return next;
+        }
+
+        // delay() that keeps the other tasks running
+        void sleepFor(uint32_t ms) {
+            uint32_t end = millis() + ms;
+            for (;;) {
+                runDue();
+                int32_t left = end - millis();
+                if (left <= 0) return;
+                // At least 1 ms so a task asking to run continuously cannot
+                // stall a virtual clock
+                delay(max<uint32_t>(1, min<uint32_t>(left, untilNextDue())));
+            }
+        }
+
+        const TaskStats* getStats(int id) const {
+            return isValid(id) ? &tasks[id].stats : nullptr;
+        }
+
+    private:
+        struct Task {
+            Callback callback = nullptr;
+            void* context = nullptr;
+            uint32_t due = 0;
+            bool running = false;
+            TaskStats stats;
+        };
+
+        Task tasks[MAX_TASKS];
+
+        bool isValid(int id) const { return id >= 0 && id < (int)MAX_TASKS; }
+    };
+
+    // Cooperative replacement for delay() on the main loop task
+    inline void sleepFor(uint32_t ms) { Scheduler::instance().sleepFor(ms); }
+}
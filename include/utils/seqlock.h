@@ -0,0 +1,41 @@
+#pragma once
+#include <Arduino.h>
+#include <atomic>
+#include <type_traits>
+
+namespace Utils {
+    // Publishes a small value from one writer task to any number of
+    // readers without locking. The writer never waits; a reader retries
+    // if it overlapped a write. T must be trivially copyable.
+    template<typename T>
+    class Seqlock {
+        static_assert(std::is_trivially_copyable<T>::value,
+                      "Seqlock values are copied byte for byte");
+
+    public:
+        // Writer side (one task only)
+        void store(const T& value) {
+            uint32_t seq = sequence.load(std::memory_order_relaxed);
+            sequence.store(seq + 1, std::memory_order_relaxed);   // Odd: write in progress
+            std::atomic_thread_fence(std::memory_order_release);
+            data = value;
+            sequence.store(seq + 2, std::memory_order_release);
+        }
+
+        T load() const {
+            T copy;
+            uint32_t before, after;
+            do {
+                before = sequence.load(std::memory_order_acquire);
+                copy = data;
+                std::atomic_thread_fence(std::memory_order_acquire);
+                after = sequence.load(std::memory_order_relaxed);
+            } while (before != after || (before & 1));
+            return copy;
+        }
+
+    private:
+        std::atomic<uint32_t> sequence{0};
+        T data{};
+    };
+}
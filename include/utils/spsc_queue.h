@@ -0,0 +1,66 @@
+#pragma once
+#include <Arduino.h>
+#include <atomic>
+
+namespace Utils {
+    // Lock-free ring buffer for exactly one producer and one consumer,
+    // which may run on different tasks or cores. One slot is sacrificed
+    // to tell full from empty.
+    template<typename T, size_t Capacity>
+    class SpscQueue {
+        static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0,
+                      "SpscQueue capacity must be a power of two");
+
+    public:
+        // Producer side. Always inlined, so an IRAM_ATTR interrupt handler
+        // that pushes does not call into flash.
+        __attribute__((always_inline)) inline bool push(const T& item) {
+            size_t tail = tailIndex.load(std::memory_order_relaxed);
+            size_t next = (tail + 1) & MASK;
+            if (next == headIndex.load(std::memory_order_acquire)) return false;
+
+            slots[tail] = item;
+            tailIndex.store(next, std::memory_order_release);
+            return true;
+        }
+
+        // Consumer side
+        bool pop(T& item) {
+            const T* front = peek();
+            if (!front) return false;
+            item = *front;
+            drop();
+            return true;
+        }
+
+        // Front element without removing it; nullptr when empty
+        const T* peek() const {
+            size_t head = headIndex.load(std::memory_order_relaxed);
+            if (head == tailIndex.load(std::memory_order_acquire)) return nullptr;
+            return &slots[head];
+        }
+
+        void drop() {
+            size_t head = headIndex.load(std::memory_order_relaxed);
+            headIndex.store((head + 1) & MASK, std::memory_order_release);
+        }
+
+        // Either side; a snapshot that may be stale by the time it is used
+        size_t size() const {
+            size_t head = headIndex.load(std::memory_order_acquire);
+            size_t tail = tailIndex.load(std::memory_order_acquire);
+            return (tail - head) & MASK;
+        }
+
+        bool isEmpty() const { return size() == 0; }
+        bool isFull() const { return size() == Capacity - 1; }
+        static constexpr size_t capacity() { return Capacity - 1; }
+
+    private:
+        static constexpr size_t MASK = Capacity - 1;
+
+        T slots[Capacity];
+        std::atomic<size_t> headIndex{0};
+        std::atomic<size_t> tailIndex{0};
+    };
+}
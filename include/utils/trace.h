@@ -0,0 +1,121 @@
+#pragma once
+#include <Arduino.h>
+#include <atomic>
+#include "constants.h"
+
+namespace Utils {
+    // What a trace record marks. Values are part of the dump format: add
+    // at the end, and teach tools/trace_tool the new event.
+    enum class TraceEvent : uint8_t {
+        KEY_EMIT,           // Output task sent a key. arg0 key, arg1 keys still queued
+        QUEUE_DEPTH,        // Engine queued a key. arg1 keys queued
+        BUTTON_EDGE,        // Button edge read by the UI task. arg0 1 pressed, 0 released,
+                            // arg1 millis() the interrupt took it at
+        CLIP_START,         // arg0 clip
+        CLIP_END,           // arg0 clip, arg1 1 finished, 0 paused or interrupted
+        BLE_CONNECT,
+        BLE_DISCONNECT,
+        FILE_BEGIN,         // arg0 TraceFile
+        FILE_END,           // arg0 TraceFile, arg1 1 loaded, 0 failed
+        COUNT
+    };
+
+    enum class TraceFile : uint16_t {
+        TASK_IMAGE,
+        TEXT
+    };
+
+    // 16 bytes. sequence is the record's index + 1, written last: a slot
+    // whose sequence does not match its index is empty or half written.
+    struct TraceRecord {
+        std::atomic<uint32_t> sequence;
+        uint32_t micros;
+        uint8_t event;
+        uint8_t core;
+        uint16_t arg0;
+        uint32_t arg1;
+    };
+
+    // Fixed-size event trace for the hot paths: recording claims a slot
+    // with one atomic add and fills in 16 bytes, no lock, no formatting,
+    // no allocation, so it is safe from any task on either core. It lives
+    // in flash, so interrupts do not record. The oldest records are
+    // overwritten once the ring is full. dump() writes the ring to serial
+    // as hex lines that tools/trace_tool turns into Chrome trace JSON.
+    template<size_t Capacity>
+    class TraceRing {
+        static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0,
+                      "TraceRing capacity must be a power of two");
+
+    public:
+        static constexpr uint8_t FORMAT_VERSION = 1;
+
+        void record(TraceEvent event, uint16_t arg0 = 0, uint32_t arg1 = 0) {
+            if (!enabled.load(std::memory_order_relaxed)) return;
+            uint32_t index = head.fetch_add(1, std::memory_order_relaxed);
+            TraceRecord& slot = records[index & MASK];
+            slot.sequence.store(0, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+            slot.micros = ::micros();
+            slot.event = (uint8_t)event;
+            slot.core = currentCore();
+            slot.arg0 = arg0;
+            slot.arg1 = arg1;
+            slot.sequence.store(index + 1, std::memory_order_release);
+        }
+
+        void setEnabled(bool on) { enabled.store(on, std::memory_order_relaxed); }
+
+        // Records made so far, including overwritten ones
+        uint32_t total() const { return head.load(std::memory_order_relaxed); }
+
+        // Writes the ring oldest first. Recording stops meanwhile, since a
+        // dump at serial speed outlasts the ring; what happens during the
+        // dump is not traced.
+        void dump(Print& out) {
+            setEnabled(false);
+            delay(1);               // Let a record in progress on the other core land
+            uint32_t end = total();
+            uint32_t begin = end > Capacity ? end - Capacity : 0;
+            out.printf("=== Trace v%u: %u records, %u overwritten ===\n", FORMAT_VERSION,
+                       (unsigned)(end - begin), (unsigned)begin);
+            for (uint32_t i = begin; i != end; i++) {
+                const TraceRecord& slot = records[i & MASK];
+                uint32_t sequence = slot.sequence.load(std::memory_order_acquire);
+                if (sequence != i + 1) continue;
+                out.printf("#T %08x%08x%02x%02x%04x%08x\n", (unsigned)sequence, (unsigned)slot.micros,
+                           slot.event, slot.core, slot.arg0, (unsigned)slot.arg1);
+            }
+            out.println("=== End of trace ===");
+            setEnabled(true);
+        }
+
+    private:
+        static constexpr uint32_t MASK = Capacity - 1;
+
+        TraceRecord records[Capacity] = {};
+        std::atomic<uint32_t> head{0};
+        std::atomic<bool> enabled{true};
+
+        static uint8_t currentCore() {
+#ifdef ARDUINO
+            return xPortGetCoreID();
+#else
+            return 0;
+#endif
+        }
+    };
+
+    using Trace = TraceRing<Constants::Trace::CAPACITY>;
+
+    // Zero-initialized, so it is usable before setup() runs
+    inline Trace& trace() {
+        static Trace ring;
+        return ring;
+    }
+
+    // Call sites compile away with Constants::Trace::ENABLED off
+    inline void traceEvent(TraceEvent event, uint16_t arg0 = 0, uint32_t arg1 = 0) {
+        if (Constants::Trace::ENABLED) trace().record(event, arg0, arg1);
+    }
+}
@@ -0,0 +1,27 @@
+#include "aht/calculator.h"
+#include "aht/graph_data.h"
+#include "utils/interpolation.h"
+
+namespace AHT {
+    CalculationResult Calculator::calculate(float durationSeconds) {
+        CalculationResult result = {};
+        result.isValid = durationSeconds >= MIN_DURATION && durationSeconds <= MAX_DURATION;
+
+        uint8_t durations[NUM_POINTS];
+        float lower[NUM_POINTS];
+        float upper[NUM_POINTS];
+        float target[NUM_POINTS];
+        for (size_t i = 0; i < NUM_POINTS; i++) {
+            durations[i] = CURVE_POINTS[i].videoDuration;
+            lower[i] = CURVE_POINTS[i].lowerBound;
+            upper[i] = CURVE_POINTS[i].upperBound;
+            target[i] = CURVE_POINTS[i].targetAHT;
+        }
+
+        // Outside the chart the nearest end point is used
+        result.lowerBoundMinutes = Utils::Interpolation::multiLerp(durations, lower, NUM_POINTS, durationSeconds);
+        result.upperBoundMinutes = Utils::Interpolation::multiLerp(durations, upper, NUM_POINTS, durationSeconds);
+        result.targetMinutes = Utils::Interpolation::multiLerp(durations, target, NUM_POINTS, durationSeconds);
+        return result;
+    }
+}
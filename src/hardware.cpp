@@ -1,59 +1,123 @@
 #include "hardware.h"
 
+namespace {
+    using Ui::Tone;
+    using namespace Constants::Hardware;
+
+    // One pattern per SoundType; lengths follow the *_BEEP constants
+    constexpr Tone SECTION_COMPLETE_TONES[] = {
+        {1047, SECTION_COMPLETE_BEEP / 4}, {0, 20},
+        {1319, SECTION_COMPLETE_BEEP / 4}, {0, 20},
+        {1568, SECTION_COMPLETE_BEEP / 2}
+    };
+    constexpr Tone ERROR_TONES[] = {{220, ERROR_BEEP}, {0, ERROR_BEEP / 2}, {220, ERROR_BEEP}};
+    constexpr Tone SUCCESS_TONES[] = {{1568, SUCCESS_BEEP}, {2093, SUCCESS_BEEP}};
+    constexpr Tone SPEED_WARNING_TONES[] = {{880, SPEED_WARNING_BEEP}};
+    constexpr Tone PROGRESS_TONES[] = {{2093, PROGRESS_BEEP}};
+
+    template<size_t N>
+    constexpr Ui::SoundPattern pattern(const Tone (&tones)[N]) {
+        static_assert(N <= UINT8_MAX, "Sound pattern too long");
+        return {tones, N};
+    }
+
+    constexpr Ui::SoundPattern SECTION_COMPLETE_SOUND = pattern(SECTION_COMPLETE_TONES);
+    constexpr Ui::SoundPattern ERROR_SOUND = pattern(ERROR_TONES);
+    constexpr Ui::SoundPattern SUCCESS_SOUND = pattern(SUCCESS_TONES);
+    constexpr Ui::SoundPattern SPEED_WARNING_SOUND = pattern(SPEED_WARNING_TONES);
+    constexpr Ui::SoundPattern PROGRESS_SOUND = pattern(PROGRESS_TONES);
+
+    using Ui::LedFrame;
+    constexpr uint8_t ON = 255;
+    constexpr uint8_t DIM = 24;
+
+    // One keyframe table per Pattern: {red, blue, fade ms, hold ms}
+    constexpr LedFrame ALL_OFF_FRAMES[] = {{0, 0, LED_FADE, 0}};
+    constexpr LedFrame ALL_ON_FRAMES[] = {{ON, ON, LED_FADE, 0}};
+    constexpr LedFrame RED_ONLY_FRAMES[] = {{ON, 0, LED_FADE, 0}};
+    constexpr LedFrame BLUE_ONLY_FRAMES[] = {{0, ON, LED_FADE, 0}};
+    constexpr LedFrame ALTERNATING_FRAMES[] = {
+        {ON, 0, DATA_FLICKER_SPEED / 4, DATA_FLICKER_SPEED * 3 / 4},
+        {0, ON, DATA_FLICKER_SPEED / 4, DATA_FLICKER_SPEED * 3 / 4}
+    };
+    constexpr LedFrame SYNC_FLASH_FRAMES[] = {
+        {ON, ON, COMPLETE_FLICKER_SPEED / 4, COMPLETE_FLICKER_SPEED * 3 / 4},
+        {0, 0, COMPLETE_FLICKER_SPEED / 4, COMPLETE_FLICKER_SPEED * 3 / 4}
+    };
+    constexpr LedFrame ERROR_FRAMES[] = {{ON, 0, 0, ERROR_BLINK_SPEED}, {0, 0, 0, ERROR_BLINK_SPEED}};
+    constexpr LedFrame SUCCESS_FRAMES[] = {{ON, ON, 0, SUCCESS_BLINK_SPEED}, {0, 0, 0, SUCCESS_BLINK_SPEED}};
+    // Speed indicator: the LED of the wrong direction breathes
+    constexpr LedFrame SPEED_SLOW_FRAMES[] = {{ON, 0, SPEED_PULSE, 0}, {DIM, 0, SPEED_PULSE, 0}};
+    constexpr LedFrame SPEED_FAST_FRAMES[] = {{0, ON, SPEED_PULSE, 0}, {0, DIM, SPEED_PULSE, 0}};
+
+    template<size_t N>
+    constexpr Ui::LedPattern pattern(const LedFrame (&frames)[N], bool repeat) {
+        static_assert(N <= UINT8_MAX, "LED pattern too long");
+        return {frames, N, repeat};
+    }
+
+    constexpr Ui::LedPattern ALL_OFF_LEDS = pattern(ALL_OFF_FRAMES, false);
+    constexpr Ui::LedPattern ALL_ON_LEDS = pattern(ALL_ON_FRAMES, false);
+    constexpr Ui::LedPattern RED_ONLY_LEDS = pattern(RED_ONLY_FRAMES, false);
+    constexpr Ui::LedPattern BLUE_ONLY_LEDS = pattern(BLUE_ONLY_FRAMES, false);
+    constexpr Ui::LedPattern ALTERNATING_LEDS = pattern(ALTERNATING_FRAMES, true);
+    constexpr Ui::LedPattern SYNC_FLASH_LEDS = pattern(SYNC_FLASH_FRAMES, true);
+    constexpr Ui::LedPattern ERROR_LEDS = pattern(ERROR_FRAMES, true);
+    constexpr Ui::LedPattern SUCCESS_LEDS = pattern(SUCCESS_FRAMES, true);
+    constexpr Ui::LedPattern SPEED_SLOW_LEDS = pattern(SPEED_SLOW_FRAMES, true);
+    constexpr Ui::LedPattern SPEED_FAST_LEDS = pattern(SPEED_FAST_FRAMES, true);
+
+#ifdef ARDUINO
+    esp_timer_handle_t createTimer(esp_timer_cb_t callback, void* arg, const char* name) {
+        esp_timer_create_args_t args = {};
+        args.callback = callback;
+        args.arg = arg;
+        args.name = name;
+        esp_timer_handle_t timer = nullptr;
+        esp_timer_create(&args, &timer);
+        return timer;
+    }
+#endif
+}
+
 void Hardware::init() {
     // Initialize pins
     pinMode(Constants::Hardware::BUTTON_PIN, INPUT_PULLUP);
-    pinMode(Constants::Hardware::BUZZER_PIN, OUTPUT);
-    pinMode(Constants::Hardware::BLUE_LED, OUTPUT);
-    pinMode(Constants::Hardware::RED_LED, OUTPUT);
     
+    // Button edges are captured with their time by the interrupt and
+    // classified later on the UI task
+    attachInterruptArg(digitalPinToInterrupt(Constants::Hardware::BUTTON_PIN),
+                       onButtonEdge, this, CHANGE);
+
+    buzzerPwm.begin();
+    ledPwm.begin();
+#ifdef ARDUINO
+    buzzerTimer = createTimer(onBuzzerTimer, this, "buzzer");
+    ledTimer = createTimer(onLedTimer, this, "leds");
+#endif
+
     // Set initial states
-    setPhysicalLed(Constants::Hardware::BUZZER_PIN, false);
-    setPhysicalLed(Constants::Hardware::BLUE_LED, true);
-    setPhysicalLed(Constants::Hardware::RED_LED, true);
-
-    if (Constants::Debug::ENABLE_SERIAL_DEBUG) {
-        Serial.println("Hardware initialized");
-        Serial.printf("Button pin: %d\n", Constants::Hardware::BUTTON_PIN);
-        Serial.printf("Sound enabled: %d\n", soundEnabled);
-    }
+    setLedPattern(Pattern::ALL_ON);
+
+    LOG_DEBUG("Hardware initialized");
+    LOG_DEBUG("Button pin: %d", Constants::Hardware::BUTTON_PIN);
+    LOG_DEBUG("Sound enabled: %d", soundEnabled);
 }
 
 void Hardware::update() {
     unsigned long currentMillis = millis();
 
-    // Update LED patterns
-    switch (currentPattern) {
-        case Pattern::PROGRESS_INDICATOR:
-            if (currentMillis - lastProgressUpdate >= 
-                Constants::Hardware::PROGRESS_UPDATE_INTERVAL) {
-                handleProgressPattern();
-                lastProgressUpdate = currentMillis;
-            }
-            break;
-
-        case Pattern::SPEED_INDICATOR:
-            handleSpeedPattern();
-            break;
-
-        case Pattern::ERROR_PATTERN:
-            handleErrorPattern();
-            break;
-
-        case Pattern::SUCCESS_PATTERN:
-            handleSuccessPattern();
-            break;
-
-        // Handle other patterns...
-        default:
-            break;
-    }
+#ifndef ARDUINO
+    // No esp_timer on the host: step the buzzer and LEDs from the UI poll
+    buzzer.advance(currentMillis);
+    leds.advance(currentMillis);
+#endif
 
     // Debug output
     if (Constants::Debug::ENABLE_SERIAL_DEBUG && 
-        currentMillis - lastProgressUpdate >= Constants::Debug::DEBUG_UPDATE_INTERVAL) {
+        currentMillis - lastDebugPrint >= Constants::Debug::DEBUG_UPDATE_INTERVAL) {
         printDebugInfo();
-        lastProgressUpdate = currentMillis;
+        lastDebugPrint = currentMillis;
     }
 }
 
@@ -69,8 +133,8 @@ void Hardware::updateProgress(const Timing::ProgressSnapshot& progress) {
         playSound(SoundType::PROGRESS_MILESTONE);
     }
 
-    if (currentPattern == Pattern::PROGRESS_INDICATOR) {
-        handleProgressPattern();
+    if (currentPattern == Pattern::PROGRESS_INDICATOR && !ledOverride) {
+        showProgress();
     }
 }
 
@@ -82,196 +146,171 @@ void Hardware::updateSpeed(float currentWPM, float targetWPM) {
         playSound(SoundType::SPEED_WARNING);
     }
 
-    if (currentPattern == Pattern::SPEED_INDICATOR) {
-        handleSpeedPattern();
+    if (currentPattern == Pattern::SPEED_INDICATOR && !ledOverride) {
+        showSpeed();
     }
 }
 
-Hardware::ButtonEvent Hardware::detectButtonEvent() {
-    int reading = digitalRead(Constants::Hardware::BUTTON_PIN);
-    ButtonEvent event = ButtonEvent::NONE;
-    unsigned long currentTime = millis();
-
-    // Debounce
-    if (reading != lastButtonState) {
-        lastDebounceTime = currentTime;
-    }
-
-    if ((currentTime - lastDebounceTime) > Constants::Hardware::DEBOUNCE_DELAY) {
-        // Button pressed
-        if (reading == LOW && lastButtonState == HIGH) {
-            buttonPressCount++;
-            lastButtonPressTime = currentTime;
-            longPressActive = true;
-        }
-        // Button released
-        else if (reading == HIGH && lastButtonState == LOW) {
-            if (longPressActive && 
-                currentTime - lastButtonPressTime >= 
-                Constants::Hardware::LONG_PRESS_DURATION) {
-                event = ButtonEvent::LONG_PRESS;
-            } else {
-                // Process multi-press events
-                if (currentTime - lastButtonPressTime < 
-                    Constants::Hardware::DOUBLE_PRESS_WINDOW) {
-                    switch (buttonPressCount) {
-                        case 2:
-                            event = ButtonEvent::DOUBLE_PRESS;
-                            break;
-                        case 3:
-                            event = ButtonEvent::TRIPLE_PRESS;
-                            break;
-                        default:
-                            event = ButtonEvent::SINGLE_PRESS;
-                    }
-                } else {
-                    event = ButtonEvent::SINGLE_PRESS;
-                }
-            }
-            resetButtonState();
-        }
-    }
+// Runs with the flash cache possibly off (SPIFFS reads, NVS writes while
+// bonding), so it calls nothing that lives in flash: millis() and
+// digitalRead() are the core's IRAM versions, and push() is inlined. The
+// edge is traced when it is read, not here.
+void IRAM_ATTR Hardware::onButtonEdge(void* param) {
+    Hardware* hardware = static_cast<Hardware*>(param);
+    Ui::ButtonEdge edge = {(uint32_t)millis(),
+                           digitalRead(Constants::Hardware::BUTTON_PIN) == LOW};
+    // A full queue loses the edge; detectButtonEvent() resyncs from the pin
+    hardware->buttonEdges.push(edge);
+}
 
-    lastButtonState = reading;
-    return event;
+bool Hardware::isButtonPressed() {
+    return buttonClassifier.isDown();
 }
 
-// ... (Other implementation methods)
+Hardware::ButtonEvent Hardware::detectButtonEvent() {
+    // Captured edges first, in order, one event per call
+    Ui::ButtonEdge edge;
+    while (buttonEdges.pop(edge)) {
+        Utils::traceEvent(Utils::TraceEvent::BUTTON_EDGE, edge.pressed, edge.millis);
+        ButtonEvent event = buttonClassifier.edge(edge);
+        if (event != ButtonEvent::NONE) return event;
+    }
 
-void Hardware::handleProgressPattern() {
-    setPhysicalLedBrightness(Constants::Hardware::BLUE_LED, progressBrightness);
-    setPhysicalLedBrightness(Constants::Hardware::RED_LED, 1.0f - progressBrightness);
+    // Then the timers, after catching up with any edge that was missed
+    uint32_t now = millis();
+    bool pressed = digitalRead(Constants::Hardware::BUTTON_PIN) == LOW;
+    ButtonEvent event = buttonClassifier.sync(pressed, now);
+    if (event != ButtonEvent::NONE) return event;
+    return buttonClassifier.poll(now);
 }
 
-void Hardware::handleSpeedPattern() {
-    if (speedIndicatorValue < 0.9f) {
-        // Too slow - pulse red
-        pulseLed(Constants::Hardware::RED_LED, 500, 2);
-        setPhysicalLed(Constants::Hardware::BLUE_LED, true);
-    } else if (speedIndicatorValue > 1.1f) {
-        // Too fast - pulse blue
-        pulseLed(Constants::Hardware::BLUE_LED, 500, 2);
-        setPhysicalLed(Constants::Hardware::RED_LED, true);
-    } else {
-        // Good speed - both LEDs on
-        setPhysicalLed(Constants::Hardware::BLUE_LED, false);
-        setPhysicalLed(Constants::Hardware::RED_LED, false);
+// LED Control Methods
+const Ui::LedPattern& Hardware::ledPattern(Pattern pattern) {
+    switch (pattern) {
+        case Pattern::ALL_ON:
+            return ALL_ON_LEDS;
+        case Pattern::ALTERNATING:
+            return ALTERNATING_LEDS;
+        case Pattern::RED_ONLY:
+            return RED_ONLY_LEDS;
+        case Pattern::BLUE_ONLY:
+            return BLUE_ONLY_LEDS;
+        case Pattern::SYNC_FLASH:
+            return SYNC_FLASH_LEDS;
+        case Pattern::SPEED_INDICATOR:
+            return ALL_ON_LEDS;         // On pace; updateSpeed() picks the rest
+        case Pattern::ERROR_PATTERN:
+            return ERROR_LEDS;
+        case Pattern::SUCCESS_PATTERN:
+            return SUCCESS_LEDS;
+        case Pattern::ALL_OFF:
+        case Pattern::PROGRESS_INDICATOR:   // Levels come from updateProgress()
+            break;
     }
+    return ALL_OFF_LEDS;
 }
 
-// ... (Remaining implementation methods)
+void Hardware::showLevels(float red, float blue, uint16_t fadeMillis) {
+    leds.show((uint8_t)(constrain(red, 0.0f, 1.0f) * 255 + 0.5f),
+              (uint8_t)(constrain(blue, 0.0f, 1.0f) * 255 + 0.5f), fadeMillis);
+    startLeds();
+}
 
-// LED Control Methods
-void Hardware::setPhysicalLed(uint8_t pin, bool state) {
-    digitalWrite(pin, state ? LOW : HIGH);  // LEDs are active LOW
+void Hardware::showProgress() {
+    showLevels(1.0f - progressBrightness, progressBrightness,
+               Constants::Hardware::PROGRESS_UPDATE_INTERVAL);
 }
 
-void Hardware::setPhysicalLedBrightness(uint8_t pin, float brightness) {
-    // For digital pins, we simulate brightness with PWM if available
-    // or use a threshold for non-PWM pins
-    brightness = constrain(brightness, 0.0f, 1.0f);
-    if (brightness >= 0.5f) {
-        digitalWrite(pin, LOW);  // ON
-    } else {
-        digitalWrite(pin, HIGH); // OFF
-    }
+void Hardware::showSpeed() {
+    const Ui::LedPattern* pattern = &ledPattern(Pattern::SPEED_INDICATOR);
+    if (speedIndicatorValue < 0.9f) pattern = &SPEED_SLOW_LEDS;
+    else if (speedIndicatorValue > 1.1f) pattern = &SPEED_FAST_LEDS;
+
+    // Replaying the same pattern would restart its breath
+    if (pattern == speedShown) return;
+    speedShown = pattern;
+    leds.play(*pattern);
+    startLeds();
 }
 
-void Hardware::pulseLed(uint8_t pin, int duration, int pulseCount) {
-    static unsigned long pulseStartTime = 0;
-    static int currentPulse = 0;
-    static bool pulseState = false;
-    
-    unsigned long currentTime = millis();
-    
-    // Reset pulse sequence if starting new one
-    if (currentPulse == 0 || currentTime - pulseStartTime > duration) {
-        pulseStartTime = currentTime;
-        pulseState = true;
-        currentPulse = 0;
-    }
-    
-    // Calculate pulse timing
-    int pulseDuration = duration / (pulseCount * 2);
-    if (currentTime - pulseStartTime > pulseDuration) {
-        pulseState = !pulseState;
-        pulseStartTime = currentTime;
-        if (!pulseState) currentPulse++;
-    }
-    
-    // Stop after completing pulses
-    if (currentPulse >= pulseCount) {
-        setPhysicalLed(pin, true);  // LED off
-        return;
-    }
-    
-    setPhysicalLed(pin, !pulseState);
+void Hardware::startLeds() {
+#ifdef ARDUINO
+    esp_timer_stop(ledTimer);
+    esp_timer_start_once(ledTimer, 0);
+#endif
 }
 
-// Error and Success Pattern Handlers
-void Hardware::handleErrorPattern() {
-    static unsigned long lastErrorToggle = 0;
-    unsigned long currentTime = millis();
-    
-    if (currentTime - lastErrorToggle >= Constants::Hardware::ERROR_BLINK_SPEED) {
-        ledState = !ledState;
-        setPhysicalLed(Constants::Hardware::RED_LED, !ledState);
-        setPhysicalLed(Constants::Hardware::BLUE_LED, true);
-        lastErrorToggle = currentTime;
+#ifdef ARDUINO
+void Hardware::onLedTimer(void* param) {
+    Hardware* hardware = static_cast<Hardware*>(param);
+    uint32_t next = hardware->leds.advance(millis());
+    if (next != Leds::IDLE) {
+        esp_timer_start_once(hardware->ledTimer, (uint64_t)next * 1000);
     }
 }
+#endif
 
-void Hardware::handleSuccessPattern() {
-    static unsigned long lastSuccessToggle = 0;
-    static int successPhase = 0;
-    unsigned long currentTime = millis();
-    
-    if (currentTime - lastSuccessToggle >= Constants::Hardware::SUCCESS_BLINK_SPEED) {
-        switch (successPhase) {
-            case 0: // Both ON
-                setPhysicalLed(Constants::Hardware::BLUE_LED, false);
-                setPhysicalLed(Constants::Hardware::RED_LED, false);
-                break;
-            case 1: // Both OFF
-                setPhysicalLed(Constants::Hardware::BLUE_LED, true);
-                setPhysicalLed(Constants::Hardware::RED_LED, true);
-                break;
-        }
-        
-        successPhase = (successPhase + 1) % 2;
-        lastSuccessToggle = currentTime;
-    }
+void Hardware::setLedBrightness(float red, float blue) {
+    ledOverride = true;
+    showLevels(red, blue, Constants::Hardware::LED_FADE);
 }
 
 // Sound Control Methods
-void Hardware::playSound(SoundType type) {
-    if (!soundEnabled || !Constants::Hardware::BUZZER_ENABLED) return;
-    
-    int duration = 0;
+const Ui::SoundPattern& Hardware::soundPattern(SoundType type) {
     switch (type) {
         case SoundType::SECTION_COMPLETE:
-            duration = Constants::Hardware::SECTION_COMPLETE_BEEP;
-            break;
+            return SECTION_COMPLETE_SOUND;
         case SoundType::ERROR:
-            duration = Constants::Hardware::ERROR_BEEP;
-            break;
+            return ERROR_SOUND;
         case SoundType::SUCCESS:
-            duration = Constants::Hardware::SUCCESS_BEEP;
-            break;
+            return SUCCESS_SOUND;
         case SoundType::SPEED_WARNING:
-            duration = Constants::Hardware::SPEED_WARNING_BEEP;
-            break;
+            return SPEED_WARNING_SOUND;
         case SoundType::PROGRESS_MILESTONE:
-            duration = Constants::Hardware::PROGRESS_BEEP;
-            break;
+            return PROGRESS_SOUND;
+    }
+    return Buzzer::SILENCE;
+}
+
+void Hardware::playSound(SoundType type) {
+    if (!soundEnabled || !Constants::Hardware::BUZZER_ENABLED) return;
+    buzzer.play(soundPattern(type));
+    startBuzzer();
+}
+
+void Hardware::enableSound(bool enable) {
+    soundEnabled = enable;
+    if (!enable) {
+        buzzer.play(Buzzer::SILENCE);
+        startBuzzer();
     }
+}
+
+void Hardware::startBuzzer() {
+#ifdef ARDUINO
+    // If the callback is mid-run and re-arms first, this start fails and
+    // the new pattern is picked up when the current tone ends
+    esp_timer_stop(buzzerTimer);
+    esp_timer_start_once(buzzerTimer, 0);
+#endif
+}
 
-    if (duration > 0) {
-        digitalWrite(Constants::Hardware::BUZZER_PIN, HIGH);
-        delay(duration);
-        digitalWrite(Constants::Hardware::BUZZER_PIN, LOW);
+#ifdef ARDUINO
+void Hardware::onBuzzerTimer(void* param) {
+    Hardware* hardware = static_cast<Hardware*>(param);
+    uint32_t next = hardware->buzzer.advance(millis());
+    if (next != Buzzer::IDLE) {
+        esp_timer_start_once(hardware->buzzerTimer, (uint64_t)next * 1000);
     }
 }
+#endif
+
+void Hardware::showError(const String& message) {
+    setError(true, message);
+    setLedPattern(Pattern::ERROR_PATTERN);
+    playSound(SoundType::ERROR);
+    LOG_ERROR("ERROR: %s", message.c_str());
+}
 
 // AHT Status Display
 void Hardware::showAHTStatus(const AHT::CalculationResult& aht) {
@@ -282,43 +321,34 @@ void Hardware::showAHTStatus(const AHT::CalculationResult& aht) {
     
     // Show AHT status using LED pattern
     float progressIndicator = aht.targetMinutes / aht.upperBoundMinutes;
-    setPhysicalLedBrightness(Constants::Hardware::BLUE_LED, progressIndicator);
-    setPhysicalLedBrightness(Constants::Hardware::RED_LED, 1.0f - progressIndicator);
+    setLedBrightness(1.0f - progressIndicator, progressIndicator);
     
-    if (Constants::Debug::ENABLE_SERIAL_DEBUG) {
-        Serial.println("\n=== AHT Status ===");
-        Serial.printf("Target: %.1f minutes\n", aht.targetMinutes);
-        Serial.printf("Range: %.1f - %.1f minutes\n", 
-                     aht.lowerBoundMinutes, aht.upperBoundMinutes);
-    }
+    LOG_DEBUG("\n=== AHT Status ===");
+    LOG_DEBUG("Target: %.1f minutes", aht.targetMinutes);
+    LOG_DEBUG("Range: %.1f - %.1f minutes", aht.lowerBoundMinutes, aht.upperBoundMinutes);
 }
 
 // Debug Methods
+// Queued as log records; the log task does the formatting
 void Hardware::printDebugInfo() {
-    if (!Constants::Debug::ENABLE_SERIAL_DEBUG) return;
-    
-    Serial.println("\n=== Hardware Status ===");
-    Serial.printf("Pattern: %d\n", static_cast<int>(currentPattern));
-    Serial.printf("Paused: %d\n", paused);
-    Serial.printf("Section Complete: %d\n", sectionComplete);
-    Serial.printf("Error State: %d\n", error);
-    if (error) Serial.printf("Last Error: %s\n", lastError.c_str());
+    LOG_DEBUG("\n=== Hardware Status ===");
+    LOG_DEBUG("Pattern: %d", static_cast<int>(currentPattern));
+    LOG_DEBUG("Paused: %d", paused);
+    LOG_DEBUG("Section Complete: %d", sectionComplete);
+    LOG_DEBUG("Error State: %d", error);
+    if (error) LOG_DEBUG("Last Error: %s", lastError.c_str());
     
     printLedStatus();
 }
 
 void Hardware::printLedStatus() {
-    if (!Constants::Debug::ENABLE_SERIAL_DEBUG) return;
-    
     LedStatus status = getLedStatus();
-    Serial.println("LED Status:");
-    Serial.printf("  Red: %s (%.2f)\n", status.redOn ? "ON" : "OFF", status.redBrightness);
-    Serial.printf("  Blue: %s (%.2f)\n", status.blueOn ? "ON" : "OFF", status.blueBrightness);
+    LOG_DEBUG("LED Status:");
+    LOG_DEBUG("  Red: %s (%.2f)", status.redOn ? "ON" : "OFF", status.redBrightness);
+    LOG_DEBUG("  Blue: %s (%.2f)", status.blueOn ? "ON" : "OFF", status.blueBrightness);
 }
 
 void Hardware::printButtonEvent(ButtonEvent event) {
-    if (!Constants::Debug::ENABLE_SERIAL_DEBUG) return;
-    
     const char* eventNames[] = {
         "NONE",
         "SINGLE_PRESS",
@@ -327,58 +357,42 @@ void Hardware::printButtonEvent(ButtonEvent event) {
         "TRIPLE_PRESS"
     };
     
-    Serial.printf("Button Event: %s\n", eventNames[static_cast<int>(event)]);
-}
-
-// Reset Methods
-void Hardware::resetButtonState() {
-    buttonPressCount = 0;
-    longPressActive = false;
-    lastButtonPressTime = 0;
+    LOG_DEBUG("Button Event: %s", eventNames[static_cast<int>(event)]);
 }
 
 Hardware::LedStatus Hardware::getLedStatus() const {
+    // From the animator's shadow: the levels of the current keyframe
+    uint8_t red = leds.level(Ui::LED_RED);
+    uint8_t blue = leds.level(Ui::LED_BLUE);
     return {
-        digitalRead(Constants::Hardware::RED_LED) == LOW,
-        digitalRead(Constants::Hardware::BLUE_LED) == LOW,
-        progressBrightness,
-        speedIndicatorValue,
+        red > 0,
+        blue > 0,
+        red / 255.0f,
+        blue / 255.0f,
         currentPattern
     };
 }
 
 void Hardware::setLedPattern(Pattern pattern) {
+    // The panel re-applies its state every heartbeat; restarting a
+    // looping pattern each time would make it stutter
+    if (pattern == currentPattern && !ledOverride) return;
     currentPattern = pattern;
-    
+    ledOverride = false;
+
     switch (pattern) {
-        case Pattern::ALL_OFF:
-            setPhysicalLed(Constants::Hardware::RED_LED, false);
-            setPhysicalLed(Constants::Hardware::BLUE_LED, false);
-            break;
-            
-        case Pattern::ALL_ON:
-            setPhysicalLed(Constants::Hardware::RED_LED, true);
-            setPhysicalLed(Constants::Hardware::BLUE_LED, true);
-            break;
-            
-        case Pattern::RED_ONLY:
-            setPhysicalLed(Constants::Hardware::RED_LED, true);
-            setPhysicalLed(Constants::Hardware::BLUE_LED, false);
-            break;
-            
-        case Pattern::BLUE_ONLY:
-            setPhysicalLed(Constants::Hardware::RED_LED, false);
-            setPhysicalLed(Constants::Hardware::BLUE_LED, true);
+        case Pattern::PROGRESS_INDICATOR:
+            showProgress();
             break;
-            
-        case Pattern::SYNC_FLASH:
-            // Will be handled in update()
-            lastLedToggle = millis();
-            ledState = false;
+
+        case Pattern::SPEED_INDICATOR:
+            speedShown = nullptr;
+            showSpeed();
             break;
-            
+
         default:
-            // Other patterns will be handled in update()
+            leds.play(ledPattern(pattern));
+            startLeds();
             break;
     }
 }
@@ -387,9 +401,7 @@ Hardware::ButtonEvent Hardware::handleButton() {
     ButtonEvent event = detectButtonEvent();
     
     if (event != ButtonEvent::NONE) {
-        if (Constants::Debug::ENABLE_SERIAL_DEBUG) {
-            printButtonEvent(event);
-        }
+        printButtonEvent(event);
         
         switch (event) {
             case ButtonEvent::SINGLE_PRESS:
@@ -406,9 +418,7 @@ Hardware::ButtonEvent Hardware::handleButton() {
                 
             case ButtonEvent::TRIPLE_PRESS:
                 // Special debug function
-                if (Constants::Debug::ENABLE_SERIAL_DEBUG) {
-                    printDebugInfo();
-                }
+                printDebugInfo();
                 break;
                 
             default:
@@ -424,16 +434,11 @@ void Hardware::reset() {
     sectionComplete = false;
     error = false;
     lastError = "";
-    currentPattern = Pattern::ALL_OFF;
     progressBrightness = 0.0f;
     speedIndicatorValue = 0.0f;
-    resetButtonState();
     
     // Reset physical outputs
-    setPhysicalLed(Constants::Hardware::RED_LED, false);
-    setPhysicalLed(Constants::Hardware::BLUE_LED, false);
+    setLedPattern(Pattern::ALL_OFF);
     
-    if (Constants::Debug::ENABLE_SERIAL_DEBUG) {
-        Serial.println("Hardware reset complete");
-    }
+    LOG_DEBUG("Hardware reset complete");
 }
\ No newline at end of file
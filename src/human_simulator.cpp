@@ -35,11 +35,10 @@ void HumanSimulator::init() {
 }
 
 void HumanSimulator::reset() {
-    currentWord = "";
+    currentWord = Analysis::TextSpan();
     wordsInBurst = 0;
     totalClips = 0;
-    countClips();
-    
+
     // Reset performance metrics
     metrics = {
         .averageWPM = 0.0f,
@@ -47,77 +46,163 @@ void HumanSimulator::reset() {
         .errorRate = 0.0f,
         .correctionRate = 0.0f,
         .speedCompliance = 1.0f,
-        .timeUtilization = 0.0f
+        .timeUtilization = 0.0f,
+        .navigationMillis = 0,
+        .resumeMillis = 0,
+        .wastedKeystrokes = 0
     };
 
-    Serial.println("Human simulator reset complete");
+    LOG_INFO("Human simulator reset complete");
 }
 
 void HumanSimulator::loadTask(const String& videoId) {
     taskInfo.videoId = videoId;
-    countClips();
-    
-    if (totalClips > 0) {
+
+    // A precompiled image skips parsing and analysis entirely
+    if (!loadTaskImage()) {
+        Utils::traceEvent(Utils::TraceEvent::FILE_BEGIN, (uint16_t)Utils::TraceFile::TEXT);
         auto parseResult = Analysis::TextParser::parseFile();
+        Utils::traceEvent(Utils::TraceEvent::FILE_END, (uint16_t)Utils::TraceFile::TEXT,
+                          parseResult.isValid);
+        totalClips = parseResult.clips.size();
+        if (totalClips == 0) {
+            LOG_ERROR("ERROR: %s", parseResult.isValid ? "No clips in text.txt"
+                                                       : parseResult.errorMessage.c_str());
+            return;
+        }
+        LOG_INFO("Found %d total clips", totalClips);
+
         if (!parseResult.isValid) {
-            hardware.setError(true, "Failed to parse video times");
+            ui.publishEvent(Ui::Status::Type::ERROR, "Failed to parse video times");
             return;
         }
 
-        auto durationAnalysis = Timing::DurationCalculator::analyze(parseResult);
-        taskInfo.totalDurationMs = durationAnalysis.totalMillis;
-        
-        // Initialize progress tracker with duration analysis
-        progressTracker.reset(new Timing::ProgressTracker(durationAnalysis));
-        
-        // Configure speed adjuster
-        Timing::SpeedConfig speedCfg;
-        speedCfg.baseWPM = speedConfig.baseWPM;
-        speedCfg.minSpeedFactor = speedConfig.minSpeedFactor;
-        speedCfg.maxSpeedFactor = speedConfig.maxSpeedFactor;
-        speedAdjuster.reset(new Timing::SpeedAdjuster(speedCfg));
-        
-        Serial.printf("Task loaded: %s, Duration: %.1f seconds, Target AHT: %.1f minutes\n",
-                     videoId.c_str(),
-                     taskInfo.totalDurationMs / 1000.0f,
-                     taskInfo.targetAHT);
+        // Duration, validation and metrics come out of a single pass
+        auto analysis = Analysis::TaskAnalyzer::analyze(parseResult);
+        if (!analysis.timingValid) {
+            LOG_WARN("WARNING: %s", analysis.timingError.c_str());
+        }
+
+        taskDuration = Timing::DurationCalculator::fromAnalysis(analysis);
+        taskInfo.difficulty = Analysis::DifficultyScorer::calculate(analysis.metrics).normalizedScore;
+        taskInfo.targetAHT = AHT::Calculator::calculate(taskDuration.totalMillis / 1000.0f).targetMinutes;
+        if (taskInfo.videoId.isEmpty()) taskInfo.videoId = parseResult.videoId;
+
+        // Keep the clip model so processClip() never has to re-read the file
+        clips = std::move(parseResult.clips);
     }
+
+    taskInfo.totalDurationMs = taskDuration.totalMillis;
+    
+    // Initialize progress tracker with duration analysis
+    progressTracker.reset(new Timing::ProgressTracker(taskDuration));
+    
+    // Configure speed adjuster
+    Timing::SpeedConfig speedCfg;
+    speedCfg.baseWPM = speedConfig.baseWPM;
+    speedCfg.minSpeedFactor = speedConfig.minSpeedFactor;
+    speedCfg.maxSpeedFactor = speedConfig.maxSpeedFactor;
+    speedAdjuster.reset(new Timing::SpeedAdjuster(speedCfg));
+    
+    LOG_INFO("Task loaded: %s, Duration: %.1f seconds, Target AHT: %.1f minutes",
+             taskInfo.videoId.c_str(),
+             taskInfo.totalDurationMs / 1000.0f,
+             taskInfo.targetAHT);
 }
 
-void HumanSimulator::processClip(int clipNumber) {
-    if (!validateClipNumber(clipNumber)) return;
+bool HumanSimulator::loadTaskImage() {
+    if (!SPIFFS.exists(Analysis::TaskImage::DEFAULT_PATH)) return false;
+
+    // The image records the size and CRC-32 of the text.txt it was
+    // compiled from, so any edit to the text file invalidates it. Without
+    // a text.txt there is nothing to compare against.
+    Analysis::TaskImage::SourceStamp source;
+    bool haveSource = Analysis::TaskImage::stampSource(Analysis::TextParser::DEFAULT_PATH, source);
+
+    Utils::traceEvent(Utils::TraceEvent::FILE_BEGIN, (uint16_t)Utils::TraceFile::TASK_IMAGE);
+    bool loaded = taskImage.load(Analysis::TaskImage::DEFAULT_PATH, haveSource ? &source : nullptr);
+    Utils::traceEvent(Utils::TraceEvent::FILE_END, (uint16_t)Utils::TraceFile::TASK_IMAGE, loaded);
+    if (!loaded) return false;
+
+    const auto& results = taskImage.results();
+    taskDuration = Timing::DurationAnalysis();
+    taskDuration.totalMillis = results.duration.totalMillis;
+    taskDuration.effectiveMillis = results.duration.effectiveMillis;
+    taskDuration.overlapMillis = results.duration.overlapMillis;
+    taskDuration.gapMillis = results.duration.gapMillis;
+    taskDuration.typingMillis = results.duration.typingMillis;
+    taskDuration.utilizationPercent = results.duration.utilizationPercent;
+
+    if (taskInfo.videoId.isEmpty()) taskInfo.videoId = taskImage.videoId();
+    clips.clear();
+
+    taskInfo.targetAHT = taskImage.aht().targetMinutes;
+    taskInfo.difficulty = results.difficulty.normalizedScore;
+    totalClips = taskImage.clipCount();
+
+    LOG_INFO("Loaded task image (%d clips)", totalClips);
+    return true;
+}
 
-    Serial.printf("\n=== Processing Clip %d ===\n", clipNumber);
-    taskInfo.currentClip = clipNumber;
+bool HumanSimulator::processClip(int clipNumber) {
+    if (!validateClipNumber(clipNumber)) return false;
 
-    // Start progress tracking
-    progressTracker->start();
-    hardware.updateProgress(progressTracker->getSnapshot());
+    LOG_INFO("\n=== Processing Clip %d ===", clipNumber);
+    taskInfo.currentClip = clipNumber;
 
-    // Navigate to clip
-    navigateToClip(clipNumber);
-    if (isPaused) return;
+    // A clip cut off by a dropped link picks up where its output stopped,
+    // already navigated to
+    Hid::OutputJournal::Position from;
+    if (journal.resumeFrom(clipNumber, from)) {
+        if (!resumeOutput(from)) return false;
+    } else {
+        // Start progress tracking
+        progressTracker->start();
+        ui.publishProgress(progressTracker->getSnapshot());
 
-    // Process clip content
-    String content = readClipContent(clipNumber);
-    if (content.length() > 0 && !isPaused) {
-        std::vector<Analysis::TimeFrame> frames = parseTimeframes(content);
-        for (const auto& frame : frames) {
-            processTimeframe(frame);
+        // Navigate to clip
+        if (!navigateToClip(clipNumber)) return false;
+    }
+    if (isPaused) return false;
+
+    // Process clip content straight from the model built at load time
+    // Texts after the first start on a new line, as the clip's lines did
+    // when they were read from text.txt
+    const Analysis::ClipData* clip = getClipData(clipNumber);
+    if (clip && !isPaused) {
+        outputPosition.clip = clipNumber;
+        bool separate = false;
+        if (!clip->mainDescription.isEmpty()) {
+            if (from.timeframe == 0) {
+                outputPosition.timeframe = 0;
+                progressTracker->setPosition(clipNumber, 0);
+                if (!typeText(clip->mainDescription, from.offset)) return false;
+            }
+            separate = true;
+        }
+        for (size_t i = 0; i < clip->timeframes.size(); i++) {
             if (isPaused) break;
+            const Analysis::TimeFrame& frame = clip->timeframes[i];
+            bool hasText = frame.type == Analysis::TimeFrame::Type::TYPING && !frame.content.isEmpty();
+            uint16_t timeframe = i + 1;
+            if (timeframe >= from.timeframe) {
+                outputPosition.timeframe = timeframe;
+                progressTracker->setPosition(clipNumber, timeframe);
+                size_t offset = timeframe == from.timeframe ? from.offset : 0;
+                if (!processTimeframe(frame, offset, separate)) return false;
+            }
+            separate |= hasText;
         }
     }
 
-    // Update completion status
-    if (!isPaused) {
-        hardware.setSectionComplete(true);
-        hardware.playSound(Hardware::SoundType::SECTION_COMPLETE);
-        logProgress();
-    }
+    // The caller marks the section complete
+    if (isPaused) return false;
+    logProgress();
+    return true;
 }
 
-void HumanSimulator::processTimeframe(const Analysis::TimeFrame& frame) {
-    progressTracker->start();
+bool HumanSimulator::processTimeframe(const Analysis::TimeFrame& frame, size_t from, bool separate) {
+    if (from == 0) progressTracker->start();
 
     switch (frame.type) {
         case Analysis::TimeFrame::Type::CAMERA_MOVEMENT:
@@ -128,30 +213,59 @@ void HumanSimulator::processTimeframe(const Analysis::TimeFrame& frame) {
             break;
         case Analysis::TimeFrame::Type::TYPING:
             if (!frame.content.isEmpty()) {
-                typeText(frame.content);
+                return typeText(frame.content, from, separate);
             }
             break;
         default:
             break;
     }
+    return true;
 }
 
-void HumanSimulator::typeText(const String& text) {
-    if (text.isEmpty()) return;
+bool HumanSimulator::typeText(const String& text, size_t from, bool separate) {
+    if (text.length() <= from) return true;
 
-    currentWord = "";
+    currentWord = Analysis::TextSpan();
     wordsInBurst = 0;
-    
-    for (char c : text) {
-        if (isPaused) return;
+
+    // Punctuation positions are found once, not rescanned per character
+    pauseMap.build(text);
+
+    // The behaviour model below compiles the text into keystroke programs
+    // (keys and waits), one word at a time. Each word is played as soon as
+    // it is compiled, and the keyboard's queue keeps the next one from
+    // running ahead. So fatigue, speed adjustment and pauses see the
+    // typing as it happens, and a pause stops mid-text. Checkpoints carry
+    // text offsets for the output journal.
+    uint32_t checkpointsBefore = keyboard.getDelivery().checkpointCount;
+    uint32_t carried = program.takePendingWait();
+    program.clear();
+    program.checkpoint(from);
+
+    // The separator counts as output past the leading checkpoint, so a
+    // resume from offset 0 erases and retypes it with the first word. It
+    // follows the pause after the last text's final punctuation.
+    if (separate && from == 0) {
+        if (carried > 0) program.wait(carried);
+        program.key('\n');
+        simulateTypingDelay();
+    }
+
+    // Words are views into text, so no keystroke touches the heap
+    const char* chars = text.c_str();
+    for (size_t i = from; i < text.length(); i++) {
+        char c = chars[i];
+        if (isPaused) break;
 
         // Handle word boundaries
         if (c == ' ' || c == '\n') {
             if (!currentWord.isEmpty()) {
                 handleWord(currentWord);
-                currentWord = "";
+                program.checkpoint(i);
+                handleNaturalPauses(currentWord.data - chars, i);
+                currentWord = Analysis::TextSpan();
                 wordsInBurst++;
-                
+
                 // Check for natural breaks
                 if (wordsInBurst >= behaviorConfig.maxWordsBeforeBreak) {
                     simulateThinking();
@@ -160,40 +274,115 @@ void HumanSimulator::typeText(const String& text) {
             }
 
             // Handle possible double space
-            if (random(100) < Constants::HumanBehavior::DOUBLE_SPACE_CHANCE * 100) {
-                keyboard.type(" ");
+            if (rng.chance(Constants::HumanBehavior::DOUBLE_SPACE_CHANCE)) {
+                program.key(' ');
                 simulateTypingDelay();
             }
             
-            keyboard.type(String(c));
+            program.key(c);
             simulateTypingDelay();
             
         } else {
-            currentWord += c;
+            if (currentWord.isEmpty()) currentWord.data = chars + i;
+            currentWord.length++;
         }
 
         // Update simulation state
         applyFatigue();
         updatePerformanceMetrics();
         adjustTypingSpeed();
-        
-        // Handle natural pauses
-        handleNaturalPauses(text);
+
+        if ((c == ' ' || c == '\n') && !playChunk()) break;
+    }
+
+    // Handle final word; its pause is left pending for the next text
+    bool finalWord = !currentWord.isEmpty() && !isPaused && !keyboard.isInterrupted();
+    if (finalWord) handleWord(currentWord);
+    program.checkpoint(text.length());
+    if (finalWord) handleNaturalPauses(currentWord.data - chars, text.length());
+
+    if (!isPaused && playChunk() && keyboard.flush() && !keyboard.isInterrupted() && !isPaused) {
+        return true;
     }
 
-    // Handle final word
-    if (!currentWord.isEmpty() && !isPaused) {
-        handleWord(currentWord);
+    // A pause (the button task runs whenever we sleep) is journaled like
+    // a lost link, so resuming continues from the last word sent
+    recordInterruption(from, checkpointsBefore);
+    return false;
+}
+
+bool HumanSimulator::playChunk() {
+    if (isPaused || keyboard.isInterrupted()) return false;
+
+    // A pause at the end of the chunk leads the next one instead
+    uint32_t carried = program.takePendingWait();
+    program.end();
+    keyboard.play(program);
+    program.clear();
+    if (carried > 0) program.wait(carried);
+    return !keyboard.isInterrupted() && !isPaused;
+}
+
+void HumanSimulator::recordInterruption(uint32_t from, uint32_t checkpointsBefore) {
+    auto delivery = keyboard.abandonOutput();
+
+    // If not even the program's leading checkpoint was reached, none of
+    // it went out and the last checkpoint belongs to earlier output
+    bool started = delivery.checkpointCount != checkpointsBefore;
+    outputPosition.offset = started ? delivery.checkpoint : from;
+    uint16_t keysLost = started ? delivery.keysSinceCheckpoint : 0;
+    uint16_t erase = started ? max<int16_t>(0, delivery.charsSinceCheckpoint) : 0;
+    journal.record(outputPosition, keysLost, erase);
+    metrics.wastedKeystrokes = journal.getStats().wastedKeystrokes;
+
+    LOG_WARN("Output interrupted: clip %d, timeframe %u, offset %lu (%u keys past it)",
+             outputPosition.clip, outputPosition.timeframe,
+             (unsigned long)outputPosition.offset, keysLost);
+}
+
+bool HumanSimulator::resumeOutput(const Hid::OutputJournal::Position& from) {
+    unsigned long start = millis();
+    uint16_t erase = journal.getPendingErase();
+    LOG_INFO("Resuming clip %d at timeframe %u, offset %lu",
+             from.clip, from.timeframe, (unsigned long)from.offset);
+
+    // Take back what was typed of the word the link dropped in
+    if (erase > 0) {
+        program.clear();
+        for (uint16_t left = erase; left > 0; ) {
+            uint8_t n = min<uint16_t>(left, UINT8_MAX);
+            program.repeat(KEY_BACKSPACE, n);
+            left -= n;
+        }
+        program.end();
+        keyboard.play(program);
+
+        if (!keyboard.flush() || keyboard.isInterrupted() || isPaused) {
+            // Dropped or paused again: whatever was not erased is still to do
+            auto delivery = keyboard.abandonOutput();
+            journal.record(from, delivery.keysSinceCheckpoint,
+                           max<int>(0, erase + delivery.charsSinceCheckpoint));
+            metrics.wastedKeystrokes = journal.getStats().wastedKeystrokes;
+            return false;
+        }
     }
+
+    journal.resumed(millis() - start);
+    const auto& stats = journal.getStats();
+    metrics.resumeMillis = stats.lastResumeMillis;
+    metrics.wastedKeystrokes = stats.wastedKeystrokes;
+    LOG_INFO("Resumed after %lu ms offline in %lu ms, %u keys erased",
+             (unsigned long)stats.lastOutageMillis, (unsigned long)stats.lastResumeMillis, erase);
+    return true;
 }
 
-void HumanSimulator::handleWord(const String& word) {
+void HumanSimulator::handleWord(Analysis::TextSpan word) {
     // Calculate typo probability
     float typoChance = behaviorConfig.typoChance;
     typoChance *= (1.0f + behavior.fatigueLevel);  // Increase with fatigue
     typoChance *= (2.0f - behavior.alertnessLevel);  // Decrease with alertness
 
-    if (random(100) < typoChance * 100) {
+    if (rng.chance(typoChance)) {
         makeTypo(word);
     } else {
         typeWordNormally(word);
@@ -204,20 +393,29 @@ void HumanSimulator::handleWord(const String& word) {
     updateAlertness();
 }
 
-void HumanSimulator::makeTypo(const String& word) {
-    int wordLen = word.length();
-    int typoPos = random(wordLen);
+void HumanSimulator::typeWordNormally(Analysis::TextSpan word) {
+    for (size_t i = 0; i < word.length; i++) {
+        if (isPaused) return;
+        program.key(word.data[i]);
+        simulateTypingDelay();
+    }
+    behavior.consecutiveErrors = 0;
+}
+
+void HumanSimulator::makeTypo(Analysis::TextSpan word) {
+    int wordLen = word.length;
+    int typoPos = rng.below(wordLen);
     
     // Type up to typo
     for (int i = 0; i < typoPos; i++) {
         if (isPaused) return;
-        keyboard.type(String(word[i]));
+        program.key(word.data[i]);
         simulateTypingDelay();
     }
     
     // Make typo
-    char wrongChar = getRandomTypo(word[typoPos]);
-    keyboard.type(String(wrongChar));
+    char wrongChar = getRandomTypo(word.data[typoPos]);
+    program.key(wrongChar);
     
     // Decide whether to correct
     bool shouldCorrect = decideCorrectionStrategy(word, typoPos);
@@ -226,7 +424,9 @@ void HumanSimulator::makeTypo(const String& word) {
         correctTypo(word, typoPos);
     } else {
         // Continue with remaining characters
-        keyboard.type(word.substring(typoPos + 1));
+        for (size_t i = typoPos + 1; i < word.length; i++) {
+            program.key(word.data[i]);
+        }
     }
 
     // Update error tracking
@@ -234,28 +434,28 @@ void HumanSimulator::makeTypo(const String& word) {
     metrics.errorRate = (behavior.consecutiveErrors * 1.0f) / metrics.averageWPM;
 }
 
-void HumanSimulator::correctTypo(const String& word, int typoPos) {
-    delay(Constants::Typing::CORRECTION_DELAY);
-    keyboard.pressKey(KEY_BACKSPACE);
-    delay(Constants::Typing::CORRECTION_DELAY);
-    keyboard.type(String(word[typoPos]));
+void HumanSimulator::correctTypo(Analysis::TextSpan word, int typoPos) {
+    program.wait(Constants::Typing::CORRECTION_DELAY);
+    program.key(KEY_BACKSPACE);
+    program.wait(Constants::Typing::CORRECTION_DELAY);
+    program.key(word.data[typoPos]);
     
     // Complete the word
-    for (int i = typoPos + 1; i < word.length(); i++) {
+    for (size_t i = typoPos + 1; i < word.length; i++) {
         if (isPaused) return;
-        keyboard.type(String(word[i]));
+        program.key(word.data[i]);
         simulateTypingDelay();
     }
 
     metrics.correctionRate++;
 }
 
-bool HumanSimulator::decideCorrectionStrategy(const String& word, int typoPos) {
+bool HumanSimulator::decideCorrectionStrategy(Analysis::TextSpan word, int typoPos) {
     // Base correction probability
     float correctionProb = behaviorConfig.correctionChance;
     
     // Adjust based on word length
-    if (word.length() < Constants::HumanBehavior::UNCORRECTED_TYPO_THRESHOLD) {
+    if (word.length < Constants::HumanBehavior::UNCORRECTED_TYPO_THRESHOLD) {
         correctionProb += 0.2f;
     }
     
@@ -267,7 +467,7 @@ bool HumanSimulator::decideCorrectionStrategy(const String& word, int typoPos) {
     // Adjust based on alertness
     correctionProb *= behavior.alertnessLevel;
     
-    return random(100) < correctionProb * 100;
+    return rng.chance(correctionProb);
 }
 
 void HumanSimulator::simulateTypingDelay() {
@@ -283,21 +483,30 @@ void HumanSimulator::simulateTypingDelay() {
     
     // Add natural variance
     int finalDelay = baseDelay * fatigueModifier * alertnessModifier;
-    finalDelay += random(-finalDelay/4, finalDelay/4);
+    finalDelay += rng.between(-finalDelay/4, finalDelay/4);
     
-    delay(max(finalDelay, Constants::Typing::BASE_CHAR_DELAY/2));
+    program.wait(max(finalDelay, Constants::Typing::BASE_CHAR_DELAY/2));
+}
+
+void HumanSimulator::applyFatigue() {
+    // Grows by FATIGUE_FACTOR over each run of MAX_WORDS_BEFORE_BREAK
+    // words without a break, up to MAX_FATIGUE_LEVEL; a break in
+    // simulateThinking() takes RECOVERY_RATE off and starts a new run
+    float run = (float)behavior.wordsWithoutBreak / Constants::HumanBehavior::MAX_WORDS_BEFORE_BREAK;
+    float level = max(behavior.fatigueLevel, Constants::HumanBehavior::FATIGUE_FACTOR * run);
+    behavior.fatigueLevel = min(level, Constants::HumanBehavior::MAX_FATIGUE_LEVEL);
 }
 
 void HumanSimulator::simulateThinking() {
     if (isPaused) return;
     
-    if (random(100) < behaviorConfig.thinkingFrequency * 100) {
-        int thinkingTime = random(
+    if (rng.chance(behaviorConfig.thinkingFrequency)) {
+        int thinkingTime = rng.between(
             Constants::HumanBehavior::MIN_THINKING_PAUSE,
             Constants::HumanBehavior::MAX_THINKING_PAUSE
         );
         
-        delay(thinkingTime);
+        program.wait(thinkingTime);
         behavior.lastBreakTime = millis();
         behavior.wordsWithoutBreak = 0;
         
@@ -307,36 +516,62 @@ void HumanSimulator::simulateThinking() {
     }
 }
 
-void HumanSimulator::handleNaturalPauses(const String& text) {
-    // Pause at punctuation
-    if (text.indexOf('.') >= 0 || text.indexOf('!') >= 0 || text.indexOf('?') >= 0) {
-        delay(Constants::Typing::SENTENCE_PAUSE);
-    }
-    // Pause at commas
-    else if (text.indexOf(',') >= 0) {
-        delay(Constants::Typing::WORD_PAUSE);
+void HumanSimulator::handleNaturalPauses(size_t start, size_t end) {
+    // Called once the word's keys are compiled, so the pause follows the
+    // punctuation instead of leading the word
+    for (size_t position = start; position < end; position++) {
+        switch (pauseMap.at(position)) {
+            case Utils::PauseMap::Pause::SENTENCE:  // After . ! ?
+                program.wait(Constants::Typing::SENTENCE_PAUSE);
+                break;
+            case Utils::PauseMap::Pause::WORD:      // After commas
+                program.wait(Constants::Typing::WORD_PAUSE);
+                break;
+            default:
+                break;
+        }
     }
 }
 
-void HumanSimulator::navigateToClip(int clipNumber) {
+bool HumanSimulator::navigateToClip(int clipNumber) {
     int tabCount = (clipNumber == 1) ? 
         Constants::Navigation::FIRST_CLIP_TAB_COUNT :
         Constants::Navigation::NEXT_CLIP_TAB_COUNT;
     
-    keyboard.navigateWithSpeed(tabCount, 
-        behavior.alertnessLevel * speedAdjuster->getCurrentSpeedFactor());
+    if (Constants::Navigation::BURST_NAVIGATION) {
+        auto result = keyboard.navigateBurst(tabCount);
+        metrics.navigationMillis = result.latencyMillis;
+        if (result.keys > 0) {
+            LOG_INFO("Navigation to clip %d: %d keys in %lu ms%s",
+                     clipNumber, result.keys, (unsigned long)result.latencyMillis,
+                     result.completed ? "" : " (timed out)");
+        }
+    } else {
+        keyboard.navigateWithSpeed(tabCount, 
+            behavior.alertnessLevel * speedAdjuster->getCurrentSpeedFactor());
+        keyboard.flush();
+    }
+
+    // Navigation is not journaled: cut short, the clip starts over
+    if (keyboard.isInterrupted() || !keyboard.isConnected() || isPaused) {
+        keyboard.abandonOutput();
+        LOG_WARN("Navigation to clip %d interrupted", clipNumber);
+        return false;
+    }
+    return true;
 }
 
 void HumanSimulator::updatePerformanceMetrics() {
     auto snapshot = progressTracker->getSnapshot();
     
-    metrics.currentWPM = keyboard.getTypingStats().currentWPM;
-    metrics.averageWPM = keyboard.getTypingStats().averageWPM;
+    auto typing = keyboard.getTypingStats();
+    metrics.currentWPM = typing.currentWPM;
+    metrics.averageWPM = typing.averageWPM;
     metrics.speedCompliance = snapshot.compliance.speedDeviation;
     metrics.timeUtilization = snapshot.compliance.timeUtilization;
     
-    // Update hardware display
-    hardware.updateProgress(snapshot);
+    // LEDs and warning beeps on the UI core
+    ui.publishProgress(snapshot);
 }
 
 void HumanSimulator::adjustTypingSpeed() {
@@ -350,64 +585,6 @@ void HumanSimulator::adjustTypingSpeed() {
     metrics.currentWPM = speedConfig.baseWPM * speedAdjustment;
 }
 
-void HumanSimulator::countClips() {
-    File file = SPIFFS.open("/text.txt", "r");
-    if (!file) {
-        Serial.println("ERROR: Failed to open text.txt");
-        return;
-    }
-
-    totalClips = 0;
-    while (file.available()) {
-        String line = file.readStringUntil('\n');
-        if (line.indexOf("Clip #") >= 0) {
-            totalClips++;
-        }
-    }
-    
-    file.close();
-    Serial.printf("Found %d total clips\n", totalClips);
-}
-
-String HumanSimulator::readClipContent(int clipNumber) {
-    File file = SPIFFS.open("/text.txt", "r");
-    if (!file) {
-        Serial.println("ERROR: Failed to open text.txt");
-        return "";
-    }
-
-    String clipContent = "";
-    bool isReadingClip = false;
-    int currentClip = 0;
-
-    while (file.available()) {
-        String line = file.readStringUntil('\n');
-        line.trim();
-
-        if (line.indexOf("Clip #") >= 0) {
-            currentClip++;
-            if (currentClip == clipNumber) {
-                isReadingClip = true;
-                continue;
-            } else if (isReadingClip) {
-                break;
-            }
-        } else if (isReadingClip && line.length() > 0) {
-            clipContent += line + "\n";
-        }
-    }
-    
-    file.close();
-    
-    if (clipContent.length() > 0) {
-        Serial.printf("Found clip content (%d characters)\n", clipContent.length());
-    } else {
-        Serial.println("WARNING: No content found for clip");
-    }
-    
-    return clipContent;
-}
-
 void HumanSimulator::logProgress() {
     if (!Constants::Debug::ENABLE_SERIAL_DEBUG) return;
 
@@ -415,42 +592,59 @@ void HumanSimulator::logProgress() {
     auto behavior = getBehaviorState();
     auto perf = getPerformanceMetrics();
 
-    Serial.println("\n=== Progress Report ===");
-    Serial.printf("Time Elapsed: %lu ms\n", progress.elapsedMillis);
-    Serial.printf("Progress: %.1f%%\n", progress.percentComplete);
-    Serial.printf("Current WPM: %.1f\n", perf.currentWPM);
-    Serial.printf("Average WPM: %.1f\n", perf.averageWPM);
-    Serial.printf("Error Rate: %.2f%%\n", perf.errorRate * 100);
+    LOG_DEBUG("\n=== Progress Report ===");
+    LOG_DEBUG("Time Elapsed: %lu ms", (unsigned long)progress.elapsedMillis);
+    LOG_DEBUG("Progress: %.1f%%", progress.percentComplete);
+    if (progress.clipNumber > 0) {
+        LOG_DEBUG("Typing Position: clip %d, timeframe %d",
+                  progress.clipNumber, progress.timeframe);
+    }
+    LOG_DEBUG("Current WPM: %.1f", perf.currentWPM);
+    LOG_DEBUG("Average WPM: %.1f", perf.averageWPM);
+    auto typing = keyboard.getTypingStats();
+    LOG_DEBUG("Key Interval: p50 %lu ms, p95 %lu ms (smoothed %.1f WPM)",
+              (unsigned long)typing.p50IntervalMillis, (unsigned long)typing.p95IntervalMillis,
+              typing.smoothedWPM);
+    LOG_DEBUG("Error Rate: %.2f%%", perf.errorRate * 100);
+    LOG_DEBUG("Navigation Latency: %lu ms", (unsigned long)perf.navigationMillis);
+    if (journal.getStats().interruptions > 0) {
+        LOG_DEBUG("Interruptions: %lu, last resume %lu ms, %lu keys wasted",
+                  (unsigned long)journal.getStats().interruptions,
+                  (unsigned long)perf.resumeMillis, (unsigned long)perf.wastedKeystrokes);
+    }
     
-    Serial.println("\n=== Behavioral State ===");
-    Serial.printf("Fatigue: %.2f\n", behavior.fatigueLevel);
-    Serial.printf("Alertness: %.2f\n", behavior.alertnessLevel);
-    Serial.printf("Confidence: %.2f\n", behavior.confidenceLevel);
+    LOG_DEBUG("\n=== Behavioral State ===");
+    LOG_DEBUG("Fatigue: %.2f", behavior.fatigueLevel);
+    LOG_DEBUG("Alertness: %.2f", behavior.alertnessLevel);
+    LOG_DEBUG("Confidence: %.2f", behavior.confidenceLevel);
     
-    Serial.println("\n=== Time Compliance ===");
-    Serial.printf("Time Utilization: %.1f%%\n", perf.timeUtilization);
-    Serial.printf("Speed Compliance: %.1f%%\n", perf.speedCompliance);
+    LOG_DEBUG("\n=== Time Compliance ===");
+    LOG_DEBUG("Time Utilization: %.1f%%", perf.timeUtilization);
+    LOG_DEBUG("Speed Compliance: %.1f%%", perf.speedCompliance);
 }
 
 bool HumanSimulator::validateClipNumber(int clipNumber) {
     if (clipNumber < 1 || clipNumber > totalClips) {
-        Serial.printf("ERROR: Invalid clip number %d (total clips: %d)\n", 
-                     clipNumber, totalClips);
+        LOG_ERROR("ERROR: Invalid clip number %d (total clips: %d)",
+                  clipNumber, totalClips);
         return false;
     }
     return true;
 }
 
 void HumanSimulator::pause() {
+    if (isPaused) return;
     isPaused = true;
-    progressTracker->pause();
-    Serial.println("Simulation paused");
+    keyboard.cancelPending();
+    if (progressTracker) progressTracker->pause();
+    LOG_INFO("Simulation paused");
 }
 
 void HumanSimulator::resume() {
+    if (!isPaused) return;
     isPaused = false;
-    progressTracker->resume();
-    Serial.println("Simulation resumed");
+    if (progressTracker) progressTracker->resume();
+    LOG_INFO("Simulation resumed");
 }
 
 bool HumanSimulator::isComplete() const {
@@ -469,6 +663,10 @@ HumanSimulator::PerformanceMetrics HumanSimulator::getPerformanceMetrics() const
     return metrics;
 }
 
+Timing::ProgressSnapshot HumanSimulator::getProgress() const {
+    return progressTracker ? progressTracker->getSnapshot() : Timing::ProgressSnapshot();
+}
+
 void HumanSimulator::updateAlertness() {
     // Decrease alertness with consecutive errors
     if (behavior.consecutiveErrors > 0) {
@@ -500,15 +698,23 @@ char HumanSimulator::getRandomTypo(char originalChar) {
     for (const auto& map : keyMaps) {
         if (map.key == lowerChar) {
             int len = strlen(map.adjacent);
-            return map.adjacent[random(len)];
+            return map.adjacent[rng.below(len)];
         }
     }
     
-    return 'a' + random(26);  // Fallback to random letter
+    return 'a' + rng.below(26);  // Fallback to random letter
 }
 
-std::vector<Analysis::TimeFrame> HumanSimulator::parseTimeframes(const String& content) {
-    std::vector<Analysis::TimeFrame> frames;
-    // Implementation here
-    return frames;
+const Analysis::ClipData* HumanSimulator::getClipData(int clipNumber) {
+    if (clipNumber >= 1 && clipNumber <= (int)clips.size()) {
+        return &clips[clipNumber - 1];
+    }
+
+    // Image-backed tasks materialize one clip at a time
+    if (taskImage.isLoaded() && taskImage.loadClip(clipNumber, imageClip)) {
+        return &imageClip;
+    }
+
+    LOG_WARN("WARNING: No content found for clip %d", clipNumber);
+    return nullptr;
 }
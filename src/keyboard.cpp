@@ -1,97 +1,316 @@
 #include "keyboard.h"
 
-void Keyboard::init() {
-    bleKeyboard.begin();
+// Named keys must land on the right usages in Hid::KeyMap
+static_assert(Hid::KeyMap::lookup(KEY_TAB).usage == 0x2B, "KEY_TAB usage");
+static_assert(Hid::KeyMap::lookup(KEY_BACKSPACE).usage == 0x2A, "KEY_BACKSPACE usage");
+static_assert(Hid::KeyMap::lookup(KEY_RETURN).usage == 0x28, "KEY_RETURN usage");
+static_assert(Hid::KeyMap::lookup(KEY_LEFT_SHIFT).modifiers == Hid::Modifier::LEFT_SHIFT,
+              "KEY_LEFT_SHIFT modifier bit");
+static_assert(sizeof(KeyReport) == 8, "Boot keyboard report");
+
+template<typename Transport>
+void BasicKeyboard<Transport>::init(OutputMode mode) {
+    transport.begin();
     resetStats();
+    reports.setMinSpacing(reportSpacingMicros);
+
+    // The transport is only touched from the output loop from here on
+    if (mode == OutputMode::SCHEDULER) {
+        Utils::Scheduler::instance().add("hid_output", scheduledOutput, this);
+        return;
+    }
+    xTaskCreatePinnedToCore(outputTask, "hid_output",
+                            Constants::Hid::OUTPUT_TASK_STACK, this,
+                            Constants::Hid::OUTPUT_TASK_PRIORITY, &outputTaskHandle,
+                            Constants::Hid::OUTPUT_TASK_CORE);
 }
 
-bool Keyboard::isConnected() {
-    return bleKeyboard.isConnected();
+template<typename Transport>
+bool BasicKeyboard<Transport>::isConnected() {
+    return transport.isConnected();
 }
 
-void Keyboard::type(const String& text, float speedMultiplier) {
-    if (!isConnected()) return;
-    
-    int adjustedDelay = calculateDelay() / speedMultiplier;
-    
-    for (char c : text) {
-        unsigned long currentTime = millis();
-        if (currentTime - lastTypeTime < adjustedDelay) {
-            delay(adjustedDelay - (currentTime - lastTypeTime));
-        }
-        
-        bleKeyboard.write(c);
-        updateStats(c);
-        lastTypeTime = millis();
+template<typename Transport>
+void BasicKeyboard<Transport>::setReportSpacing(uint32_t micros) {
+    reportSpacingMicros = micros;
+}
+
+template<typename Transport>
+void BasicKeyboard<Transport>::type(const String& text, float speedMultiplier) {
+    type(text.c_str(), text.length(), speedMultiplier);
+}
+
+template<typename Transport>
+void BasicKeyboard<Transport>::type(const char* text, size_t length, float speedMultiplier) {
+    cancelRequested = false;
+    for (size_t i = 0; i < length; i++) {
+        if (typeChar(text[i], speedMultiplier) == 0) return;
     }
 }
 
-void Keyboard::pressKey(uint8_t key) {
+template<typename Transport>
+void BasicKeyboard<Transport>::type(char c, float speedMultiplier) {
+    cancelRequested = false;
+    typeChar(c, speedMultiplier);
+}
+
+template<typename Transport>
+size_t BasicKeyboard<Transport>::typeChar(char c, float speedMultiplier) {
+    if (!isConnected()) return 0;
+    
+    // Pacing moved to the output task: the gap is enforced there
+    uint16_t gap = calculateDelay() / speedMultiplier;
+    return enqueue(Hid::KeyEvent::Action::WRITE, c, gap) != 0;
+}
+
+template<typename Transport>
+void BasicKeyboard<Transport>::pressKey(uint8_t key) {
     if (isConnected()) {
-        bleKeyboard.write(key);
+        enqueue(Hid::KeyEvent::Action::WRITE, key);
     }
 }
 
-void Keyboard::releaseKey(uint8_t key) {
+template<typename Transport>
+void BasicKeyboard<Transport>::releaseKey(uint8_t key) {
     if (isConnected()) {
-        bleKeyboard.release(key);
+        enqueue(Hid::KeyEvent::Action::RELEASE, key);
+    }
+}
+
+template<typename Transport>
+void BasicKeyboard<Transport>::play(const uint8_t* code, size_t length) {
+    // Not checking isConnected(): while the link is down keys are held, and
+    // the program is abandoned once the queue fills (see isInterrupted())
+    cancelRequested = false;
+    ProgramSink sink{*this};
+    uint16_t pace = calculateDelay() / currentSpeedMultiplier;
+    Hid::KeystrokeVM::run(code, length, sink, pace);
+}
+
+template<typename Transport>
+uint32_t BasicKeyboard<Transport>::lastCheckpoint() const {
+    return output.getLastCheckpoint();
+}
+
+template<typename Transport>
+void BasicKeyboard<Transport>::ProgramSink::key(uint8_t k, uint16_t gap) {
+    keyboard.enqueue(Hid::KeyEvent::Action::WRITE, k, gap);
+}
+
+template<typename Transport>
+void BasicKeyboard<Transport>::ProgramSink::press(uint8_t k, uint16_t gap) {
+    keyboard.enqueue(Hid::KeyEvent::Action::PRESS, k, gap);
+}
+
+template<typename Transport>
+void BasicKeyboard<Transport>::ProgramSink::release(uint8_t k, uint16_t gap) {
+    keyboard.enqueue(Hid::KeyEvent::Action::RELEASE, k, gap);
+}
+
+template<typename Transport>
+void BasicKeyboard<Transport>::ProgramSink::releaseAll(uint16_t gap) {
+    keyboard.enqueue(Hid::KeyEvent::Action::RELEASE_ALL, 0, gap);
+}
+
+template<typename Transport>
+void BasicKeyboard<Transport>::ProgramSink::checkpoint(uint32_t id) {
+    keyboard.enqueue(Hid::KeyEvent::Action::CHECKPOINT, 0, id);
+}
+
+template<typename Transport>
+bool BasicKeyboard<Transport>::flush(uint32_t timeoutMs) {
+    unsigned long start = millis();
+    while (!output.isIdle()) {
+        if (output.isStalled()) {
+            interrupted = true;
+            return false;
+        }
+        if (millis() - start >= timeoutMs) return false;
+        Utils::sleepFor(1);
+    }
+    return true;
+}
+
+template<typename Transport>
+void BasicKeyboard<Transport>::cancelPending() {
+    cancelRequested = true;
+    output.cancelPending();
+}
+
+template<typename Transport>
+size_t BasicKeyboard<Transport>::pendingKeys() const {
+    return output.pending();
+}
+
+template<typename Transport>
+bool BasicKeyboard<Transport>::isInterrupted() const {
+    return interrupted || output.isStalled();
+}
+
+template<typename Transport>
+typename BasicKeyboard<Transport>::Delivery BasicKeyboard<Transport>::getDelivery() const {
+    Delivery delivery;
+    delivery.checkpointCount = output.getCheckpointCount();
+    delivery.checkpoint = output.getLastCheckpoint();
+    delivery.keysSinceCheckpoint = output.getKeysSinceCheckpoint();
+    delivery.charsSinceCheckpoint = output.getCharsSinceCheckpoint();
+    return delivery;
+}
+
+template<typename Transport>
+typename BasicKeyboard<Transport>::Delivery BasicKeyboard<Transport>::abandonOutput() {
+    // Cancelled keys are discarded even while disconnected, so this drains
+    output.cancelPending();
+    while (!output.isIdle()) Utils::sleepFor(1);
+
+    Delivery delivery = getDelivery();
+    output.resetSinceCheckpoint();
+    interrupted = false;
+    return delivery;
+}
+
+template<typename Transport>
+uint32_t BasicKeyboard<Transport>::enqueue(Hid::KeyEvent::Action action, uint8_t key, uint32_t value) {
+    // Backpressure: wait for the output task to free a slot, unless it is
+    // stuck on a lost link
+    if (interrupted || cancelRequested) return 0;
+    uint32_t ticket;
+    while ((ticket = output.enqueue(action, key, value)) == 0) {
+        if (output.isStalled()) {
+            interrupted = true;
+            return 0;
+        }
+        // Other main loop tasks (button, LEDs) run while we wait
+        Utils::sleepFor(1);
+        if (cancelRequested) return 0;
+    }
+    Utils::traceEvent(Utils::TraceEvent::QUEUE_DEPTH, 0, output.pending());
+    return ticket;
+}
+
+template<typename Transport>
+size_t BasicKeyboard<Transport>::StatsSink::write(uint8_t key) {
+    size_t n = keyboard.reports.write(key);
+    if (n > 0) Utils::traceEvent(Utils::TraceEvent::KEY_EMIT, key, keyboard.output.pending());
+    // Typed characters only; navigation and editing keys are not typing speed
+    if (n > 0 && key < 0x80) {
+        keyboard.stats.record(key, millis());
+        keyboard.publishedStats.store(keyboard.stats.snapshot());
+    }
+    return n;
+}
+
+template<typename Transport>
+uint32_t BasicKeyboard<Transport>::serviceOutput() {
+    if (statsResetRequested.exchange(false, std::memory_order_acquire)) {
+        stats.reset();
+        publishedStats.store(TypingStats());
+    }
+
+    uint32_t now = millis();
+    while (output.service(now)) now = millis();
+
+    uint32_t wait = output.isStalled() ? UINT32_MAX : output.millisUntilDue(now);
+    return wait == 0 ? 1 : min(wait, (uint32_t)Constants::Hid::OUTPUT_IDLE_POLL);
+}
+
+template<typename Transport>
+void BasicKeyboard<Transport>::outputTask(void* param) {
+    BasicKeyboard* keyboard = static_cast<BasicKeyboard*>(param);
+    for (;;) {
+        vTaskDelay(pdMS_TO_TICKS(keyboard->serviceOutput()));
     }
 }
 
-void Keyboard::navigate(int tabCount) {
+template<typename Transport>
+uint32_t BasicKeyboard<Transport>::scheduledOutput(void* param) {
+    return static_cast<BasicKeyboard*>(param)->serviceOutput();
+}
+
+template<typename Transport>
+void BasicKeyboard<Transport>::navigate(int tabCount) {
     navigateWithSpeed(tabCount, 1.0f);
 }
 
-void Keyboard::navigateWithSpeed(int tabCount, float speedMultiplier) {
+template<typename Transport>
+void BasicKeyboard<Transport>::navigateWithSpeed(int tabCount, float speedMultiplier) {
     if (!isConnected()) return;
+    cancelRequested = false;
     
     for (int i = 0; i < tabCount; i++) {
-        pressKey(KEY_TAB);
-        simulateTabDelay();
+        uint16_t gap = rng->between(Constants::Navigation::MIN_TAB_DELAY,
+                                    Constants::Navigation::MAX_TAB_DELAY);
+        enqueue(Hid::KeyEvent::Action::WRITE, KEY_TAB, gap);
     }
 }
 
-void Keyboard::simulateTabDelay() {
-    delay(random(Constants::Navigation::MIN_TAB_DELAY, 
-                 Constants::Navigation::MAX_TAB_DELAY));
+template<typename Transport>
+typename BasicKeyboard<Transport>::NavigationResult BasicKeyboard<Transport>::navigateBurst(int tabCount, uint8_t key) {
+    NavigationResult result;
+    if (!isConnected() || tabCount <= 0) {
+        lastNavigation = result;
+        return result;
+    }
+
+    // Let earlier typing drain so the latency covers navigation only
+    flush(Constants::Hid::NAVIGATION_TIMEOUT);
+    cancelRequested = false;
+
+    unsigned long start = millis();
+    uint32_t ticket = 0;
+    int queued = 0;
+    for (; queued < tabCount; queued++) {
+        uint32_t next = enqueue(Hid::KeyEvent::Action::WRITE, key);
+        if (next == 0) break;   // Link lost
+        ticket = next;
+    }
+    while (!output.isDone(ticket) && !output.isStalled() &&
+           millis() - start < Constants::Hid::NAVIGATION_TIMEOUT) {
+        Utils::sleepFor(1);
+    }
+
+    result.keys = queued;
+    result.latencyMillis = millis() - start;
+    result.completed = queued == tabCount && output.isDone(ticket);
+    lastNavigation = result;
+    return result;
+}
+
+template<typename Transport>
+void BasicKeyboard<Transport>::simulateTabDelay() {
+    Utils::sleepFor(rng->between(Constants::Navigation::MIN_TAB_DELAY,
+                                 Constants::Navigation::MAX_TAB_DELAY));
 }
 
-void Keyboard::setBaseSpeed(float wpm) {
+template<typename Transport>
+void BasicKeyboard<Transport>::setBaseSpeed(float wpm) {
     baseWPM = constrain(wpm, 10.0f, 200.0f);  // Reasonable limits
 }
 
-void Keyboard::adjustSpeed(float multiplier) {
+template<typename Transport>
+void BasicKeyboard<Transport>::adjustSpeed(float multiplier) {
     currentSpeedMultiplier = constrain(multiplier, 0.5f, 2.0f);
 }
 
-Keyboard::TypingStats Keyboard::getTypingStats() const {
-    return stats;
+template<typename Transport>
+typename BasicKeyboard<Transport>::TypingStats BasicKeyboard<Transport>::getTypingStats() const {
+    return publishedStats.load();
 }
 
-void Keyboard::resetStats() {
-    stats = TypingStats();
-    lastTypeTime = 0;
+template<typename Transport>
+void BasicKeyboard<Transport>::resetStats() {
+    // The output task owns the stats and clears them on its next pass
+    statsResetRequested.store(true, std::memory_order_release);
     currentSpeedMultiplier = 1.0f;
 }
 
-void Keyboard::updateStats(char c) {
-    stats.charactersTyped++;
-    
-    if (c == ' ' || c == '\n') {
-        stats.wordsTyped++;
-        
-        // Calculate current WPM
-        unsigned long typingTime = millis() - lastTypeTime;
-        if (typingTime > 0) {
-            float minutes = typingTime / 60000.0f;  // Convert to minutes
-            stats.currentWPM = minutes > 0 ? stats.wordsTyped / minutes : 0;
-            
-            // Update average WPM
-            stats.averageWPM = (stats.averageWPM + stats.currentWPM) / 2.0f;
-        }
-    }
-}
-
-int Keyboard::calculateDelay() const {
+template<typename Transport>
+int BasicKeyboard<Transport>::calculateDelay() const {
     return (60 * 1000) / (baseWPM * 5);  // 5 characters per word average
 }
+
+template class BasicKeyboard<DefaultTransport>;
+#ifndef ARDUINO
+// Host builds can also dump reports to a file for replay
+template class BasicKeyboard<Hid::FileDumpTransport>;
+#endif
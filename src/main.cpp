@@ -1,88 +1,158 @@
-#define DEBUG_MODE
-#ifdef DEBUG_MODE
-    #define DEBUG_PRINT(x) Serial.print(x)
-    #define DEBUG_PRINTLN(x) Serial.println(x)
-#else
-    #define DEBUG_PRINT(x)
-    #define DEBUG_PRINTLN(x)
-#endif
-
 #include "hardware.h"
 #include "keyboard.h"
 #include "human_simulator.h"
+#include "ui/panel.h"
+#include "utils/log.h"
 
+// Core 1 (this loop task): the typing engine. Core 0: the HID output
+// task and the UI panel. The engine and the panel only talk through
+// uiLink; see "Tasks and Button Latency" in README.md.
+#ifdef ARDUINO
+const Keyboard::OutputMode OUTPUT_MODE = Keyboard::OutputMode::TASK;
+const Ui::Panel::Mode PANEL_MODE = Ui::Panel::Mode::TASK;
+const Utils::Logger::Mode LOG_MODE = Utils::Logger::Mode::TASK;
+#else
+// Host session simulation (tools/session_sim): everything runs on the
+// loop thread through the scheduler, on the shim's virtual clock
+const Keyboard::OutputMode OUTPUT_MODE = Keyboard::OutputMode::SCHEDULER;
+const Ui::Panel::Mode PANEL_MODE = Ui::Panel::Mode::SCHEDULER;
+const Utils::Logger::Mode LOG_MODE = Utils::Logger::Mode::SCHEDULER;
+#endif
+
+Ui::Link uiLink;
 Hardware hardware;
 Keyboard keyboard;
-HumanSimulator simulator(keyboard, hardware);  // Pass both keyboard and hardware references
+Utils::Random rng;      // Reseeded from the hardware RNG in setup(); fixed on the host
+HumanSimulator simulator(keyboard, uiLink, rng);
+Ui::Panel panel(hardware, uiLink);
 
+// Engine state; the panel shows the copy sent in STATE messages
 int currentClip = 1;
+bool paused = true;
+bool sectionComplete = false;
+bool allClipsDone = false;
 bool connectionAnnounced = false;
 
+void publishState() {
+    Ui::Status status;
+    status.connected = keyboard.isConnected();
+    status.paused = paused;
+    status.sectionComplete = sectionComplete;
+    status.finished = allClipsDone;
+    status.clip = currentClip;
+    status.maxCommandMicros = uiLink.getMaxCommandMicros();
+    uiLink.publish(status);
+}
+
+// Runs whenever the engine sleeps through Utils::sleepFor(), so a pause
+// cancels queued keys mid-clip
+uint32_t commandTask(void*) {
+    Ui::Command command;
+    bool changed = false;
+    while (uiLink.nextCommand(command)) {
+        switch (command.type) {
+            case Ui::Command::Type::PAUSE:
+                paused = true;
+                simulator.pause();
+                break;
+            case Ui::Command::Type::RESUME:
+                paused = false;
+                break;
+            case Ui::Command::Type::SKIP:
+                sectionComplete = !sectionComplete;
+                break;
+            case Ui::Command::Type::RESET:
+                paused = true;
+                sectionComplete = false;
+                simulator.pause();
+                break;
+        }
+        changed = true;
+    }
+    if (changed) publishState();
+    return Constants::Scheduler::COMMAND_POLL;
+}
+
+uint32_t heartbeatTask(void*) {
+    publishState();
+    return Constants::Scheduler::STATUS_REPORT;
+}
+
 void setup() {
     Serial.begin(115200);
-    Serial.println("\n=== ESP32 Human-like Typer Starting ===");
+    Utils::Logger::instance().begin(LOG_MODE);
+    LOG_INFO("\n=== ESP32 Human-like Typer Starting ===");
+#ifdef ARDUINO
+    rng.seed(((uint64_t)esp_random() << 32) | esp_random());
+#endif
     
     hardware.init();
-    keyboard.init();
+    keyboard.init(OUTPUT_MODE);
+    panel.begin(PANEL_MODE);
     
     if (!SPIFFS.begin(true)) {
-        Serial.println("ERROR: SPIFFS Mount Failed");
+        LOG_ERROR("ERROR: SPIFFS Mount Failed");
         return;
     }
     
     simulator.init();
-    Serial.println("Ready! Press button to start/pause/resume");
+    simulator.loadTask();
+
+    Utils::Scheduler& scheduler = Utils::Scheduler::instance();
+    scheduler.add("commands", commandTask);
+    scheduler.add("heartbeat", heartbeatTask);
+    LOG_INFO("Ready! Press button to start/pause/resume");
 }
 
 void loop() {
     if (keyboard.isConnected()) {
         if (!connectionAnnounced) {
-            Serial.println("\n=== Bluetooth Connected ===");
+            LOG_INFO("\n=== Bluetooth Connected ===");
+            Utils::traceEvent(Utils::TraceEvent::BLE_CONNECT);
             connectionAnnounced = true;
-            hardware.setLedPattern(Hardware::Pattern::ALL_ON);
+            publishState();
         }
         
-        hardware.handleButton();
-        
-        // Debug state information
-        static unsigned long lastDebugTime = 0;
-        if (millis() - lastDebugTime > 1000) {  // Print debug every second
-            Serial.printf("States - Paused: %d, SectionComplete: %d, CurrentClip: %d\n", 
-                         hardware.isPaused(), hardware.isSectionComplete(), currentClip);
-            lastDebugTime = millis();
+        // All clips done: stop processing, keep answering commands
+        if (currentClip > simulator.getTotalClips()) {
+            if (!allClipsDone) {
+                LOG_INFO("\n=== All Clips Completed ===");
+                allClipsDone = true;
+                publishState();
+            }
+            Utils::sleepFor(1000);
+            return;
         }
-        
-        if (!hardware.isPaused() && !hardware.isSectionComplete()) {
-            Serial.println("Starting to process clip...");
-            hardware.setLedPattern(Hardware::Pattern::ALTERNATING);
-            simulator.processClip(currentClip);
+
+        if (!paused && !sectionComplete) {
+            LOG_INFO("Starting to process clip...");
+            simulator.resume();
+            Utils::traceEvent(Utils::TraceEvent::CLIP_START, currentClip);
+            bool finished = simulator.processClip(currentClip);
+            Utils::traceEvent(Utils::TraceEvent::CLIP_END, currentClip, finished);
             
-            // Only set section complete if we haven't been paused
-            if (!hardware.isPaused()) {
-                hardware.setSectionComplete(true);
-                hardware.playSound(Hardware::SoundType::SECTION_COMPLETE);
-                Serial.printf("Completed processing clip %d\n", currentClip);
+            // Only set section complete if we haven't been paused or lost
+            // the link; an interrupted clip resumes after reconnecting
+            if (finished && !paused) {
+                sectionComplete = true;
+                uiLink.publishEvent(Ui::Status::Type::SECTION_COMPLETE);
+                LOG_INFO("Completed processing clip %d", currentClip);
                 currentClip++;
+                publishState();
             }
-        } else if (hardware.isPaused() && !hardware.isSectionComplete()) {
-            hardware.setLedPattern(Hardware::Pattern::RED_ONLY);
-        } else if (hardware.isSectionComplete()) {
-            hardware.setLedPattern(Hardware::Pattern::SYNC_FLASH);
-        }
-        
-        // Check if all clips are completed
-        if (currentClip > simulator.getTotalClips()) {
-            Serial.println("\n=== All Clips Completed ===");
-            hardware.setLedPattern(Hardware::Pattern::ALL_ON);
-            while(1) delay(1000);  // Stop processing
         }
 
     } else {
         // Not connected to Bluetooth
-        connectionAnnounced = false;
-        hardware.setSectionComplete(false);
-        hardware.setLedPattern(Hardware::Pattern::BLUE_ONLY);
-        Serial.println("Waiting for Bluetooth connection...");
-        delay(1000);
+        if (connectionAnnounced) {
+            Utils::traceEvent(Utils::TraceEvent::BLE_DISCONNECT);
+            connectionAnnounced = false;
+            publishState();
+        }
+        LOG_INFO("Waiting for Bluetooth connection...");
+        Utils::sleepFor(1000);
+        return;
     }
+
+    Utils::sleepFor(Constants::Scheduler::LOOP_IDLE);
 }
\ No newline at end of file
@@ -0,0 +1,136 @@
+#include "ui/panel.h"
+#include "utils/scheduler.h"
+
+namespace Ui {
+    void Panel::begin(Mode mode) {
+        showState();
+        if (mode == Mode::SCHEDULER) {
+            Utils::Scheduler::instance().add("ui", scheduled, this);
+            return;
+        }
+        xTaskCreatePinnedToCore(task, "ui", Constants::Ui::TASK_STACK, this,
+                                Constants::Ui::TASK_PRIORITY, nullptr,
+                                Constants::Ui::TASK_CORE);
+    }
+
+    uint32_t Panel::service() {
+        handleButton();
+
+        // 't' on the serial console also dumps the trace
+        if (Serial.available() && Serial.read() == 't') Utils::trace().dump(Serial);
+
+        Status status;
+        while (link.nextStatus(status)) apply(status);
+
+        hardware.update();
+
+        unsigned long now = millis();
+        if (now - lastReport >= Constants::Scheduler::STATUS_REPORT) {
+            report();
+            lastReport = now;
+        }
+        return Constants::Ui::POLL;
+    }
+
+    void Panel::handleButton() {
+        // Hardware flips its own paused/hold flags right away so the LEDs
+        // answer the press; the engine's next STATE confirms them
+        Hardware::ButtonEvent event = hardware.handleButton();
+        bool pausedEarly = earlyPause;
+        if (event != Hardware::ButtonEvent::NONE) earlyPause = false;
+
+        switch (event) {
+            case Hardware::ButtonEvent::SINGLE_PRESS:
+                // A press that already paused stays a pause
+                if (pausedEarly) hardware.setPaused(true);
+                link.send(hardware.isPaused() ? Command::Type::PAUSE : Command::Type::RESUME);
+                showState();
+                break;
+            case Hardware::ButtonEvent::DOUBLE_PRESS:
+                undoEarlyPause(pausedEarly);
+                link.send(Command::Type::SKIP);
+                break;
+            case Hardware::ButtonEvent::LONG_PRESS:
+                link.send(Command::Type::RESET);
+                break;
+            case Hardware::ButtonEvent::TRIPLE_PRESS:
+                // Stays on this task: the engine keeps typing meanwhile
+                undoEarlyPause(pausedEarly);
+                Utils::trace().dump(Serial);
+                break;
+            default:
+                break;
+        }
+
+        // A single press is only known a double-press window after its
+        // release. While typing, the first press pauses at once instead;
+        // the event decides later whether the pause stays.
+        bool typing = state.connected && !state.paused && !state.sectionComplete && !state.finished;
+        if (!earlyPause && typing && hardware.pendingPresses() == 1) {
+            earlyPause = true;
+            hardware.setPaused(true);
+            link.send(Command::Type::PAUSE);
+            showState();
+        }
+    }
+
+    void Panel::undoEarlyPause(bool pausedEarly) {
+        if (!pausedEarly) return;
+        hardware.setPaused(false);
+        link.send(Command::Type::RESUME);
+        showState();
+    }
+
+    void Panel::apply(const Status& status) {
+        switch (status.type) {
+            case Status::Type::STATE:
+                state = status;
+                hardware.setPaused(status.paused);
+                hardware.setSectionComplete(status.sectionComplete);
+                showState();
+                break;
+            case Status::Type::PROGRESS:
+                hardware.updateProgress(status.progress);
+                break;
+            case Status::Type::SECTION_COMPLETE:
+                hardware.playSound(Hardware::SoundType::SECTION_COMPLETE);
+                break;
+            case Status::Type::ERROR:
+                hardware.setError(true, status.message ? status.message : "");
+                break;
+        }
+    }
+
+    void Panel::showState() {
+        if (!state.connected) {
+            hardware.setLedPattern(Hardware::Pattern::BLUE_ONLY);
+        } else if (state.finished) {
+            hardware.setLedPattern(Hardware::Pattern::ALL_ON);
+        } else if (hardware.isSectionComplete()) {
+            hardware.setLedPattern(Hardware::Pattern::SYNC_FLASH);
+        } else if (hardware.isPaused()) {
+            hardware.setLedPattern(Hardware::Pattern::RED_ONLY);
+        } else {
+            hardware.setLedPattern(Hardware::Pattern::ALTERNATING);
+        }
+    }
+
+    void Panel::report() {
+        if (!state.connected) return;
+        LOG_INFO("States - Paused: %d, SectionComplete: %d, CurrentClip: %d, "
+                 "Command latency max: %lu us",
+                 state.paused, state.sectionComplete, state.clip,
+                 (unsigned long)state.maxCommandMicros);
+    }
+
+    void Panel::task(void* param) {
+        Panel* panel = static_cast<Panel*>(param);
+        for (;;) {
+            vTaskDelay(pdMS_TO_TICKS(panel->service()));
+        }
+    }
+
+    uint32_t Panel::scheduled(void* param) {
+        return static_cast<Panel*>(param)->service();
+    }
+}
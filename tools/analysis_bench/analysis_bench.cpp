@@ -0,0 +1,410 @@
+// Task analysis benchmark. Times Analysis::TaskAnalyzer's fused pass
+// against the multi-pass analysis it replaced, kept below as the
+// reference: DurationCalculator::analyze (its own range walk and a
+// std::sort of start/end events), validateTiming (clip sequence, then
+// timeframes) and MetricsCalculator::calculate with its three extra
+// walks. Inputs are synthetic tasks of 1k and 10k clips shaped like
+// text.txt. Both sides must agree on duration, validation and metrics,
+// on valid tasks and on tasks with each kind of timing error. Exits
+// non-zero on a failed check. Build and usage are described in
+// tools/README.md.
+#include <Arduino.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <vector>
+#include "analysis/task_analyzer.h"
+#include "utils/random.h"
+
+using Analysis::ClipData;
+using Analysis::TimeFrame;
+using Analysis::TextParser;
+
+static int failures = 0;
+
+static void report(const char* name, bool ok, const char* detail) {
+    printf("%-30s %s  %s\n", name, ok ? "OK  " : "FAIL", detail);
+    if (!ok) failures++;
+}
+
+// The analysis as it was before the fused pass: every result walks all
+// clips again
+namespace MultiPass {
+    using TimeAnalysis::DurationAnalysis;
+
+    static void findGlobalTimeRange(const TextParser::ParseResult& task, DurationAnalysis& analysis) {
+        uint32_t globalStart = UINT32_MAX;
+        uint32_t globalEnd = 0;
+        for (const auto& clip : task.clips) {
+            for (const auto& frame : clip.timeframes) {
+                globalStart = std::min(globalStart, frame.startTime.toMillis());
+                globalEnd = std::max(globalEnd, frame.endTime.toMillis());
+            }
+        }
+        analysis.totalMillis = globalEnd - globalStart;
+    }
+
+    static void analyzeTimeframes(const TextParser::ParseResult& task, DurationAnalysis& analysis) {
+        std::vector<std::pair<uint32_t, int>> events;  // time, +1/-1 for start/end
+        for (const auto& clip : task.clips) {
+            for (const auto& frame : clip.timeframes) {
+                events.push_back(std::make_pair(frame.startTime.toMillis(), 1));
+                events.push_back(std::make_pair(frame.endTime.toMillis(), -1));
+            }
+        }
+        std::sort(events.begin(), events.end());
+
+        int activeFrames = 0;
+        uint32_t lastTime = events[0].first;
+        uint32_t coveredTime = 0;
+        DurationAnalysis::TimeRange currentRange = {0, 0};
+
+        for (const auto& event : events) {
+            uint32_t currentTime = event.first;
+            if (activeFrames > 0) coveredTime += currentTime - lastTime;
+
+            if (activeFrames > 1) {
+                analysis.overlapMillis += currentTime - lastTime;
+                if (currentRange.startMillis == 0) currentRange.startMillis = lastTime;
+            } else if (activeFrames == 1 && currentRange.startMillis > 0) {
+                currentRange.endMillis = lastTime;
+                analysis.overlaps.push_back(currentRange);
+                currentRange = {0, 0};
+            }
+
+            if (activeFrames == 0 && lastTime > events[0].first) {
+                analysis.gaps.push_back({lastTime, currentTime});
+                analysis.gapMillis += currentTime - lastTime;
+            }
+
+            activeFrames += event.second;
+            lastTime = currentTime;
+        }
+        analysis.effectiveMillis = coveredTime;
+    }
+
+    static DurationAnalysis analyzeDuration(const TextParser::ParseResult& task) {
+        DurationAnalysis analysis;
+        if (task.clips.empty()) return analysis;
+        findGlobalTimeRange(task, analysis);
+        analyzeTimeframes(task, analysis);
+        TimeAnalysis::DurationCalculator::calculateUtilization(analysis);
+        return analysis;
+    }
+
+    static bool validateClipSequence(const TextParser::ParseResult& task, String& errorMessage) {
+        uint32_t lastEndTime = 0;
+        int expectedClipNum = 1;
+        for (const auto& clip : task.clips) {
+            if (clip.number != expectedClipNum) {
+                errorMessage = "Invalid clip numbering sequence";
+                return false;
+            }
+            uint32_t clipStartTime = UINT32_MAX;
+            uint32_t clipEndTime = 0;
+            for (const auto& frame : clip.timeframes) {
+                uint32_t startMs = frame.startTime.toMillis();
+                uint32_t endMs = frame.endTime.toMillis();
+                if (endMs <= startMs) {
+                    errorMessage = "Invalid timeframe duration in clip " + String(clip.number);
+                    return false;
+                }
+                clipStartTime = std::min(clipStartTime, startMs);
+                clipEndTime = std::max(clipEndTime, endMs);
+            }
+            if (lastEndTime > 0 && clipStartTime < lastEndTime) {
+                errorMessage = "Clip " + String(clip.number) + " overlaps with previous clip";
+                return false;
+            }
+            lastEndTime = clipEndTime;
+            expectedClipNum++;
+        }
+        return true;
+    }
+
+    static bool validateTimeframes(const TextParser::ParseResult& task, String& errorMessage) {
+        for (const auto& clip : task.clips) {
+            for (const auto& frame : clip.timeframes) {
+                if (frame.endTime.toMillis() <= frame.startTime.toMillis()) {
+                    errorMessage = "Invalid timeframe in clip " + String(clip.number);
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    static bool validateTiming(const TextParser::ParseResult& task, String& errorMessage) {
+        if (task.clips.empty()) {
+            errorMessage = "No clips found";
+            return false;
+        }
+        return validateClipSequence(task, errorMessage) && validateTimeframes(task, errorMessage);
+    }
+
+    static float averageTimeframeDuration(const TextParser::ParseResult& task) {
+        uint32_t totalDuration = 0;
+        int count = 0;
+        for (const auto& clip : task.clips) {
+            for (const auto& frame : clip.timeframes) {
+                totalDuration += frame.getDurationMillis();
+                count++;
+            }
+        }
+        return count > 0 ? (totalDuration / 1000.0f) / count : 0;
+    }
+
+    static float timeframeOverlap(const TextParser::ParseResult& task) {
+        uint32_t totalOverlap = 0;
+        uint32_t totalTime = 0;
+        for (const auto& clip : task.clips) {
+            for (size_t i = 0; i < clip.timeframes.size(); i++) {
+                const auto& current = clip.timeframes[i];
+                totalTime += current.getDurationMillis();
+                if (i < clip.timeframes.size() - 1) {
+                    const auto& next = clip.timeframes[i + 1];
+                    if (current.endTime.toMillis() > next.startTime.toMillis()) {
+                        totalOverlap += current.endTime.toMillis() - next.startTime.toMillis();
+                    }
+                }
+            }
+        }
+        return totalTime > 0 ? (float)totalOverlap / totalTime * 100.0f : 0;
+    }
+
+    static float transitionFrequency(const TextParser::ParseResult& task) {
+        int totalTransitions = 0;
+        for (const auto& clip : task.clips) totalTransitions += clip.cameraTransitions;
+        float durationMinutes = task.clips.back().totalDurationMillis / (1000.0f * 60.0f);
+        return durationMinutes > 0 ? totalTransitions / durationMinutes : 0;
+    }
+
+    static Analysis::TaskMetrics metrics(const TextParser::ParseResult& task) {
+        Analysis::TaskMetrics metrics = {};
+        if (task.clips.empty()) return metrics;
+
+        int totalWords = 0;
+        int totalChars = 0;
+        int totalTimeframes = 0;
+        int totalCameraActions = 0;
+        uint32_t totalDuration = 0;
+        for (const auto& clip : task.clips) {
+            totalWords += clip.wordCount;
+            totalChars += clip.charCount;
+            totalTimeframes += clip.timeframes.size();
+            totalCameraActions += clip.cameraMovements + clip.cameraTransitions;
+            totalDuration = max(totalDuration, clip.totalDurationMillis);
+        }
+
+        metrics.totalClips = task.clips.size();
+        metrics.totalTimeframes = totalTimeframes;
+        metrics.totalDurationMillis = totalDuration;
+        metrics.totalWords = totalWords;
+
+        float durationSeconds = totalDuration / 1000.0f;
+        metrics.charsPerSecond = totalChars / durationSeconds;
+        metrics.wordsPerSecond = totalWords / durationSeconds;
+        metrics.averageWordLength = totalWords > 0 ? (float)totalChars / totalWords : 0;
+        metrics.timeframesPerClip = (float)totalTimeframes / metrics.totalClips;
+        metrics.averageTimeframeDuration = averageTimeframeDuration(task);
+        metrics.timeframeOverlapPercent = timeframeOverlap(task);
+        metrics.cameraActionsPerClip = (float)totalCameraActions / metrics.totalClips;
+        metrics.cameraActionDensity = totalCameraActions / durationSeconds;
+        metrics.transitionFrequency = transitionFrequency(task);
+        metrics.averageWordsPerClip = (float)totalWords / metrics.totalClips;
+        metrics.descriptionDensity = (float)totalWords / totalTimeframes;
+        return metrics;
+    }
+
+    struct Result {
+        DurationAnalysis duration;
+        Analysis::TaskMetrics metrics;
+        bool timingValid;
+        String timingError;
+    };
+
+    static Result analyze(const TextParser::ParseResult& task) {
+        Result result;
+        result.duration = analyzeDuration(task);
+        result.timingValid = validateTiming(task, result.timingError);
+        result.metrics = metrics(task);
+        return result;
+    }
+}
+
+static TimeFrame frame(TimeFrame::Type type, uint32_t startMillis, uint32_t endMillis) {
+    TimeFrame tf;
+    tf.type = type;
+    tf.startTime = TimeFrame::TimeStamp::fromMillis(startMillis);
+    tf.endTime = TimeFrame::TimeStamp::fromMillis(endMillis);
+    return tf;
+}
+
+// Clips as the parser builds them: a boundary frame spanning the clip,
+// then 2-6 timeframes in order, now and then overlapping the previous one
+// or leaving a gap, and a short pause between clips
+static TextParser::ParseResult makeTask(int clips, Utils::Random& rng) {
+    TextParser::ParseResult task;
+    task.videoId = "synthetic";
+    task.isValid = true;
+    task.clips.reserve(clips);
+    uint32_t now = 0;
+    for (int n = 1; n <= clips; n++) {
+        ClipData clip = {};
+        clip.number = n;
+        int frames = rng.between(2, 7);
+        std::vector<TimeFrame> inner;
+        uint32_t clipStart = now;
+        for (int i = 0; i < frames; i++) {
+            uint32_t length = rng.between(800, 4000);
+            if (i > 0 && rng.chance(0.2f)) now -= std::min<uint32_t>(now - clipStart, rng.between(100, 600));
+            else if (rng.chance(0.2f)) now += rng.between(100, 900);
+            auto type = rng.chance(0.7f) ? TimeFrame::Type::TYPING :
+                        rng.chance(0.5f) ? TimeFrame::Type::CAMERA_MOVEMENT : TimeFrame::Type::CAMERA_TRANSITION;
+            if (type == TimeFrame::Type::CAMERA_MOVEMENT) clip.cameraMovements++;
+            if (type == TimeFrame::Type::CAMERA_TRANSITION) clip.cameraTransitions++;
+            inner.push_back(frame(type, now, now + length));
+            now += length;
+        }
+        uint32_t clipEnd = 0;
+        for (const auto& tf : inner) clipEnd = std::max(clipEnd, tf.endTime.toMillis());
+        clip.timeframes.push_back(frame(TimeFrame::Type::CLIP_BOUNDARY, clipStart, clipEnd));
+        clip.timeframes.insert(clip.timeframes.end(), inner.begin(), inner.end());
+        clip.totalDurationMillis = clipEnd - clipStart;
+        clip.wordCount = rng.between(20, 120);
+        clip.charCount = clip.wordCount * rng.between(4, 7);
+        task.clips.push_back(std::move(clip));
+        now = clipEnd + rng.between(0, 1500);
+    }
+    return task;
+}
+
+static bool close(float a, float b) {
+    return std::fabs(a - b) <= 1e-4f * std::max(1.0f, std::fabs(b));
+}
+
+// Zero-length gaps (one frame ending as the next starts) were listed by
+// the old sweep; the current one only reports gaps that take time
+static size_t timedRanges(const std::vector<TimeAnalysis::DurationAnalysis::TimeRange>& ranges) {
+    size_t n = 0;
+    for (const auto& range : ranges) if (range.duration() > 0) n++;
+    return n;
+}
+
+static bool same(const MultiPass::Result& reference, const Analysis::TaskAnalysis& fused, char* detail,
+                 size_t size) {
+    const auto& a = reference.duration;
+    const auto& b = fused.duration;
+    const auto& m = reference.metrics;
+    const auto& f = fused.metrics;
+    bool duration = a.totalMillis == b.totalMillis && a.effectiveMillis == b.effectiveMillis &&
+                    a.overlapMillis == b.overlapMillis && a.gapMillis == b.gapMillis &&
+                    close(a.utilizationPercent, b.utilizationPercent) &&
+                    timedRanges(a.gaps) == b.gaps.size();
+    bool validation = reference.timingValid == fused.timingValid &&
+                      (reference.timingValid || reference.timingError == fused.timingError);
+    bool metrics = m.totalClips == f.totalClips && m.totalTimeframes == f.totalTimeframes &&
+                   m.totalDurationMillis == f.totalDurationMillis && close(m.totalWords, f.totalWords) &&
+                   close(m.charsPerSecond, f.charsPerSecond) && close(m.wordsPerSecond, f.wordsPerSecond) &&
+                   close(m.averageWordLength, f.averageWordLength) &&
+                   close(m.timeframesPerClip, f.timeframesPerClip) &&
+                   close(m.averageTimeframeDuration, f.averageTimeframeDuration) &&
+                   close(m.timeframeOverlapPercent, f.timeframeOverlapPercent) &&
+                   close(m.cameraActionsPerClip, f.cameraActionsPerClip) &&
+                   close(m.cameraActionDensity, f.cameraActionDensity) &&
+                   close(m.transitionFrequency, f.transitionFrequency) &&
+                   close(m.averageWordsPerClip, f.averageWordsPerClip) &&
+                   close(m.descriptionDensity, f.descriptionDensity);
+    snprintf(detail, size, "duration %s, validation %s (%s), metrics %s", duration ? "same" : "DIFFERS",
+             validation ? "same" : "DIFFERS", fused.timingValid ? "valid" : fused.timingError.c_str(),
+             metrics ? "same" : "DIFFER");
+    return duration && validation && metrics;
+}
+
+// Fused analysis with a scratch sized for the task, as a caller with its
+// own buffer would run it; the multi-pass side allocates as it always did
+struct Fused {
+    std::vector<uint32_t> starts;
+    std::vector<uint32_t> ends;
+
+    Analysis::TaskAnalysis run(const TextParser::ParseResult& task) {
+        size_t needed = TimeAnalysis::DurationCalculator::countTimeframes(task);
+        starts.resize(needed);
+        ends.resize(needed);
+        Timing::SweepScratch scratch;
+        scratch.starts = starts.data();
+        scratch.ends = ends.data();
+        scratch.capacity = needed;
+        return Analysis::TaskAnalyzer::analyze(task, scratch);
+    }
+};
+
+template<typename Run>
+static double microsPerRun(int rounds, Run run) {
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < rounds; i++) run();
+    return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / rounds;
+}
+
+static void checkErrors(Utils::Random& rng) {
+    Fused fused;
+    struct Case {
+        const char* name;
+        void (*inject)(TextParser::ParseResult&);
+    } cases[] = {
+        {"error: clip numbering", [](TextParser::ParseResult& t) { t.clips[40].number = 99; }},
+        {"error: inverted timeframe", [](TextParser::ParseResult& t) {
+             auto& tf = t.clips[70].timeframes[1];
+             std::swap(tf.startTime, tf.endTime);
+         }},
+        {"error: overlapping clips", [](TextParser::ParseResult& t) {
+             // Move clip 11 to start 500 ms before clip 10 ends
+             uint32_t shift = t.clips[11].timeframes[0].startTime.toMillis() -
+                              t.clips[10].timeframes[0].endTime.toMillis() + 500;
+             for (auto& tf : t.clips[11].timeframes) {
+                 tf.startTime = TimeFrame::TimeStamp::fromMillis(tf.startTime.toMillis() - shift);
+                 tf.endTime = TimeFrame::TimeStamp::fromMillis(tf.endTime.toMillis() - shift);
+             }
+         }},
+        {"error: first of two wins", [](TextParser::ParseResult& t) {
+             t.clips[80].number = 3;
+             auto& tf = t.clips[30].timeframes[2];
+             tf.endTime = tf.startTime;
+         }},
+    };
+    for (const Case& c : cases) {
+        auto task = makeTask(100, rng);
+        c.inject(task);
+        char detail[160];
+        bool ok = same(MultiPass::analyze(task), fused.run(task), detail, sizeof(detail));
+        report(c.name, ok && !fused.run(task).timingValid, detail);
+    }
+}
+
+int main(int argc, char** argv) {
+    int rounds = 20;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--rounds") == 0 && i + 1 < argc) rounds = atoi(argv[++i]);
+    }
+
+    Utils::Random rng(5);
+    Fused fused;
+    char name[48];
+    char detail[160];
+    for (int clips : {1000, 10000}) {
+        auto task = makeTask(clips, rng);
+        snprintf(name, sizeof(name), "results, %d clips", clips);
+        report(name, same(MultiPass::analyze(task), fused.run(task), detail, sizeof(detail)), detail);
+
+        double multiPass = microsPerRun(rounds, [&] { MultiPass::analyze(task); });
+        double single = microsPerRun(rounds, [&] { fused.run(task); });
+        snprintf(name, sizeof(name), "fused pass, %d clips", clips);
+        snprintf(detail, sizeof(detail), "%.0f us vs %.0f us multi-pass (%.1fx)", single, multiPass,
+                 multiPass / single);
+        report(name, single < multiPass, detail);
+    }
+    checkErrors(rng);
+
+    printf(failures ? "%d check(s) FAILED\n" : "All checks passed\n", failures);
+    return failures ? 1 : 0;
+}
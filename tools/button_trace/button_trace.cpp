@@ -0,0 +1,177 @@
+// Button classifier check. Plays synthetic edge traces (taps, bounce,
+// holds, lost edges, millis() wrap) through Ui::ButtonClassifier, and
+// through the firmware path (GPIO interrupt -> edge queue -> Hardware::
+// handleButton() at the UI poll period) on a virtual clock, and compares
+// the events and when they fire. The firmware path must also show the
+// first press as pending within one poll, which is when the panel pauses
+// typing. Exits non-zero on a mismatch. Build and usage are described in
+// tools/README.md.
+#include <Arduino.h>
+#include <vector>
+#include "hardware.h"
+
+using Ui::ButtonEvent;
+
+struct Step {
+    uint32_t at;        // ms from the start of the trace
+    bool pressed;
+    bool lost = false;  // Level changes but no interrupt/edge is seen
+};
+
+struct Expected {
+    ButtonEvent event;
+    uint32_t at;        // When it is due; the pipeline may be up to one poll late
+};
+
+struct Trace {
+    const char* name;
+    std::vector<Step> steps;
+    std::vector<Expected> expected;
+};
+
+static const uint32_t WINDOW = Constants::Hardware::DOUBLE_PRESS_WINDOW;
+static const uint32_t LONG = Constants::Hardware::LONG_PRESS_DURATION;
+static const uint32_t DEBOUNCE = Constants::Hardware::DEBOUNCE_DELAY;
+
+static std::vector<Trace> traces() {
+    return {
+        {"single tap", {{0, true}, {80, false}},
+            {{ButtonEvent::SINGLE_PRESS, 80 + WINDOW + 1}}},
+        {"double tap", {{0, true}, {80, false}, {200, true}, {280, false}},
+            {{ButtonEvent::DOUBLE_PRESS, 280 + WINDOW + 1}}},
+        {"triple tap", {{0, true}, {80, false}, {200, true}, {280, false}, {400, true}, {480, false}},
+            {{ButtonEvent::TRIPLE_PRESS, 480}}},
+        {"four taps", {{0, true}, {80, false}, {200, true}, {280, false}, {400, true}, {480, false},
+                       {600, true}, {680, false}},
+            {{ButtonEvent::TRIPLE_PRESS, 480}, {ButtonEvent::SINGLE_PRESS, 680 + WINDOW + 1}}},
+        {"long press", {{0, true}, {1500, false}},
+            {{ButtonEvent::LONG_PRESS, LONG}}},
+        {"tap then long", {{0, true}, {80, false}, {200, true}, {1600, false}},
+            {{ButtonEvent::LONG_PRESS, 200 + LONG}}},
+        {"taps outside window", {{0, true}, {80, false}, {80 + WINDOW + 50, true}, {80 + WINDOW + 120, false}},
+            {{ButtonEvent::SINGLE_PRESS, 80 + WINDOW + 1}, {ButtonEvent::SINGLE_PRESS, 80 + 2 * WINDOW + 121}}},
+        {"contact bounce", {{0, true}, {2, false}, {4, true}, {7, false}, {9, true},
+                            {100, false}, {101, true}, {103, false}},
+            {{ButtonEvent::SINGLE_PRESS, 100 + WINDOW + 1}}},
+        {"lost release edge", {{0, true}, {80, false, true}},
+            {{ButtonEvent::SINGLE_PRESS, 80 + WINDOW + 1}}},
+        {"release inside lockout", {{0, true}, {DEBOUNCE / 2, false}},
+            {{ButtonEvent::SINGLE_PRESS, DEBOUNCE + WINDOW + 1}}},
+    };
+}
+
+struct Fired {
+    ButtonEvent event;
+    uint32_t at;
+};
+
+static const char* name(ButtonEvent event) {
+    static const char* const NAMES[] = {"NONE", "SINGLE", "DOUBLE", "LONG", "TRIPLE"};
+    return NAMES[(int)event];
+}
+
+static uint32_t traceEnd(const Trace& trace) {
+    uint32_t end = trace.steps.back().at;
+    return end + LONG + WINDOW + 100;
+}
+
+// The classifier alone, edges fed directly, polled every millisecond.
+// sync() stands in for reading the pin, as Hardware does.
+static std::vector<Fired> runClassifier(const Trace& trace, uint32_t origin) {
+    Ui::ButtonClassifier classifier;
+    std::vector<Fired> fired;
+    bool level = false;
+    size_t next = 0;
+
+    for (uint32_t t = 0; t <= traceEnd(trace); t++) {
+        uint32_t now = origin + t;
+        while (next < trace.steps.size() && trace.steps[next].at == t) {
+            const Step& step = trace.steps[next++];
+            level = step.pressed;
+            if (step.lost) continue;
+            ButtonEvent event = classifier.edge({now, step.pressed});
+            if (event != ButtonEvent::NONE) fired.push_back({event, t});
+        }
+        ButtonEvent event = classifier.sync(level, now);
+        if (event == ButtonEvent::NONE) event = classifier.poll(now);
+        if (event != ButtonEvent::NONE) fired.push_back({event, t});
+    }
+    return fired;
+}
+
+// The firmware path: the shim pin fires Hardware's interrupt handler,
+// handleButton() runs every Ui::POLL ms as on the UI task. pendingAt is
+// when pendingPresses() first went non-zero.
+static std::vector<Fired> runHardware(const Trace& trace, uint32_t& pendingAt) {
+    Hardware hardware;
+    hardware.init();
+    std::vector<Fired> fired;
+    const uint8_t pin = Constants::Hardware::BUTTON_PIN;
+    uint32_t start = millis();
+    size_t next = 0;
+    pendingAt = UINT32_MAX;
+
+    for (uint32_t t = 0; t <= traceEnd(trace); t++) {
+        while (next < trace.steps.size() && trace.steps[next].at == t) {
+            const Step& step = trace.steps[next++];
+            uint8_t level = step.pressed ? LOW : HIGH;
+            if (step.lost) digitalWrite(pin, level);   // Level only, no interrupt
+            else setPinInput(pin, level);
+        }
+        if (t % Constants::Ui::POLL == 0) {
+            ButtonEvent event = hardware.handleButton();
+            if (event != ButtonEvent::NONE) fired.push_back({event, (uint32_t)(millis() - start)});
+            if (pendingAt == UINT32_MAX && hardware.pendingPresses() > 0) pendingAt = millis() - start;
+        }
+        delay(1);
+    }
+    setPinInput(pin, HIGH);
+    detachInterrupt(pin);
+    return fired;
+}
+
+static bool check(const char* what, const Trace& trace, const std::vector<Fired>& fired,
+                  uint32_t slack, uint32_t& worstLate) {
+    bool ok = fired.size() == trace.expected.size();
+    for (size_t i = 0; ok && i < fired.size(); i++) {
+        const Expected& want = trace.expected[i];
+        ok = fired[i].event == want.event && fired[i].at >= want.at && fired[i].at <= want.at + slack;
+        if (ok) worstLate = max(worstLate, fired[i].at - want.at);
+    }
+    if (!ok) {
+        printf("  %s/%s: got", trace.name, what);
+        for (const auto& f : fired) printf(" %s@%u", name(f.event), f.at);
+        printf(", expected");
+        for (const auto& e : trace.expected) printf(" %s@%u", name(e.event), e.at);
+        printf("\n");
+    }
+    return ok;
+}
+
+int main() {
+    setVirtualClock(true);
+    int failures = 0;
+    uint32_t worstLate = 0;
+    uint32_t worstPending = 0;
+
+    for (const Trace& trace : traces()) {
+        bool ok = check("classifier", trace, runClassifier(trace, 1000), 0, worstLate);
+        // Same trace across the millis() wrap
+        ok &= check("wrap", trace, runClassifier(trace, UINT32_MAX - 250), 0, worstLate);
+        uint32_t pendingAt;
+        ok &= check("hardware", trace, runHardware(trace, pendingAt), Constants::Ui::POLL, worstLate);
+        // Every trace starts with a press
+        if (pendingAt > trace.steps.front().at + Constants::Ui::POLL) {
+            printf("  %s/hardware: first press pending at %d ms\n", trace.name, (int)pendingAt);
+            ok = false;
+        }
+        worstPending = max(worstPending, pendingAt);
+        printf("%-24s %s\n", trace.name, ok ? "OK" : "FAIL");
+        if (!ok) failures++;
+    }
+
+    printf("Worst delay past the due time: %u ms (UI poll %u ms)\n", worstLate, Constants::Ui::POLL);
+    printf("First press pending after at most %u ms\n", worstPending);
+    printf(failures ? "%d trace(s) FAILED\n" : "All traces passed\n", failures);
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,151 @@
+// HID pipeline benchmark. Types the timeframes of one clip from
+// <data dir>/text.txt through the real Keyboard (output queue, report
+// writer, report spacing) into the loopback transport and reports
+// throughput and latency. Can also dump the reports to a file, or read a
+// dump back. Build and usage are described in tools/README.md.
+#include <Arduino.h>
+#include <SPIFFS.h>
+#include "analysis/text_parser.h"
+#include "keyboard.h"
+
+struct ReportStats {
+    uint32_t reports = 0;
+    uint32_t firstMicros = 0;
+    uint32_t lastMicros = 0;
+    uint32_t minGap = UINT32_MAX;
+    uint32_t maxGap = 0;
+
+    void add(const Hid::ReportRecord& record) {
+        if (reports > 0) {
+            uint32_t gap = record.timestampMicros - lastMicros;
+            minGap = min(minGap, gap);
+            maxGap = max(maxGap, gap);
+        } else {
+            firstMicros = record.timestampMicros;
+        }
+        lastMicros = record.timestampMicros;
+        reports++;
+    }
+
+    void print() const {
+        if (reports < 2) {
+            printf("%u reports\n", reports);
+            return;
+        }
+        uint32_t span = lastMicros - firstMicros;
+        printf("%u reports in %.3f s: %.1f reports/s, gap min %u us, avg %u us, max %u us\n",
+               reports, span / 1e6, (reports - 1) / (span / 1e6),
+               minGap, span / (reports - 1), maxGap);
+    }
+};
+
+static int replayDump(const char* path) {
+    fs::FS local;
+    local.setRoot("");
+    Hid::ReportDumpReader reader;
+    if (!reader.open(local, path)) {
+        fprintf(stderr, "ERROR: %s is not a report dump\n", path);
+        return 1;
+    }
+    ReportStats stats;
+    Hid::ReportRecord record;
+    while (reader.next(record)) stats.add(record);
+    printf("%s: ", path);
+    stats.print();
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    const char* dataDir = "data";
+    const char* dumpPath = nullptr;
+    int clipNumber = 1;
+    long spacing = -1;
+
+    int positional = 0;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--spacing") == 0 && i + 1 < argc) spacing = atol(argv[++i]);
+        else if (strcmp(argv[i], "--dump") == 0 && i + 1 < argc) dumpPath = argv[++i];
+        else if (strcmp(argv[i], "--replay") == 0 && i + 1 < argc) return replayDump(argv[++i]);
+        else if (positional++ == 0) dataDir = argv[i];
+        else clipNumber = atoi(argv[i]);
+    }
+    SPIFFS.setRoot(dataDir);
+
+    auto parseResult = Analysis::TextParser::parseFile();
+    if (!parseResult.isValid || clipNumber < 1 || clipNumber > (int)parseResult.clips.size()) {
+        fprintf(stderr, "ERROR: cannot load clip %d from %s\n", clipNumber, dataDir);
+        return 1;
+    }
+    const auto& clip = parseResult.clips[clipNumber - 1];
+
+    // No human pacing: the queue and report spacing are what is measured
+    Hid::KeystrokeCompiler::Pacing pacing;
+    pacing.charGapMillis = 0;
+    pacing.wordPauseMillis = 0;
+    pacing.sentencePauseMillis = 0;
+    Utils::PauseMap pauses;
+    Hid::ProgramBuilder program;
+
+    fs::FS local;
+    local.setRoot("");
+    Keyboard loopback;
+    BasicKeyboard<Hid::FileDumpTransport> dump(local, dumpPath ? dumpPath : "");
+
+    // Report index and play() time at the start of each timeframe
+    std::vector<std::pair<uint32_t, uint32_t>> marks;
+
+    auto run = [&](auto& keyboard) {
+        if (spacing >= 0) keyboard.setReportSpacing(spacing);
+        keyboard.init();
+
+        uint32_t totalChars = 0;
+        unsigned long start = micros();
+        for (size_t i = 0; i < clip.timeframes.size(); i++) {
+            const String& text = clip.timeframes[i].content;
+            program.clear();
+            Hid::KeystrokeCompiler::compile(text.c_str(), text.length(), pacing, program, pauses);
+            totalChars += text.length();
+
+            marks.push_back({keyboard.getTransport().total(), (uint32_t)micros()});
+            keyboard.play(program);
+            keyboard.flush();
+        }
+        double seconds = (micros() - start) / 1e6;
+        printf("Clip %d: %u chars in %.3f s, %.1f chars/s\n",
+               clipNumber, totalChars, seconds, totalChars / seconds);
+    };
+
+    if (dumpPath) {
+        run(dump);
+        printf("%u reports written to %s\n", dump.getTransport().total(), dumpPath);
+        dump.getTransport().end();
+        return replayDump(dumpPath);
+    }
+
+    run(loopback);
+    auto& transport = loopback.getTransport();
+    if (transport.total() > transport.size()) {
+        printf("(last %zu of %u reports kept)\n", transport.size(), transport.total());
+    }
+    ReportStats stats;
+    for (size_t i = 0; i < transport.size(); i++) stats.add(transport.at(i));
+    stats.print();
+
+    // Latency: play() call to the first report it produced
+    uint32_t dropped = transport.total() - transport.size();
+    uint32_t worst = 0;
+    uint64_t sum = 0;
+    size_t measured = 0;
+    for (const auto& mark : marks) {
+        if (mark.first < dropped || mark.first >= transport.total()) continue;
+        uint32_t latency = transport.at(mark.first - dropped).timestampMicros - mark.second;
+        worst = max(worst, latency);
+        sum += latency;
+        measured++;
+    }
+    if (measured > 0) {
+        printf("First-report latency over %zu timeframes: avg %u us, max %u us\n",
+               measured, (uint32_t)(sum / measured), worst);
+    }
+    return 0;
+}
@@ -0,0 +1,204 @@
+#pragma once
+// Minimal Arduino core shim for host-side tools. Only covers what the
+// headers under include/ actually use; it is not a general emulation.
+#include <cstdint>
+#include <cstring>
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+#include <cctype>
+#include <string>
+#include <vector>
+#include <memory>
+#include <algorithm>
+
+#define HIGH 0x1
+#define LOW  0x0
+#define INPUT 0x01
+#define OUTPUT 0x03
+#define INPUT_PULLUP 0x05
+#define RISING 0x01
+#define FALLING 0x02
+#define CHANGE 0x03
+#define PROGMEM
+#define IRAM_ATTR
+
+using std::min;
+using std::max;
+
+template<typename T, typename L, typename H>
+auto constrain(T value, L low, H high) -> decltype(value + low + high) {
+    return value < low ? low : (value > high ? high : value);
+}
+
+inline bool isAlphaNumeric(char c) { return isalnum((unsigned char)c); }
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+// Host only: with a virtual clock, time moves only through delay() and
+// delayMicroseconds(), which return at once. Lets a session run instantly.
+void setVirtualClock(bool enabled);
+long random(long howBig);
+long random(long howSmall, long howBig);
+void randomSeed(unsigned long seed);
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t value);
+int digitalRead(uint8_t pin);
+inline uint8_t digitalPinToInterrupt(uint8_t pin) { return pin; }
+void attachInterruptArg(uint8_t pin, void (*handler)(void*), void* arg, int mode);
+void detachInterrupt(uint8_t pin);
+// Host only: drive an input pin from outside, as a button would; runs the
+// attached interrupt handler on the calling thread
+void setPinInput(uint8_t pin, uint8_t value);
+// LEDC PWM (Arduino-ESP32 2.x API); keeps per-channel frequency and duty
+uint32_t ledcSetup(uint8_t channel, uint32_t freq, uint8_t resolutionBits);
+void ledcAttachPin(uint8_t pin, uint8_t channel);
+void ledcWrite(uint8_t channel, uint32_t duty);
+uint32_t ledcWriteTone(uint8_t channel, uint32_t freq);
+uint32_t ledcRead(uint8_t channel);
+uint32_t ledcReadFreq(uint8_t channel);
+
+// FreeRTOS subset (pulled in by Arduino.h on the ESP32). Tasks run on
+// detached std::threads; ticks are milliseconds.
+typedef void* TaskHandle_t;
+typedef int BaseType_t;
+typedef unsigned int UBaseType_t;
+typedef uint32_t TickType_t;
+typedef void (*TaskFunction_t)(void*);
+#define pdPASS 1
+#define pdMS_TO_TICKS(ms) ((TickType_t)(ms))
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t task, const char* name, uint32_t stackDepth,
+                                   void* param, UBaseType_t priority, TaskHandle_t* handle,
+                                   BaseType_t core);
+void vTaskDelay(TickType_t ticks);
+
+class String {
+public:
+    String() {}
+    String(const char* str) : value(str ? str : "") {}
+    String(const std::string& str) : value(str) {}
+    explicit String(char c) : value(1, c) {}
+    explicit String(int v) : value(std::to_string(v)) {}
+    explicit String(unsigned int v) : value(std::to_string(v)) {}
+    explicit String(long v) : value(std::to_string(v)) {}
+    explicit String(unsigned long v) : value(std::to_string(v)) {}
+    explicit String(float v, unsigned int decimals = 2) {
+        char buffer[32];
+        snprintf(buffer, sizeof(buffer), "%.*f", decimals, v);
+        value = buffer;
+    }
+
+    unsigned int length() const { return value.size(); }
+    bool isEmpty() const { return value.empty(); }
+    const char* c_str() const { return value.c_str(); }
+    bool reserve(unsigned int size) { value.reserve(size); return true; }
+
+    char operator[](unsigned int i) const { return i < value.size() ? value[i] : 0; }
+    char charAt(unsigned int i) const { return (*this)[i]; }
+    const char* begin() const { return value.data(); }
+    const char* end() const { return value.data() + value.size(); }
+
+    bool concat(const char* str, unsigned int length) { value.append(str, length); return true; }
+    bool concat(const String& str) { value += str.value; return true; }
+    bool concat(char c) { value += c; return true; }
+    String& operator+=(const String& rhs) { value += rhs.value; return *this; }
+    String& operator+=(const char* rhs) { value += rhs; return *this; }
+    String& operator+=(char c) { value += c; return *this; }
+
+    friend String operator+(const String& lhs, const String& rhs) { return String(lhs.value + rhs.value); }
+    friend String operator+(const String& lhs, const char* rhs) { return String(lhs.value + rhs); }
+    friend String operator+(const char* lhs, const String& rhs) { return String(lhs + rhs.value); }
+    bool operator==(const String& rhs) const { return value == rhs.value; }
+    bool operator==(const char* rhs) const { return value == rhs; }
+    bool operator!=(const String& rhs) const { return value != rhs.value; }
+
+    int indexOf(char c, unsigned int from = 0) const { return found(value.find(c, from)); }
+    int indexOf(const char* str, unsigned int from = 0) const { return found(value.find(str, from)); }
+    int indexOf(const String& str, unsigned int from = 0) const { return indexOf(str.c_str(), from); }
+    bool startsWith(const char* prefix) const { return value.rfind(prefix, 0) == 0; }
+    bool startsWith(const String& prefix) const { return startsWith(prefix.c_str()); }
+
+    String substring(unsigned int from) const {
+        return from >= value.size() ? String() : String(value.substr(from));
+    }
+    String substring(unsigned int from, unsigned int to) const {
+        if (from > to) std::swap(from, to);
+        if (from >= value.size()) return String();
+        return String(value.substr(from, to - from));
+    }
+
+    void trim() {
+        size_t start = 0;
+        size_t end = value.size();
+        while (start < end && isspace((unsigned char)value[start])) start++;
+        while (end > start && isspace((unsigned char)value[end - 1])) end--;
+        value = value.substr(start, end - start);
+    }
+
+    long toInt() const { return atol(value.c_str()); }
+    float toFloat() const { return atof(value.c_str()); }
+
+private:
+    std::string value;
+
+    static int found(size_t pos) { return pos == std::string::npos ? -1 : (int)pos; }
+};
+
+class Print {
+public:
+    virtual ~Print() {}
+    virtual size_t write(uint8_t c) = 0;
+    virtual size_t write(const uint8_t* buffer, size_t size) {
+        size_t n = 0;
+        while (size--) n += write(*buffer++);
+        return n;
+    }
+
+    size_t print(const char* str) { return write(reinterpret_cast<const uint8_t*>(str), strlen(str)); }
+    size_t print(const String& str) { return print(str.c_str()); }
+    size_t print(char c) { return write((uint8_t)c); }
+    size_t print(int v) { return print(String(v)); }
+    size_t print(unsigned int v) { return print(String(v)); }
+    size_t print(long v) { return print(String(v)); }
+    size_t print(unsigned long v) { return print(String(v)); }
+    size_t print(double v) { return print(String((float)v)); }
+    size_t println() { return print("\n"); }
+    template<typename T>
+    size_t println(const T& v) { return print(v) + println(); }
+    size_t printf(const char* format, ...) __attribute__((format(printf, 2, 3)));
+};
+
+class Stream : public Print {
+public:
+    virtual int available() = 0;
+    virtual int read() = 0;
+
+    String readStringUntil(char terminator) {
+        String result;
+        while (available()) {
+            int c = read();
+            if (c < 0 || c == terminator) break;
+            result += (char)c;
+        }
+        return result;
+    }
+};
+
+class HardwareSerial : public Stream {
+public:
+    void begin(unsigned long baud) {}
+    int available() override { return 0; }
+    int read() override { return -1; }
+    size_t write(uint8_t c) override { return output ? fwrite(&c, 1, 1, output) : 1; }
+    using Print::write;
+
+    // Host only: where the output goes, nullptr to drop it
+    void setOutput(FILE* file) { output = file; }
+
+private:
+    FILE* output = stdout;
+};
+
+extern HardwareSerial Serial;
@@ -0,0 +1,38 @@
+#pragma once
+// Host stand-in for the t-vk BleKeyboard library: the key constants and
+// report type the firmware uses, and a device that is always connected
+// and sends nothing. Host builds use Hid::LoopbackTransport instead.
+#include <Arduino.h>
+
+const uint8_t KEY_LEFT_CTRL = 0x80;
+const uint8_t KEY_LEFT_SHIFT = 0x81;
+const uint8_t KEY_LEFT_ALT = 0x82;
+const uint8_t KEY_LEFT_GUI = 0x83;
+const uint8_t KEY_UP_ARROW = 0xDA;
+const uint8_t KEY_DOWN_ARROW = 0xD9;
+const uint8_t KEY_LEFT_ARROW = 0xD8;
+const uint8_t KEY_RIGHT_ARROW = 0xD7;
+const uint8_t KEY_BACKSPACE = 0xB2;
+const uint8_t KEY_TAB = 0xB3;
+const uint8_t KEY_RETURN = 0xB0;
+const uint8_t KEY_ESC = 0xB1;
+const uint8_t KEY_DELETE = 0xD4;
+const uint8_t KEY_PAGE_UP = 0xD3;
+const uint8_t KEY_PAGE_DOWN = 0xD6;
+const uint8_t KEY_HOME = 0xD2;
+const uint8_t KEY_END = 0xD5;
+
+typedef struct {
+    uint8_t modifiers;
+    uint8_t reserved;
+    uint8_t keys[6];
+} KeyReport;
+
+class BleKeyboard {
+public:
+    BleKeyboard(std::string name = "", std::string manufacturer = "", uint8_t batteryLevel = 100) {}
+    void begin() {}
+    bool isConnected() { return true; }
+    void sendReport(KeyReport* report) {}
+    void setDelay(uint32_t ms) {}
+};
@@ -0,0 +1,65 @@
+#pragma once
+// Host stand-in for the Arduino FS layer, backed by a local directory
+#include <Arduino.h>
+
+enum SeekMode { SeekSet = 0, SeekCur = 1, SeekEnd = 2 };
+
+namespace fs {
+    class File : public Stream {
+    public:
+        File() {}
+        explicit File(FILE* handle) : handle(handle, &fclose) {}
+
+        explicit operator bool() const { return handle != nullptr; }
+
+        int available() override { return handle ? (int)(size() - position()) : 0; }
+        int read() override { return handle ? fgetc(handle.get()) : -1; }
+        size_t read(uint8_t* buffer, size_t size) {
+            return handle ? fread(buffer, 1, size, handle.get()) : 0;
+        }
+
+        size_t write(uint8_t c) override { return write(&c, 1); }
+        size_t write(const uint8_t* buffer, size_t size) override {
+            return handle ? fwrite(buffer, 1, size, handle.get()) : 0;
+        }
+
+        bool seek(uint32_t pos, SeekMode mode = SeekSet) {
+            return handle && fseek(handle.get(), pos, mode) == 0;
+        }
+        size_t position() const { return handle ? ftell(handle.get()) : 0; }
+        size_t size() const {
+            if (!handle) return 0;
+            long pos = ftell(handle.get());
+            fseek(handle.get(), 0, SEEK_END);
+            long end = ftell(handle.get());
+            fseek(handle.get(), pos, SEEK_SET);
+            return end;
+        }
+        void close() { handle.reset(); }
+
+    private:
+        std::shared_ptr<FILE> handle;
+    };
+
+    class FS {
+    public:
+        // Host only: directory that stands in for the filesystem root
+        void setRoot(const char* dir) { root = dir; }
+
+        bool begin(bool formatOnFail = false) { return true; }
+
+        File open(const char* path, const char* mode = "r") {
+            std::string hostMode = std::string(mode) + "b";
+            FILE* f = fopen((root + path).c_str(), hostMode.c_str());
+            return f ? File(f) : File();
+        }
+        File open(const String& path, const char* mode = "r") { return open(path.c_str(), mode); }
+
+        bool exists(const char* path) { return (bool)open(path); }
+
+    private:
+        std::string root = "data";
+    };
+}
+
+using fs::File;
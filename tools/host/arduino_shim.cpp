@@ -0,0 +1,164 @@
+#include <Arduino.h>
+#include <SPIFFS.h>
+#include <atomic>
+#include <chrono>
+#include <cstdarg>
+#include <thread>
+
+HardwareSerial Serial;
+fs::FS SPIFFS;
+
+static const auto startTime = std::chrono::steady_clock::now();
+static std::atomic<bool> virtualClock{false};
+static std::atomic<uint64_t> virtualMicros{0};
+
+static uint64_t realMicros() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - startTime).count();
+}
+
+void setVirtualClock(bool enabled) {
+    // Carry on from the current time so elapsed times stay positive
+    if (enabled && !virtualClock) virtualMicros = realMicros();
+    virtualClock = enabled;
+}
+
+unsigned long millis() {
+    return micros() / 1000;
+}
+
+unsigned long micros() {
+    return virtualClock ? virtualMicros.load() : realMicros();
+}
+
+void delay(unsigned long ms) {
+    if (virtualClock) virtualMicros += (uint64_t)ms * 1000;
+    else std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+void delayMicroseconds(unsigned int us) {
+    if (virtualClock) virtualMicros += us;
+    else std::this_thread::sleep_for(std::chrono::microseconds(us));
+}
+
+long random(long howBig) {
+    return howBig > 0 ? rand() % howBig : 0;
+}
+
+long random(long howSmall, long howBig) {
+    return howBig > howSmall ? howSmall + random(howBig - howSmall) : howSmall;
+}
+
+void randomSeed(unsigned long seed) {
+    srand(seed);
+}
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t task, const char* name, uint32_t stackDepth,
+                                   void* param, UBaseType_t priority, TaskHandle_t* handle,
+                                   BaseType_t core) {
+    std::thread(task, param).detach();
+    if (handle) *handle = nullptr;
+    return pdPASS;
+}
+
+void vTaskDelay(TickType_t ticks) {
+    delay(ticks);
+}
+
+// Pin levels (inputs idle HIGH, as with INPUT_PULLUP) and one
+// interrupt handler per pin
+static constexpr uint8_t PIN_COUNT = 64;
+static std::atomic<uint8_t> pinLevels[PIN_COUNT];
+static struct {
+    void (*handler)(void*) = nullptr;
+    void* arg = nullptr;
+    int mode = 0;
+} pinInterrupts[PIN_COUNT];
+
+static struct PinInit {
+    PinInit() { for (auto& level : pinLevels) level = HIGH; }
+} pinInit;
+
+void pinMode(uint8_t pin, uint8_t mode) {}
+
+void digitalWrite(uint8_t pin, uint8_t value) {
+    if (pin < PIN_COUNT) pinLevels[pin] = value ? HIGH : LOW;
+}
+
+int digitalRead(uint8_t pin) {
+    return pin < PIN_COUNT ? pinLevels[pin].load() : HIGH;
+}
+
+void attachInterruptArg(uint8_t pin, void (*handler)(void*), void* arg, int mode) {
+    if (pin >= PIN_COUNT) return;
+    pinInterrupts[pin].handler = handler;
+    pinInterrupts[pin].arg = arg;
+    pinInterrupts[pin].mode = mode;
+}
+
+void detachInterrupt(uint8_t pin) {
+    if (pin < PIN_COUNT) pinInterrupts[pin].handler = nullptr;
+}
+
+void setPinInput(uint8_t pin, uint8_t value) {
+    if (pin >= PIN_COUNT) return;
+    uint8_t level = value ? HIGH : LOW;
+    if (pinLevels[pin].exchange(level) == level) return;
+
+    const auto& irq = pinInterrupts[pin];
+    bool fires = irq.mode == CHANGE || (irq.mode == RISING && level == HIGH) ||
+                 (irq.mode == FALLING && level == LOW);
+    if (irq.handler && fires) irq.handler(irq.arg);
+}
+
+// LEDC channels: a tone is 50% duty at its frequency, 0 Hz is off
+static constexpr uint8_t LEDC_CHANNELS = 16;
+static struct {
+    std::atomic<uint32_t> freq{0};
+    std::atomic<uint32_t> duty{0};
+    uint8_t bits = 8;
+} ledcChannels[LEDC_CHANNELS];
+
+uint32_t ledcSetup(uint8_t channel, uint32_t freq, uint8_t resolutionBits) {
+    if (channel >= LEDC_CHANNELS) return 0;
+    ledcChannels[channel].freq = freq;
+    ledcChannels[channel].bits = resolutionBits;
+    return freq;
+}
+
+void ledcAttachPin(uint8_t pin, uint8_t channel) {}
+
+void ledcWrite(uint8_t channel, uint32_t duty) {
+    if (channel < LEDC_CHANNELS) ledcChannels[channel].duty = duty;
+}
+
+uint32_t ledcWriteTone(uint8_t channel, uint32_t freq) {
+    if (channel >= LEDC_CHANNELS) return 0;
+    auto& ch = ledcChannels[channel];
+    if (freq == 0) {
+        ch.duty = 0;
+        return 0;
+    }
+    ch.freq = freq;
+    ch.duty = 1u << (ch.bits - 1);
+    return freq;
+}
+
+uint32_t ledcRead(uint8_t channel) {
+    return channel < LEDC_CHANNELS ? ledcChannels[channel].duty.load() : 0;
+}
+
+uint32_t ledcReadFreq(uint8_t channel) {
+    if (channel >= LEDC_CHANNELS || ledcChannels[channel].duty == 0) return 0;
+    return ledcChannels[channel].freq;
+}
+
+size_t Print::printf(const char* format, ...) {
+    char buffer[256];
+    va_list args;
+    va_start(args, format);
+    int n = vsnprintf(buffer, sizeof(buffer), format, args);
+    va_end(args);
+    if (n < 0) return 0;
+    return write(reinterpret_cast<const uint8_t*>(buffer), std::min<size_t>(n, sizeof(buffer) - 1));
+}
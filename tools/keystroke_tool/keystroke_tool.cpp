@@ -0,0 +1,83 @@
+// Keystroke program disassembler and VM benchmark. Compiles the timeframes
+// of one clip from <data dir>/text.txt into keystroke programs, lists them,
+// and with --bench replays them against a counting sink. Build and usage
+// are described in tools/README.md.
+#include <Arduino.h>
+#include <SPIFFS.h>
+#include <chrono>
+#include "analysis/text_parser.h"
+#include "hid/keystroke_program.h"
+
+// Stands in for the HID queue: only counts what it is given
+struct CountingSink {
+    uint32_t keys = 0;
+    uint32_t checkpoints = 0;
+    uint64_t gapMillis = 0;
+
+    void key(uint8_t k, uint16_t gap) { keys++; gapMillis += gap; }
+    void press(uint8_t k, uint16_t gap) { gapMillis += gap; }
+    void release(uint8_t k, uint16_t gap) { gapMillis += gap; }
+    void releaseAll(uint16_t gap) { gapMillis += gap; }
+    void checkpoint(uint32_t id) { checkpoints++; }
+};
+
+int main(int argc, char** argv) {
+    const char* dataDir = "data";
+    int clipNumber = 1;
+    bool bench = false;
+
+    int positional = 0;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--bench") == 0) bench = true;
+        else if (positional++ == 0) dataDir = argv[i];
+        else clipNumber = atoi(argv[i]);
+    }
+    SPIFFS.setRoot(dataDir);
+
+    auto parseResult = Analysis::TextParser::parseFile();
+    if (!parseResult.isValid || clipNumber < 1 || clipNumber > (int)parseResult.clips.size()) {
+        fprintf(stderr, "ERROR: cannot load clip %d from %s\n", clipNumber, dataDir);
+        return 1;
+    }
+    const auto& clip = parseResult.clips[clipNumber - 1];
+
+    Hid::KeystrokeCompiler::Pacing pacing;
+    Utils::PauseMap pauses;
+    std::vector<Hid::ProgramBuilder> programs(clip.timeframes.size());
+    size_t textBytes = 0;
+    size_t codeBytes = 0;
+
+    for (size_t i = 0; i < clip.timeframes.size(); i++) {
+        const String& text = clip.timeframes[i].content;
+        Hid::KeystrokeCompiler::compile(text.c_str(), text.length(), pacing, programs[i], pauses);
+        textBytes += text.length();
+        codeBytes += programs[i].size();
+
+        if (!bench) {
+            printf("; clip %d timeframe %zu: %u chars -> %zu bytes\n",
+                   clipNumber, i + 1, text.length(), programs[i].size());
+            Hid::disassemble(programs[i].data(), programs[i].size(), Serial);
+            printf("\n");
+        }
+    }
+    printf("Clip %d: %zu timeframes, %zu text bytes -> %zu program bytes\n",
+           clipNumber, programs.size(), textBytes, codeBytes);
+    if (!bench) return 0;
+
+    const int rounds = 200000;
+    CountingSink sink;
+    uint64_t ops = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < rounds; r++) {
+        for (const auto& program : programs) {
+            ops += Hid::KeystrokeVM::run(program.data(), program.size(), sink);
+        }
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    printf("VM: %.1f M ops/s, %.1f M keys/s (%llu ops, %u keys, %.3f s)\n",
+           ops / seconds / 1e6, sink.keys / seconds / 1e6,
+           (unsigned long long)ops, sink.keys, seconds);
+    return 0;
+}
@@ -0,0 +1,249 @@
+// LED pattern check. Plays every Hardware::Pattern keyframe table through
+// Ui::LedAnimator into a fake LED driver that records each fade with its
+// time, on a fake clock, and compares the recorded timeline with the
+// table: stepped exactly as the esp_timer would, and polled late at an
+// odd period. Also checks a timer that falls whole cycles behind, fixed
+// levels, and Hardware on the shim (gamma, active-low duty and the RAM
+// shadow). Exits non-zero on a mismatch. Build and usage are described in
+// tools/README.md.
+#include <Arduino.h>
+#include <vector>
+#include "hardware.h"
+
+using Pattern = Hardware::Pattern;
+
+struct Fade {
+    uint32_t at;
+    uint8_t red;
+    uint8_t blue;
+    uint16_t millis;
+
+    bool operator==(const Fade& other) const {
+        return at == other.at && red == other.red && blue == other.blue && millis == other.millis;
+    }
+};
+
+// Records fades; the animator always sends red then blue for a keyframe
+class FakeLeds {
+public:
+    std::vector<Fade> fades;
+    uint32_t now = 0;
+
+    void fade(uint8_t led, uint8_t level, uint16_t millis) {
+        if (led == Ui::LED_RED) {
+            fades.push_back({now, level, 0, millis});
+        } else {
+            fades.back().blue = level;
+        }
+    }
+};
+
+using Animator = Ui::LedAnimator<FakeLeds>;
+
+static int failures = 0;
+
+static const struct {
+    Pattern pattern;
+    const char* name;
+} PATTERNS[] = {
+    {Pattern::ALL_OFF, "ALL_OFF"},
+    {Pattern::ALL_ON, "ALL_ON"},
+    {Pattern::ALTERNATING, "ALTERNATING"},
+    {Pattern::RED_ONLY, "RED_ONLY"},
+    {Pattern::BLUE_ONLY, "BLUE_ONLY"},
+    {Pattern::SYNC_FLASH, "SYNC_FLASH"},
+    {Pattern::SPEED_INDICATOR, "SPEED_INDICATOR"},
+    {Pattern::ERROR_PATTERN, "ERROR_PATTERN"},
+    {Pattern::SUCCESS_PATTERN, "SUCCESS_PATTERN"},
+};
+
+// Keyframe starts from the table for `window` ms from `start`
+static std::vector<Fade> expected(const Ui::LedPattern& pattern, uint32_t start, uint32_t window) {
+    std::vector<Fade> fades;
+    uint32_t at = start;
+    do {
+        for (uint8_t i = 0; i < pattern.length && at < start + window; i++) {
+            const Ui::LedFrame& f = pattern.frames[i];
+            fades.push_back({at, f.red, f.blue, f.fadeMillis});
+            at += f.fadeMillis + f.holdMillis;
+        }
+    } while (pattern.repeat && at < start + window);
+    return fades;
+}
+
+// Steps at the times advance() asks for, or every `poll` ms. Returns the
+// number of advance() calls.
+static uint32_t run(Animator& animator, FakeLeds& leds, uint32_t poll, uint32_t until) {
+    uint32_t calls = 0;
+    while (leds.now < until) {
+        uint32_t next = animator.advance(leds.now);
+        calls++;
+        if (next == Animator::IDLE) break;
+        leds.now += poll ? poll : next;
+    }
+    return calls;
+}
+
+static bool matches(const std::vector<Fade>& got, const std::vector<Fade>& want, uint32_t slack) {
+    if (got.size() != want.size()) return false;
+    for (size_t i = 0; i < got.size(); i++) {
+        if (got[i].red != want[i].red || got[i].blue != want[i].blue) return false;
+        if (got[i].at < want[i].at || got[i].at > want[i].at + slack) return false;
+    }
+    return true;
+}
+
+static void print(const char* label, const std::vector<Fade>& fades) {
+    printf("  %s:", label);
+    for (size_t i = 0; i < fades.size() && i < 12; i++) {
+        printf(" %u/%u@%u", fades[i].red, fades[i].blue, fades[i].at);
+    }
+    printf(fades.size() > 12 ? " ...\n" : "\n");
+}
+
+static void check(const char* name, const char* mode, bool ok, const std::vector<Fade>& got,
+                  const std::vector<Fade>& want) {
+    printf("%-18s %-9s %s\n", name, mode, ok ? "OK" : "FAIL");
+    if (!ok) {
+        print("got", got);
+        print("expected", want);
+        failures++;
+    }
+}
+
+static const uint32_t WINDOW = 3000;
+
+static void checkPatterns() {
+    for (const auto& entry : PATTERNS) {
+        const Ui::LedPattern& pattern = Hardware::ledPattern(entry.pattern);
+        std::vector<Fade> want = expected(pattern, 1000, WINDOW);
+
+        // Timer: one call per keyframe, exactly on time
+        FakeLeds leds;
+        Animator animator(leds);
+        leds.now = 1000;
+        animator.play(pattern);
+        uint32_t calls = run(animator, leds, 0, 1000 + WINDOW);
+        bool ok = leds.fades == want && calls <= want.size() + 1;
+        check(entry.name, "timer", ok, leds.fades, want);
+
+        // Polled every 7 ms: each keyframe up to one poll late, no drift
+        FakeLeds polled;
+        Animator late(polled);
+        polled.now = 1000;
+        late.play(pattern);
+        run(late, polled, 7, 1000 + WINDOW);
+        check(entry.name, "poll 7", matches(polled.fades, want, 6), polled.fades, want);
+    }
+}
+
+// A timer held off for several cycles resumes on the keyframe the
+// timeline is in, not where it stopped
+static void checkStall() {
+    const Ui::LedPattern& pattern = Hardware::ledPattern(Pattern::ALTERNATING);
+    const Ui::LedFrame& first = pattern.frames[0];
+    const Ui::LedFrame& second = pattern.frames[1];
+    uint32_t frame = first.fadeMillis + first.holdMillis;
+    uint32_t cycle = frame + second.fadeMillis + second.holdMillis;
+
+    FakeLeds leds;
+    Animator animator(leds);
+    animator.play(pattern);
+    animator.advance(0);
+    leds.now = 5 * cycle + frame + 3;           // Inside the second frame
+    uint32_t next = animator.advance(leds.now);
+
+    std::vector<Fade> want = {{0, first.red, first.blue, first.fadeMillis},
+                              {leds.now, second.red, second.blue, second.fadeMillis}};
+    bool ok = leds.fades == want && next == cycle - frame - 3;
+    check("stalled", "timer", ok, leds.fades, want);
+
+    // A one-shot pattern skipped past still ends on its last frame
+    static const Ui::LedFrame ramp[] = {{10, 0, 50, 0}, {20, 0, 50, 0}, {30, 0, 50, 0}};
+    static const Ui::LedPattern once = {ramp, 3, false};
+    FakeLeds onceLeds;
+    Animator onceAnimator(onceLeds);
+    onceAnimator.play(once);
+    onceAnimator.advance(0);
+    onceLeds.now = 400;
+    ok = onceAnimator.advance(onceLeds.now) == Animator::IDLE;
+    want = {{0, 10, 0, 50}, {400, 30, 0, 50}};
+    ok &= onceLeds.fades == want && onceAnimator.level(Ui::LED_RED) == 30;
+    check("skipped to end", "timer", ok, onceLeds.fades, want);
+}
+
+// show() fades to fixed levels, twice in a row without the timer running
+static void checkLevels() {
+    FakeLeds leds;
+    Animator animator(leds);
+    animator.show(200, 40, 250);
+    animator.advance(0);
+    leds.now = 10;
+    animator.show(1, 2, 0);
+    animator.show(3, 4, 100);
+    animator.advance(leds.now);
+    std::vector<Fade> want = {{0, 200, 40, 250}, {10, 3, 4, 100}};
+    bool ok = leds.fades == want && animator.level(Ui::LED_RED) == 3 && animator.level(Ui::LED_BLUE) == 4;
+    check("levels", "timer", ok, leds.fades, want);
+}
+
+static uint32_t duty(uint8_t level) {
+    return Constants::Hardware::LED_ACTIVE_LOW ? 4095 - Ui::GAMMA[level] : Ui::GAMMA[level];
+}
+
+// Through Hardware on the virtual clock and the shim's LEDC channels
+static void checkHardware() {
+    Hardware hardware;
+    hardware.init();
+    const uint8_t red = Constants::Hardware::RED_LED_CHANNEL;
+    const uint8_t blue = Constants::Hardware::BLUE_LED_CHANNEL;
+    bool ok = true;
+
+    hardware.update();
+    ok &= ledcRead(red) == duty(255) && ledcRead(blue) == duty(255);
+
+    // Re-applying the running pattern does not restart it
+    const Ui::LedFrame& first = Hardware::ledPattern(Pattern::ALTERNATING).frames[0];
+    hardware.setLedPattern(Pattern::ALTERNATING);
+    hardware.update();
+    ok &= ledcRead(red) == duty(255) && ledcRead(blue) == duty(0);
+    delay(first.fadeMillis + first.holdMillis);
+    hardware.update();
+    hardware.setLedPattern(Pattern::ALTERNATING);
+    hardware.update();
+    Hardware::LedStatus status = hardware.getLedStatus();
+    ok &= !status.redOn && status.blueOn && ledcRead(blue) == duty(255);
+
+    // Fixed levels go through the gamma table and show in the shadow
+    hardware.setLedBrightness(0.5f, 0.25f);
+    hardware.update();
+    status = hardware.getLedStatus();
+    ok &= ledcRead(red) == duty(128) && ledcRead(blue) == duty(64);
+    ok &= status.redBrightness == 128 / 255.0f && status.blueBrightness == 64 / 255.0f;
+
+    Timing::ProgressSnapshot progress;
+    progress.percentComplete = 40.0f;
+    hardware.setLedPattern(Pattern::PROGRESS_INDICATOR);
+    hardware.updateProgress(progress);
+    hardware.update();
+    ok &= ledcRead(red) == duty(153) && ledcRead(blue) == duty(102);
+
+    hardware.reset();
+    hardware.update();
+    status = hardware.getLedStatus();
+    ok &= !status.redOn && !status.blueOn && ledcRead(red) == duty(0);
+
+    printf("%-18s %-9s %s\n", "Hardware", "shim", ok ? "OK" : "FAIL");
+    if (!ok) failures++;
+    detachInterrupt(Constants::Hardware::BUTTON_PIN);
+}
+
+int main() {
+    setVirtualClock(true);
+    checkPatterns();
+    checkStall();
+    checkLevels();
+    checkHardware();
+    printf(failures ? "%d check(s) FAILED\n" : "All checks passed\n", failures);
+    return failures ? 1 : 0;
+}
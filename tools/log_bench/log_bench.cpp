@@ -0,0 +1,189 @@
+// Deferred logging check and benchmark. Compares what Utils::Logger
+// prints for the formats the firmware uses with snprintf's output,
+// checks that a full queue drops and counts instead of blocking, that
+// records from several threads arrive complete and in per-thread order
+// while the writer drains them, and measures the cost a LOG_* call puts
+// on the calling task against formatting inline. Exits non-zero on a
+// failed check. Build and usage are described in tools/README.md.
+#include <Arduino.h>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+#include "utils/log.h"
+
+static int failures = 0;
+
+static void report(const char* name, bool ok, const char* detail) {
+    printf("%-30s %s  %s\n", name, ok ? "OK  " : "FAIL", detail);
+    if (!ok) failures++;
+}
+
+class Capture : public Print {
+public:
+    std::string text;
+    size_t write(uint8_t c) override {
+        text += (char)c;
+        return 1;
+    }
+    using Print::write;
+};
+
+// Discards output; inline formatting still pays for printf
+class NullPrint : public Print {
+public:
+    size_t write(uint8_t) override { return 1; }
+    size_t write(const uint8_t*, size_t size) override { return size; }
+};
+
+static Utils::Logger& logger = Utils::Logger::instance();
+
+#define EXPECT_LOG(format, ...)                                          \
+    do {                                                                 \
+        char expected[128];                                              \
+        snprintf(expected, sizeof(expected), format "\n", ##__VA_ARGS__); \
+        LOG_INFO(format, ##__VA_ARGS__);                                 \
+        Capture got;                                                     \
+        logger.drain(got);                                               \
+        ok &= got.text == expected;                                      \
+        if (got.text != expected) printf("  got %s  expected %s", got.text.c_str(), expected); \
+    } while (0)
+
+static void checkFormats() {
+    bool ok = true;
+    EXPECT_LOG("\n=== Processing Clip %d ===", 3);
+    EXPECT_LOG("Task loaded: %s, Duration: %.1f seconds, Target AHT: %.1f minutes", "abc123", 1234.5f, 21.75f);
+    EXPECT_LOG("Offset %lu, %u keys", (unsigned long)4000000000ul, 17u);
+    EXPECT_LOG("Progress: %.1f%%", 42.25f);
+    EXPECT_LOG("[%5.2f] [%-6s] [%03u] [%+d]", 3.14159, "ab", 7u, 5);
+    EXPECT_LOG("%x %X %#o %c", 255, 0xBEEFu, 8, 'k');
+    EXPECT_LOG("%lld %llu", -5000000000ll, 18000000000000000000ull);
+    EXPECT_LOG("Red: %s (%.2f)", true ? "ON" : "OFF", 0.5f);
+    EXPECT_LOG("Paused: %d", (int)false);
+    EXPECT_LOG("no arguments");
+    report("formats", ok, "matches snprintf");
+
+    // A string longer than the payload is cut; arguments past it show "?"
+    std::string longText(80, 'x');
+    LOG_INFO("%s|%d", longText.c_str(), 7);
+    Capture got;
+    logger.drain(got);
+    std::string want = std::string(Utils::Logger::PAYLOAD - 1, 'x') + "|?\n";
+    report("payload overflow", got.text == want, "long string cut, later argument '?'");
+}
+
+static void checkFull() {
+    const size_t extra = 10;
+    for (size_t i = 0; i < Utils::Logger::CAPACITY + extra; i++) LOG_INFO("line %u", (unsigned)i);
+    Capture got;
+    size_t lines = logger.drain(got);
+    char first[64];
+    snprintf(first, sizeof(first), "(%u log messages dropped)\nline 0\n", (unsigned)extra);
+    bool ok = lines == Utils::Logger::CAPACITY && got.text.compare(0, strlen(first), first) == 0;
+    char detail[96];
+    snprintf(detail, sizeof(detail), "%u of %u kept, %u counted as dropped", (unsigned)lines,
+             (unsigned)(Utils::Logger::CAPACITY + extra), (unsigned)extra);
+    report("full queue drops", ok, detail);
+}
+
+// Parses "t<thread> <n>" lines and checks each thread's n increases
+class OrderCheck : public Print {
+public:
+    explicit OrderCheck(int threads) : last(threads, -1) {}
+    std::string line;
+    std::vector<long> last;
+    uint32_t lines = 0;
+    uint32_t dropped = 0;
+    bool ok = true;
+
+    size_t write(uint8_t c) override {
+        if (c != '\n') {
+            line += (char)c;
+            return 1;
+        }
+        unsigned thread, n;
+        if (sscanf(line.c_str(), "(%u log messages dropped)", &n) == 1) {
+            dropped += n;
+        } else if (sscanf(line.c_str(), "t%u %u", &thread, &n) == 2 && thread < last.size() &&
+                   (long)n > last[thread]) {
+            last[thread] = n;
+            lines++;
+        } else {
+            ok = false;
+        }
+        line.clear();
+        return 1;
+    }
+    using Print::write;
+};
+
+static void checkConcurrent(uint32_t count) {
+    const int threads = 4;
+    OrderCheck check(threads);
+    std::atomic<bool> done{false};
+    std::thread writer([&] {
+        while (!done.load()) {
+            if (!logger.formatNext(check)) std::this_thread::yield();
+        }
+        logger.drain(check);
+    });
+    std::vector<std::thread> producers;
+    for (int t = 0; t < threads; t++) {
+        producers.emplace_back([t, count] {
+            for (uint32_t i = 0; i < count; i++) {
+                LOG_INFO("t%d %u", t, i);
+                if (i % 64 == 0) std::this_thread::yield();
+            }
+        });
+    }
+    for (auto& p : producers) p.join();
+    done = true;
+    writer.join();
+    logger.drain(check);
+
+    char detail[96];
+    snprintf(detail, sizeof(detail), "%u printed + %u dropped of %u", check.lines, check.dropped,
+             count * threads);
+    report("concurrent producers", check.ok && check.lines + check.dropped == count * threads, detail);
+}
+
+static void bench(uint32_t count) {
+    // Drained in batches so the queue never fills; only write() is timed
+    using Clock = std::chrono::steady_clock;
+    NullPrint sink;
+    Clock::duration deferred{};
+    for (uint32_t done = 0; done < count; done += Utils::Logger::CAPACITY / 2) {
+        auto start = Clock::now();
+        for (uint32_t i = 0; i < Utils::Logger::CAPACITY / 2; i++) {
+            LOG_INFO("Navigation to clip %d: %d keys in %lu ms%s", (int)i, 5, (unsigned long)done, "");
+        }
+        deferred += Clock::now() - start;
+        logger.drain(sink);
+    }
+    double deferredNanos = std::chrono::duration<double, std::nano>(deferred).count() / count;
+
+    auto start = Clock::now();
+    for (uint32_t i = 0; i < count; i++) {
+        sink.printf("Navigation to clip %d: %d keys in %lu ms%s\n", (int)i, 5, (unsigned long)i, "");
+    }
+    double inlineNanos = std::chrono::duration<double, std::nano>(Clock::now() - start).count() / count;
+
+    char detail[96];
+    snprintf(detail, sizeof(detail), "LOG_INFO %.1f ns, inline printf %.1f ns (%.1fx)", deferredNanos,
+             inlineNanos, inlineNanos / deferredNanos);
+    report("caller cost", deferredNanos < inlineNanos, detail);
+}
+
+int main(int argc, char** argv) {
+    uint32_t count = 2000000;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--count") == 0 && i + 1 < argc) count = atoi(argv[++i]);
+    }
+    checkFormats();
+    checkFull();
+    checkConcurrent(count / 10);
+    bench(count);
+    printf(failures ? "%d check(s) FAILED\n" : "All checks passed\n", failures);
+    return failures ? 1 : 0;
+}
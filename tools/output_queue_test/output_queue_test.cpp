@@ -0,0 +1,317 @@
+// HID output queue test. Runs Hid::OutputQueue between a producer thread
+// and a consumer std::thread standing in for the output task, with a mock
+// sink in place of the HID device that records every call and its time.
+// Checks that keys arrive complete and in order through a full queue
+// (enqueue returning 0), that gaps are kept, that a completed ticket
+// means the key was sent, that keys are held rather than lost while the
+// sink is disconnected, that cancelPending() drops everything queued, and
+// the checkpoint counters the output journal reads, with a text offset
+// past 16 bits surviving the keystroke program and the queue. Exits
+// non-zero on a failed check. Build and usage are described in tools/README.md.
+#include <Arduino.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <BleKeyboard.h>
+#include "hid/keystroke_program.h"
+#include "hid/output_queue.h"
+
+using Hid::KeyEvent;
+
+static int failures = 0;
+
+static void report(const char* name, bool ok, const char* detail) {
+    printf("%-30s %s  %s\n", name, ok ? "OK  " : "FAIL", detail);
+    if (!ok) failures++;
+}
+
+// BleKeyboard's calls, recorded; only the consumer thread writes
+class MockSink {
+public:
+    struct Call {
+        KeyEvent::Action action;
+        uint8_t key;
+        uint32_t millis;
+    };
+
+    std::vector<Call> calls;
+    std::atomic<uint32_t> callCount{0};     // For the producer, while running
+    std::atomic<bool> connected{true};
+    std::atomic<uint32_t> callsWhileDisconnected{0};
+
+    bool isConnected() { return connected.load(); }
+    size_t write(uint8_t key) { return record(KeyEvent::Action::WRITE, key); }
+    size_t press(uint8_t key) { return record(KeyEvent::Action::PRESS, key); }
+    size_t release(uint8_t key) { return record(KeyEvent::Action::RELEASE, key); }
+    void releaseAll() { record(KeyEvent::Action::RELEASE_ALL, 0); }
+
+private:
+    size_t record(KeyEvent::Action action, uint8_t key) {
+        if (!connected.load()) callsWhileDisconnected++;
+        calls.push_back({action, key, (uint32_t)millis()});
+        callCount.store(calls.size(), std::memory_order_release);
+        return 1;
+    }
+};
+
+using Queue = Hid::OutputQueue<MockSink, 16>;
+
+// The output task: service() in a loop until told to stop
+class Consumer {
+public:
+    explicit Consumer(Queue& queue) : queue(queue), thread([this] { run(); }) {}
+    ~Consumer() { stop(); }
+
+    void stop() {
+        done = true;
+        if (thread.joinable()) thread.join();
+    }
+
+private:
+    Queue& queue;
+    std::atomic<bool> done{false};
+    std::thread thread;
+
+    void run() {
+        while (!done.load()) {
+            if (!queue.service(millis())) std::this_thread::yield();
+        }
+    }
+};
+
+// Enqueues, retrying while the queue is full; counts the retries
+static uint32_t enqueueWait(Queue& queue, KeyEvent::Action action, uint8_t key, uint32_t gap,
+                            uint32_t& fullCount) {
+    for (;;) {
+        uint32_t ticket = queue.enqueue(action, key, gap);
+        if (ticket) return ticket;
+        fullCount++;
+        std::this_thread::yield();
+    }
+}
+
+static bool waitFor(Queue& queue, uint32_t ticket, uint32_t timeoutMs = 5000) {
+    uint32_t start = millis();
+    while (!queue.isDone(ticket)) {
+        if (millis() - start > timeoutMs) return false;
+        std::this_thread::yield();
+    }
+    return true;
+}
+
+static void checkOrder(uint32_t count) {
+    MockSink sink;
+    Queue queue(sink);
+    Consumer consumer(queue);
+
+    uint32_t full = 0;
+    uint32_t lastTicket = 0;
+    bool ticketsOk = true;
+    for (uint32_t i = 0; i < count; i++) {
+        if (i % 50 == 0) {
+            queue.enqueue(KeyEvent::Action::CHECKPOINT, 0, 0);   // May be dropped when full
+        }
+        uint32_t ticket = enqueueWait(queue, KeyEvent::Action::WRITE, 'a' + i % 26, 0, full);
+        ticketsOk &= ticket != lastTicket;
+        lastTicket = ticket;
+    }
+    bool done = waitFor(queue, lastTicket);
+    consumer.stop();
+    uint32_t checkpoints = queue.getCheckpointCount();
+
+    bool ordered = sink.calls.size() == count;
+    for (uint32_t i = 0; ordered && i < count; i++) {
+        ordered = sink.calls[i].action == KeyEvent::Action::WRITE && sink.calls[i].key == 'a' + i % 26;
+    }
+    char detail[128];
+    snprintf(detail, sizeof(detail), "%u keys, queue full %u times, %u checkpoints",
+             (unsigned)sink.calls.size(), full, checkpoints);
+    report("order through a full queue", done && ordered && ticketsOk && full > 0 && queue.isIdle(), detail);
+}
+
+static void checkGaps() {
+    MockSink sink;
+    Queue queue(sink);
+    Consumer consumer(queue);
+
+    const uint16_t gaps[] = {0, 5, 1, 20, 3, 0, 10};
+    uint32_t full = 0;
+    uint32_t ticket = 0;
+    for (uint16_t gap : gaps) ticket = enqueueWait(queue, KeyEvent::Action::WRITE, 'g', gap, full);
+    bool done = waitFor(queue, ticket);
+    consumer.stop();
+
+    bool kept = done && sink.calls.size() == sizeof(gaps) / sizeof(gaps[0]);
+    for (size_t i = 1; kept && i < sink.calls.size(); i++) {
+        kept = sink.calls[i].millis - sink.calls[i - 1].millis >= gaps[i];
+    }
+    char detail[128];
+    snprintf(detail, sizeof(detail), "%u keys, each at least its gap after the last",
+             (unsigned)sink.calls.size());
+    report("gaps kept", kept, detail);
+}
+
+// The producer sees a ticket done only once its key reached the sink
+static void checkCompletion(uint32_t count) {
+    MockSink sink;
+    Queue queue(sink);
+    Consumer consumer(queue);
+
+    uint32_t full = 0;
+    uint32_t seenDone = 0;      // Tickets reported done so far, in order
+    uint32_t early = 0;         // Reported done before the sink had the key
+    std::vector<uint32_t> tickets;
+    for (uint32_t i = 0; i < count; i++) {
+        tickets.push_back(enqueueWait(queue, KeyEvent::Action::WRITE, 'c', 0, full));
+        while (seenDone < tickets.size() && queue.isDone(tickets[seenDone])) seenDone++;
+        if (sink.callCount.load(std::memory_order_acquire) < seenDone) early++;
+    }
+    bool done = waitFor(queue, tickets.back());
+    consumer.stop();
+
+    char detail[128];
+    snprintf(detail, sizeof(detail), "%u tickets, %u early completions", count, early);
+    report("completion means sent", done && early == 0 && sink.calls.size() == count, detail);
+}
+
+static void checkDisconnect() {
+    MockSink sink;
+    Queue queue(sink);
+    Consumer consumer(queue);
+
+    uint32_t full = 0;
+    for (int i = 0; i < 5; i++) enqueueWait(queue, KeyEvent::Action::WRITE, 'x', 0, full);
+    sink.connected = false;
+    uint32_t ticket = 0;
+    for (int i = 0; i < 10; i++) ticket = enqueueWait(queue, KeyEvent::Action::WRITE, 'y', 0, full);
+
+    // Held: stalled, nothing more sent, nothing dropped
+    uint32_t start = millis();
+    while (!queue.isStalled() && millis() - start < 1000) std::this_thread::yield();
+    bool stalled = queue.isStalled();
+    delay(20);
+    bool held = !queue.isDone(ticket) && queue.getDroppedCount() == 0;
+
+    sink.connected = true;
+    bool done = waitFor(queue, ticket);
+    consumer.stop();
+
+    char detail[128];
+    snprintf(detail, sizeof(detail), "%u keys after reconnecting, %u sent while down",
+             (unsigned)sink.calls.size(), sink.callsWhileDisconnected.load());
+    report("held while disconnected",
+           stalled && held && done && !queue.isStalled() && sink.calls.size() == 15 &&
+               sink.callsWhileDisconnected == 0,
+           detail);
+}
+
+static void checkCancel() {
+    MockSink sink;
+    sink.connected = false;
+    Queue queue(sink);
+    Consumer consumer(queue);
+
+    uint32_t full = 0;
+    uint32_t ticket = 0;
+    for (int i = 0; i < 12; i++) ticket = enqueueWait(queue, KeyEvent::Action::WRITE, 'z', 0, full);
+    queue.cancelPending();
+    sink.connected = true;
+    bool done = waitFor(queue, ticket);
+
+    // The queue works normally afterwards
+    ticket = enqueueWait(queue, KeyEvent::Action::WRITE, 'k', 0, full);
+    done &= waitFor(queue, ticket);
+    consumer.stop();
+
+    char detail[128];
+    snprintf(detail, sizeof(detail), "%u dropped, %u sent", queue.getDroppedCount(), queue.getSentCount());
+    report("cancelPending", done && queue.getDroppedCount() == 12 && sink.calls.size() == 1 &&
+                                sink.calls[0].key == 'k', detail);
+}
+
+// Keys and net characters since the last checkpoint; backspace takes one
+// off, a press/release pair counts as keys only
+static void checkCheckpoints() {
+    MockSink sink;
+    Queue queue(sink);
+    Consumer consumer(queue);
+
+    uint32_t full = 0;
+    enqueueWait(queue, KeyEvent::Action::WRITE, 'a', 0, full);
+    enqueueWait(queue, KeyEvent::Action::CHECKPOINT, 0, 7, full);
+    const char typed[] = "abc\bd";
+    for (const char* p = typed; *p; p++) enqueueWait(queue, KeyEvent::Action::WRITE, *p, 0, full);
+    enqueueWait(queue, KeyEvent::Action::PRESS, KEY_LEFT_SHIFT, 0, full);
+    uint32_t ticket = enqueueWait(queue, KeyEvent::Action::RELEASE, KEY_LEFT_SHIFT, 0, full);
+    bool done = waitFor(queue, ticket);
+    consumer.stop();
+
+    bool ok = done && queue.getCheckpointCount() == 1 && queue.getLastCheckpoint() == 7 &&
+              queue.getKeysSinceCheckpoint() == 7 && queue.getCharsSinceCheckpoint() == 3;
+    char detail[128];
+    snprintf(detail, sizeof(detail), "checkpoint %u, %u keys and %d chars after it",
+             queue.getLastCheckpoint(), queue.getKeysSinceCheckpoint(), queue.getCharsSinceCheckpoint());
+    report("checkpoint counters", ok, detail);
+}
+
+// Keyboard's ProgramSink: plays a keystroke program into the queue
+struct QueueSink {
+    Queue& queue;
+    uint32_t full = 0;
+    uint32_t lastTicket = 0;
+
+    void key(uint8_t k, uint16_t gap) { add(KeyEvent::Action::WRITE, k, gap); }
+    void press(uint8_t k, uint16_t gap) { add(KeyEvent::Action::PRESS, k, gap); }
+    void release(uint8_t k, uint16_t gap) { add(KeyEvent::Action::RELEASE, k, gap); }
+    void releaseAll(uint16_t gap) { add(KeyEvent::Action::RELEASE_ALL, 0, gap); }
+    void checkpoint(uint32_t id) { add(KeyEvent::Action::CHECKPOINT, 0, id); }
+
+    void add(KeyEvent::Action action, uint8_t key, uint32_t value) {
+        while ((lastTicket = queue.enqueue(action, key, value)) == 0) {
+            full++;
+            std::this_thread::yield();
+        }
+    }
+};
+
+// Checkpoint ids are text offsets; a long clip text goes past 65535 and
+// the journal resumes from whatever id comes back
+static void checkLongOffset() {
+    MockSink sink;
+    Queue queue(sink);
+    Consumer consumer(queue);
+
+    const uint32_t offset = 70001;
+    Hid::ProgramBuilder program;
+    program.key('a');
+    program.key('b');
+    program.checkpoint(offset);
+    program.key('c');
+    program.end();
+    QueueSink queueSink{queue};
+    Hid::KeystrokeVM::run(program.data(), program.size(), queueSink);
+    bool done = waitFor(queue, queueSink.lastTicket);
+    consumer.stop();
+
+    bool ok = done && queue.getLastCheckpoint() == offset && queue.getKeysSinceCheckpoint() == 1;
+    char detail[128];
+    snprintf(detail, sizeof(detail), "checkpoint %u read back as %u",
+             (unsigned)offset, (unsigned)queue.getLastCheckpoint());
+    report("checkpoint past 16 bits", ok, detail);
+}
+
+int main(int argc, char** argv) {
+    uint32_t count = 200000;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--count") == 0 && i + 1 < argc) count = atoi(argv[++i]);
+    }
+    checkOrder(count);
+    checkGaps();
+    checkCompletion(count / 10);
+    checkDisconnect();
+    checkCancel();
+    checkCheckpoints();
+    checkLongOffset();
+    printf(failures ? "%d check(s) FAILED\n" : "All checks passed\n", failures);
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,347 @@
+// text.txt parsing benchmark. Times the streaming tokenizer alone
+// (TextParser::visitFile with a counting visitor), the full
+// TextParser::parseFile model build on top of it, and the line-by-line
+// String parser they replaced, kept below as the reference. Inputs are the
+// data directory's text.txt and copies of its clips repeated to about
+// 100 KB and 1 MB. Every allocation is counted, with the peak heap in use
+// while a file is parsed. Checks that both parsers find the same clips
+// and timeframes, and that the tokenizer's allocations and peak heap do
+// not grow with the file. Exits non-zero on a failed check. Build and
+// usage are described in tools/README.md.
+#include <Arduino.h>
+#include <SPIFFS.h>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <new>
+#include <string>
+#include <unistd.h>
+#include <vector>
+#include "analysis/text_parser.h"
+
+using Analysis::ClipData;
+using Analysis::TextParser;
+using Analysis::TextSpan;
+using Analysis::TimeFrame;
+
+// Every allocation is counted; a header keeps its size for the live total
+static std::atomic<uint32_t> allocations{0};
+static std::atomic<size_t> liveBytes{0};
+static std::atomic<size_t> peakBytes{0};
+static const size_t HEADER = alignof(std::max_align_t);
+
+void* operator new(size_t size) {
+    allocations++;
+    char* p = static_cast<char*>(malloc(size + HEADER));
+    if (!p) throw std::bad_alloc();
+    *reinterpret_cast<size_t*>(p) = size;
+    size_t live = liveBytes += size;
+    size_t peak = peakBytes;
+    while (live > peak && !peakBytes.compare_exchange_weak(peak, live)) {}
+    return p + HEADER;
+}
+void operator delete(void* p) noexcept {
+    if (!p) return;
+    char* block = static_cast<char*>(p) - HEADER;
+    liveBytes -= *reinterpret_cast<size_t*>(block);
+    free(block);
+}
+void operator delete(void* p, size_t) noexcept { operator delete(p); }
+
+static int failures = 0;
+
+static void report(const char* name, bool ok, const char* detail) {
+    printf("%-30s %s  %s\n", name, ok ? "OK  " : "FAIL", detail);
+    if (!ok) failures++;
+}
+
+// The parser as it was before the tokenizer: a String per line, trimmed
+// and cut with substring(), description text appended line by line
+namespace LineParser {
+    static void parseTimeStamps(const String& line, TimeFrame& frame) {
+        int firstStart = line.indexOf('<') + 1;
+        int firstEnd = line.indexOf('>');
+        int secondStart = line.indexOf('<', firstEnd) + 1;
+        int secondEnd = line.indexOf('>', secondStart);
+        frame.startTime = TimeFrame::TimeStamp::fromString(line.substring(firstStart, firstEnd));
+        frame.endTime = TimeFrame::TimeStamp::fromString(line.substring(secondStart, secondEnd));
+    }
+
+    static void parseTimeFrame(const String& line, ClipData& clip) {
+        TimeFrame frame;
+        if (line.indexOf("[CM]") >= 0) {
+            frame.type = TimeFrame::Type::CAMERA_MOVEMENT;
+            clip.cameraMovements++;
+        } else if (line.indexOf("[CT]") >= 0) {
+            frame.type = TimeFrame::Type::CAMERA_TRANSITION;
+            clip.cameraTransitions++;
+        } else {
+            frame.type = TimeFrame::Type::TYPING;
+            clip.actionDescriptions++;
+        }
+        parseTimeStamps(line, frame);
+        int contentStart = line.indexOf('>') + 1;
+        if (contentStart < (int)line.length()) {
+            String content = line.substring(contentStart);
+            content.trim();
+            frame.content = content;
+        }
+        clip.timeframes.push_back(frame);
+    }
+
+    static void parseClipHeader(const String& line, ClipData& clip) {
+        int numStart = line.indexOf('#') + 1;
+        int numEnd = line.indexOf('<');
+        clip.number = line.substring(numStart, numEnd).toInt();
+        TimeFrame boundary;
+        boundary.type = TimeFrame::Type::CLIP_BOUNDARY;
+        parseTimeStamps(line, boundary);
+        clip.timeframes.push_back(boundary);
+    }
+
+    static TextParser::ParseResult parse(Stream& file) {
+        TextParser::ParseResult result;
+        result.isValid = false;
+        String line = file.readStringUntil('\n');
+        if (!line.startsWith("Video ")) {
+            result.errorMessage = "Invalid file format: Missing Video ID";
+            return result;
+        }
+        String id = line.substring(6);
+        id.trim();
+        result.videoId = id;
+
+        ClipData currentClip;
+        bool inClip = false;
+        String contentBuffer;
+        while (file.available()) {
+            line = file.readStringUntil('\n');
+            String trimmedLine = line;
+            trimmedLine.trim();
+
+            if (trimmedLine.startsWith("Clip #")) {
+                if (inClip) result.clips.push_back(currentClip);
+                currentClip = ClipData();
+                inClip = true;
+                parseClipHeader(trimmedLine, currentClip);
+            } else if (inClip) {
+                if (trimmedLine.indexOf('<') >= 0) {
+                    if (!contentBuffer.isEmpty()) {
+                        currentClip.mainDescription = contentBuffer;
+                        contentBuffer = "";
+                    }
+                    parseTimeFrame(trimmedLine, currentClip);
+                } else if (!trimmedLine.isEmpty()) {
+                    contentBuffer += trimmedLine + "\n";
+                }
+            }
+        }
+        if (inClip) result.clips.push_back(currentClip);
+        result.isValid = true;
+        return result;
+    }
+}
+
+// The whole file in memory, one byte per read() as Arduino's Stream
+// reads it. The reference parser gets this instead of a shim File, whose
+// available() seeks the file on every call.
+class MemoryStream : public Stream {
+public:
+    explicit MemoryStream(const std::string& text) : text(text) {}
+    int available() override { return (int)(text.size() - position); }
+    int read() override { return position < text.size() ? (uint8_t)text[position++] : -1; }
+    size_t write(uint8_t) override { return 0; }
+
+private:
+    const std::string& text;
+    size_t position = 0;
+};
+
+// Tokenizer events only, nothing kept
+struct CountingVisitor : Analysis::TextVisitor {
+    uint32_t clips = 0;
+    uint32_t timeframes = 0;
+    size_t descriptionBytes = 0;
+
+    void onClipHeader(int, uint32_t, uint32_t, uint32_t, uint32_t) { clips++; }
+    void onTimeframe(Marker, uint32_t, uint32_t, TextSpan, uint32_t) { timeframes++; }
+    void onDescription(TextSpan text, bool) { descriptionBytes += text.length; }
+};
+
+struct Run {
+    double megabytesPerSecond = 0;
+    uint32_t allocations = 0;      // Per file
+    size_t peakBytes = 0;          // Heap in use at the peak, above the start
+};
+
+// Times `rounds` parses; allocations and peak are taken from the first
+template<typename Parse>
+static Run measure(size_t fileBytes, int rounds, Parse parse) {
+    Run run;
+    size_t start = liveBytes;
+    peakBytes = start;
+    uint32_t before = allocations;
+    parse();
+    run.allocations = allocations - before;
+    run.peakBytes = peakBytes - start;
+
+    auto begin = std::chrono::steady_clock::now();
+    for (int i = 0; i < rounds; i++) parse();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+    run.megabytesPerSecond = (double)fileBytes * rounds / seconds / 1e6;
+    return run;
+}
+
+static bool readFile(const std::string& path, std::string& text) {
+    FILE* f = fopen(path.c_str(), "rb");
+    if (!f) return false;
+    char chunk[4096];
+    size_t n;
+    while ((n = fread(chunk, 1, sizeof(chunk), f)) > 0) text.append(chunk, n);
+    fclose(f);
+    return true;
+}
+
+// The Video line, then the clips `copies` times over with clip numbers
+// continuing
+static std::string repeatClips(const std::string& text, int copies) {
+    size_t body = text.find('\n') + 1;
+    std::string out = text.substr(0, body);
+    int number = 1;
+    for (int k = 0; k < copies; k++) {
+        size_t pos = body;
+        while (pos < text.size()) {
+            size_t end = text.find('\n', pos);
+            if (end == std::string::npos) end = text.size();
+            std::string line = text.substr(pos, end - pos);
+            size_t first = line.find_first_not_of(" \t");
+            if (first != std::string::npos && line.compare(first, 6, "Clip #") == 0) {
+                size_t rest = line.find('<');
+                line = "Clip #" + std::to_string(number++) + " " + (rest == std::string::npos ? "" : line.substr(rest));
+            }
+            out += line;
+            out += '\n';
+            pos = end + 1;
+        }
+    }
+    return out;
+}
+
+static bool sameClips(const TextParser::ParseResult& a, const TextParser::ParseResult& b) {
+    if (!a.isValid || !b.isValid || a.clips.size() != b.clips.size() || a.videoId != b.videoId) return false;
+    for (size_t i = 0; i < a.clips.size(); i++) {
+        const auto& x = a.clips[i];
+        const auto& y = b.clips[i];
+        if (x.number != y.number || x.timeframes.size() != y.timeframes.size()) return false;
+        for (size_t f = 0; f < x.timeframes.size(); f++) {
+            const auto& p = x.timeframes[f];
+            const auto& q = y.timeframes[f];
+            if (p.type != q.type || p.startTime.toMillis() != q.startTime.toMillis() ||
+                p.endTime.toMillis() != q.endTime.toMillis()) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+int main(int argc, char** argv) {
+    const char* dataDir = "data";
+    double megabytes = 16;     // Read per parser and file size
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--megabytes") == 0 && i + 1 < argc) megabytes = atof(argv[++i]);
+        else dataDir = argv[i];
+    }
+
+    std::string source;
+    if (!readFile(std::string(dataDir) + Analysis::TextParser::DEFAULT_PATH, source)) {
+        fprintf(stderr, "ERROR: cannot read %s%s\n", dataDir, Analysis::TextParser::DEFAULT_PATH);
+        return 1;
+    }
+
+    // The files are written here in turn and read through SPIFFS
+    char dir[] = "/tmp/parse_bench_XXXXXX";
+    if (!mkdtemp(dir)) {
+        fprintf(stderr, "ERROR: cannot create a temporary directory\n");
+        return 1;
+    }
+    std::string path = std::string(dir) + Analysis::TextParser::DEFAULT_PATH;
+    SPIFFS.setRoot(dir);
+
+    char name[48];
+    char detail[128];
+    std::vector<Run> tokenizerRuns;
+    for (int copies : {1, 20, 200}) {
+        std::string text = repeatClips(source, copies);
+        FILE* f = fopen(path.c_str(), "wb");
+        fwrite(text.data(), 1, text.size(), f);
+        fclose(f);
+        int rounds = std::max(1, (int)(megabytes * 1e6 / text.size()));
+
+        CountingVisitor counted;
+        Run tokenizer = measure(text.size(), rounds, [&] {
+            CountingVisitor visitor;
+            String error;
+            TextParser::visitFile(visitor, error);
+            counted = visitor;
+        });
+        Run parser = measure(text.size(), rounds, [] { TextParser::parseFile(); });
+        Run lines = measure(text.size(), rounds, [&] {
+            MemoryStream stream(text);
+            LineParser::parse(stream);
+        });
+        tokenizerRuns.push_back(tokenizer);
+
+        printf("\n%zu bytes, %u clips %18s %12s %12s\n", text.size(), counted.clips, "MB/s", "allocations",
+               "peak bytes");
+        printf("  %-30s %10.1f %12u %12zu\n", "tokenizer (visitFile)", tokenizer.megabytesPerSecond,
+               tokenizer.allocations, tokenizer.peakBytes);
+        printf("  %-30s %10.1f %12u %12zu\n", "parseFile", parser.megabytesPerSecond, parser.allocations,
+               parser.peakBytes);
+        printf("  %-30s %10.1f %12u %12zu\n", "line-by-line String parser", lines.megabytesPerSecond,
+               lines.allocations, lines.peakBytes);
+
+        MemoryStream stream(text);
+        auto expected = LineParser::parse(stream);
+        auto parsed = TextParser::parseFile();
+        snprintf(name, sizeof(name), "same clips, %zu bytes", text.size());
+        snprintf(detail, sizeof(detail), "%u clips, %u timeframes", (unsigned)parsed.clips.size(),
+                 counted.timeframes);
+        report(name, sameClips(parsed, expected) && counted.clips == parsed.clips.size(), detail);
+    }
+
+    // Opening the file allocates on the host; the tokenizer adds nothing
+    // to that, however long the file
+    const Run& first = tokenizerRuns.front();
+    bool bounded = true;
+    for (const auto& run : tokenizerRuns) {
+        bounded &= run.allocations == first.allocations && run.peakBytes == first.peakBytes;
+    }
+    snprintf(detail, sizeof(detail), "%u allocations, %zu bytes peak at every size", first.allocations,
+             first.peakBytes);
+    report("tokenizer heap bounded", bounded, detail);
+
+    // And none at all over a source already open
+    std::string text = repeatClips(source, 20);
+    uint32_t before = allocations;
+    MemoryStream stream(text);
+    struct Source {
+        MemoryStream& stream;
+        size_t read(uint8_t* buffer, size_t size) {
+            size_t n = 0;
+            while (n < size && stream.available()) buffer[n++] = stream.read();
+            return n;
+        }
+    } memory{stream};
+    CountingVisitor visitor;
+    Analysis::TextTokenizer<> tokenizer;
+    bool ok = tokenizer.tokenize(memory, visitor);
+    uint32_t allocated = allocations - before;
+    snprintf(detail, sizeof(detail), "%u allocations for %zu bytes", allocated, text.size());
+    report("tokenize() allocates nothing", ok && allocated == 0, detail);
+
+    unlink(path.c_str());
+    rmdir(dir);
+    printf(failures ? "%d check(s) FAILED\n" : "All checks passed\n", failures);
+    return failures ? 1 : 0;
+}
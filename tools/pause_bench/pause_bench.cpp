@@ -0,0 +1,145 @@
+// Pause map benchmark. Times the per-character natural pause check of
+// HumanSimulator::typeText both ways: Utils::PauseMap, built once per text
+// and read with one bit test per character, against the check it
+// replaced, kept below as the reference (four indexOf() scans of the
+// whole text after every character). Inputs are the longest descriptions
+// in the data directory's text.txt, the longest again without
+// punctuation (the old check's worst case) and an 8x longer text. Checks
+// that the map marks exactly the punctuation, that rebuilding it reuses
+// its storage, and that it is cheaper than the scan on every text. Exits
+// non-zero on a failed check. Build and usage are described in
+// tools/README.md.
+#include <Arduino.h>
+#include <SPIFFS.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <new>
+#include <vector>
+#include "analysis/text_parser.h"
+#include "utils/pause_map.h"
+
+using Utils::PauseMap;
+
+static std::atomic<uint32_t> allocations{0};
+
+void* operator new(size_t size) {
+    allocations++;
+    if (void* p = malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+void operator delete(void* p) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { free(p); }
+
+static int failures = 0;
+
+static void report(const char* name, bool ok, const char* detail) {
+    printf("%-30s %s  %s\n", name, ok ? "OK  " : "FAIL", detail);
+    if (!ok) failures++;
+}
+
+// The check as it was: whether the text holds any punctuation, asked
+// again after every character
+static PauseMap::Pause scanPause(const String& text) {
+    if (text.indexOf('.') >= 0 || text.indexOf('!') >= 0 || text.indexOf('?') >= 0) {
+        return PauseMap::Pause::SENTENCE;
+    }
+    if (text.indexOf(',') >= 0) return PauseMap::Pause::WORD;
+    return PauseMap::Pause::NONE;
+}
+
+static PauseMap::Pause expectedPause(char c) {
+    if (c == '.' || c == '!' || c == '?') return PauseMap::Pause::SENTENCE;
+    if (c == ',') return PauseMap::Pause::WORD;
+    return PauseMap::Pause::NONE;
+}
+
+// Both loops count pauses so the compiler has to keep every check
+template<typename Check>
+static double nanosPerChar(const String& text, int rounds, uint32_t& pauses, Check check) {
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < rounds; r++) pauses = check();
+    double nanos = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    return nanos / rounds / std::max(1u, text.length());
+}
+
+int main(int argc, char** argv) {
+    const char* dataDir = "data";
+    int rounds = 2000;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--rounds") == 0 && i + 1 < argc) rounds = atoi(argv[++i]);
+        else dataDir = argv[i];
+    }
+
+    SPIFFS.setRoot(dataDir);
+    auto task = Analysis::TextParser::parseFile();
+    if (!task.isValid) {
+        fprintf(stderr, "ERROR: cannot parse %s/text.txt: %s\n", dataDir, task.errorMessage.c_str());
+        return 1;
+    }
+
+    // Everything typeText() gets: main descriptions and timeframe text
+    std::vector<String> texts;
+    for (const auto& clip : task.clips) {
+        texts.push_back(clip.mainDescription);
+        for (const auto& frame : clip.timeframes) texts.push_back(frame.content);
+    }
+    std::sort(texts.begin(), texts.end(),
+              [](const String& a, const String& b) { return a.length() > b.length(); });
+    texts.resize(std::min<size_t>(texts.size(), 3));
+
+    std::vector<std::pair<const char*, String>> inputs;
+    static const char* labels[] = {"longest", "2nd longest", "3rd longest"};
+    for (size_t i = 0; i < texts.size(); i++) inputs.push_back({labels[i], texts[i]});
+    String bare;
+    for (char c : texts[0]) bare += expectedPause(c) == PauseMap::Pause::NONE ? c : ' ';
+    inputs.push_back({"longest, no punctuation", bare});
+    String longer;
+    for (int i = 0; i < 8; i++) longer += texts[0];
+    inputs.push_back({"longest x8", longer});
+
+    PauseMap map;
+    bool marked = true;
+    char detail[128];
+    printf("%-26s %6s %12s %10s %8s %14s\n", "text", "chars", "scan ns/ch", "map ns/ch", "speedup",
+           "pauses before/after");
+    bool cheaper = true;
+    for (const auto& input : inputs) {
+        const String& text = input.second;
+        map.build(text);
+        for (size_t i = 0; i < text.length(); i++) marked &= map.at(i) == expectedPause(text[i]);
+
+        uint32_t before = 0;
+        uint32_t after = 0;
+        int textRounds = std::max(1, (int)(rounds * 1000 / std::max(1000u, text.length())));
+        double scan = nanosPerChar(text, textRounds, before, [&] {
+            uint32_t n = 0;
+            for (size_t i = 0; i < text.length(); i++) n += scanPause(text) != PauseMap::Pause::NONE;
+            return n;
+        });
+        double mapped = nanosPerChar(text, textRounds, after, [&] {
+            map.build(text);
+            uint32_t n = 0;
+            for (size_t i = 0; i < text.length(); i++) n += map.at(i) != PauseMap::Pause::NONE;
+            return n;
+        });
+        printf("%-26s %6u %12.1f %10.1f %7.1fx %9u/%u\n", input.first, text.length(), scan, mapped,
+               scan / mapped, before, after);
+        cheaper &= mapped < scan;
+    }
+    printf("\n");
+    report("punctuation marked", marked, "map.at() matches every character of every text");
+
+    // Typing reuses one map; a rebuild no longer than the last must not
+    // touch the heap
+    map.build(longer);
+    uint32_t allocated = allocations;
+    for (const auto& input : inputs) map.build(input.second);
+    allocated = allocations - allocated;
+    snprintf(detail, sizeof(detail), "%u allocations in %u rebuilds", allocated, (unsigned)inputs.size());
+    report("storage reused", allocated == 0, detail);
+    report("map cheaper", cheaper, "map (build included) beats the scan on every text");
+
+    printf(failures ? "%d check(s) FAILED\n" : "All checks passed\n", failures);
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,265 @@
+// Dropped link test. Types every clip of the data directory's text.txt
+// through HumanSimulator, the real Keyboard and the loopback transport on
+// the shim's virtual clock, and takes the link down every few hundred
+// keys for a few seconds. Every third time it drops again a few reports
+// after coming back, often while the resume is still erasing. The loop
+// that retries a clip waits for the link as loop() in src/main.cpp does.
+// Per clip it reports the keys wasted (sent past the last checkpoint,
+// then erased) and the resume latency, from the link coming back to the
+// first key. Checks that every clip ends up on screen whole, with nothing
+// retyped or lost, that no clip is navigated to twice, and that no run of
+// a clip wastes more than two words' worth of keys: one word sent past a
+// checkpoint and one erased. Exits non-zero on a failed check. Build and
+// usage are described in tools/README.md.
+#include <Arduino.h>
+#include <SPIFFS.h>
+#include <algorithm>
+#include <string>
+#include <vector>
+#include "analysis/text_parser.h"
+#include "human_simulator.h"
+#include "keyboard.h"
+#include "utils/scheduler.h"
+
+static int failures = 0;
+
+static void report(const char* name, bool ok, const char* detail) {
+    printf("%-30s %s  %s\n", name, ok ? "OK  " : "FAIL", detail);
+    if (!ok) failures++;
+}
+
+static Ui::Link uiLink;
+static Keyboard keyboard;
+static Utils::Random rng;
+static HumanSimulator simulator(keyboard, uiLink, rng);
+
+// What loop() in src/main.cpp sleeps while the link is down
+static const uint32_t LINK_POLL = 1000;
+
+// Runs of one clip before giving up; a resume that restarted the clip
+// would never get through between drops
+static const int MAX_RUNS = 100;
+
+// Turns reports back into the text they leave on screen
+class Screen {
+public:
+    std::string text;
+    uint32_t tabs = 0;
+
+    Screen() {
+        for (int c = 1; c < 128; c++) {
+            Hid::KeyCode code = Hid::KeyMap::lookup(c);
+            bool shift = code.modifiers != 0;
+            if (code.usage && !chars[shift][code.usage]) chars[shift][code.usage] = c;
+        }
+    }
+
+    void add(const Hid::BootReport& report) {
+        for (uint8_t usage : report.keys) {
+            if (!usage || isHeld(usage)) continue;
+            if (usage == USAGE_BACKSPACE) {
+                if (!text.empty()) text.pop_back();
+            } else if (usage == USAGE_TAB) {
+                tabs++;
+            } else if (usage == USAGE_ENTER) {
+                text += '\n';
+            } else if (char c = chars[report.modifiers ? 1 : 0][usage]) {
+                text += c;
+            }
+        }
+        memcpy(held, report.keys, sizeof(held));
+    }
+
+    void clear() {
+        text.clear();
+        tabs = 0;
+    }
+
+private:
+    static constexpr uint8_t USAGE_ENTER = 0x28;
+    static constexpr uint8_t USAGE_BACKSPACE = 0x2A;
+    static constexpr uint8_t USAGE_TAB = 0x2B;
+    char chars[2][256] = {};
+    uint8_t held[6] = {};
+
+    bool isHeld(uint8_t usage) const {
+        for (uint8_t h : held) if (h == usage) return true;
+        return false;
+    }
+};
+
+// Scheduler task: reads new reports and drops and restores the link
+struct Injector {
+    uint32_t every = 600;        // Reports between drops
+    uint32_t outage = 2500;      // Milliseconds down
+    uint32_t nextDrop = 0;
+    uint32_t reconnectAt = 0;
+    uint32_t reconnectedAt = 0;
+    uint32_t drops = 0;
+    bool awaitingKey = false;
+    uint32_t seen = 0;
+    uint32_t lost = 0;
+    Screen screen;
+    std::vector<uint32_t> latencies;   // Link back to first key, per drop
+
+    static uint32_t scheduled(void* param) { return static_cast<Injector*>(param)->run(); }
+
+    uint32_t run() {
+        auto& transport = keyboard.getTransport();
+        uint32_t total = transport.total();
+        uint32_t kept = transport.size();
+        if (total - seen > kept) {
+            lost += total - seen - kept;
+            seen = total - kept;
+        }
+        bool newKeys = seen < total;
+        for (; seen < total; seen++) screen.add(transport.at(kept - (total - seen)).report);
+
+        uint32_t now = millis();
+        if (awaitingKey && newKeys) {
+            latencies.push_back(now - reconnectedAt);
+            awaitingKey = false;
+        }
+        if (transport.isConnected() && total >= nextDrop) {
+            transport.setConnected(false);
+            reconnectAt = now + outage;
+            drops++;
+        } else if (!transport.isConnected() && (int32_t)(now - reconnectAt) >= 0) {
+            transport.setConnected(true);
+            reconnectedAt = now;
+            awaitingKey = true;
+            // Every third outage is followed by one a few reports in
+            nextDrop = total + (drops % 3 == 0 ? 6 : every);
+        }
+        return 1;
+    }
+};
+
+static std::vector<size_t> wordLengths(const std::string& text) {
+    std::vector<size_t> lengths;
+    size_t n = 0;
+    for (char c : text) {
+        if (c == ' ' || c == '\n') {
+            if (n) lengths.push_back(n);
+            n = 0;
+        } else {
+            n++;
+        }
+    }
+    if (n) lengths.push_back(n);
+    return lengths;
+}
+
+int main(int argc, char** argv) {
+    const char* dataDir = "data";
+    unsigned long seed = 1;
+    Injector injector;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) seed = strtoul(argv[++i], nullptr, 10);
+        else if (strcmp(argv[i], "--every") == 0 && i + 1 < argc) injector.every = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--outage") == 0 && i + 1 < argc) injector.outage = atoi(argv[++i]);
+        else dataDir = argv[i];
+    }
+
+    SPIFFS.setRoot(dataDir);
+    auto task = Analysis::TextParser::parseFile();
+    if (!task.isValid) {
+        fprintf(stderr, "ERROR: cannot parse %s/text.txt: %s\n", dataDir, task.errorMessage.c_str());
+        return 1;
+    }
+    size_t longestWord = 0;
+
+    setVirtualClock(true);
+    rng.seed(seed);
+    keyboard.init(Keyboard::OutputMode::SCHEDULER);
+    simulator.init();
+    simulator.loadTask();
+    simulator.resume();
+    injector.nextDrop = injector.every;
+    Utils::Scheduler::instance().add("injector", Injector::scheduled, &injector);
+
+    printf("%-6s %6s %8s %12s %12s %14s\n", "clip", "keys", "drops", "wasted keys", "worst run",
+           "max latency");
+    bool whole = true;
+    bool navigatedOnce = true;
+    uint32_t worstWaste = 0;
+    for (const auto& clip : task.clips) {
+        // Each text after the first starts on a new line
+        std::string expected = clip.mainDescription.c_str();
+        for (const auto& frame : clip.timeframes) {
+            if (frame.type != Analysis::TimeFrame::Type::TYPING || frame.content.isEmpty()) continue;
+            if (!expected.empty()) expected += '\n';
+            expected += frame.content.c_str();
+        }
+        for (size_t n : wordLengths(expected)) longestWord = std::max(longestWord, n);
+
+        injector.screen.clear();
+        uint32_t keysBefore = keyboard.getTransport().total() / 2;
+        uint32_t dropsBefore = injector.drops;
+        size_t latenciesBefore = injector.latencies.size();
+        uint32_t wastedBefore = simulator.getPerformanceMetrics().wastedKeystrokes;
+        uint32_t clipWorst = 0;
+
+        // As loop() does: wait for the link, run the clip until it finishes
+        bool finished = false;
+        for (int runs = 0; !finished && runs < MAX_RUNS;) {
+            if (!keyboard.isConnected()) {
+                Utils::sleepFor(LINK_POLL);
+                continue;
+            }
+            uint32_t wastedStart = simulator.getPerformanceMetrics().wastedKeystrokes;
+            finished = simulator.processClip(clip.number);
+            uint32_t wasted = simulator.getPerformanceMetrics().wastedKeystrokes - wastedStart;
+            clipWorst = std::max(clipWorst, wasted);
+            runs++;
+        }
+        keyboard.flush();
+        Utils::sleepFor(10);
+        injector.run();
+
+        uint32_t wasted = simulator.getPerformanceMetrics().wastedKeystrokes - wastedBefore;
+        uint32_t maxLatency = 0;
+        for (size_t i = latenciesBefore; i < injector.latencies.size(); i++) {
+            maxLatency = std::max(maxLatency, injector.latencies[i]);
+        }
+        bool ok = finished && wordLengths(injector.screen.text) == wordLengths(expected);
+        whole &= ok;
+        int tabs = clip.number == 1 ? Constants::Navigation::FIRST_CLIP_TAB_COUNT
+                                    : Constants::Navigation::NEXT_CLIP_TAB_COUNT;
+        navigatedOnce &= (int)injector.screen.tabs == tabs;
+        worstWaste = std::max(worstWaste, clipWorst);
+        printf("%-6d %6u %8u %12u %12u %11u ms%s\n", clip.number,
+               keyboard.getTransport().total() / 2 - keysBefore, injector.drops - dropsBefore, wasted,
+               clipWorst, maxLatency, ok ? "" : finished ? "  MISMATCH" : "  GAVE UP");
+        if (finished && !ok) {
+            printf("  got:      %s\n  expected: %s\n", injector.screen.text.c_str(), expected.c_str());
+        }
+    }
+    printf("\n");
+
+    // A run erases what the last drop left and loses what it sent past
+    // its own last checkpoint. A word with a typo fixed is its letters, a
+    // wrong key and a backspace.
+    uint32_t budget = 2 * (longestWord + 2);
+    uint32_t wastedAll = simulator.getPerformanceMetrics().wastedKeystrokes;
+    char detail[128];
+    snprintf(detail, sizeof(detail), "%u drops, %u keys wasted in all", injector.drops, wastedAll);
+    report("clips typed whole", whole && injector.drops > 0 && injector.lost == 0, detail);
+    report("navigated once per clip", navigatedOnce, "no tabs beyond each clip's own navigation");
+    snprintf(detail, sizeof(detail), "at most %u keys in one run, budget %u", worstWaste, budget);
+    report("waste within two words", worstWaste <= budget, detail);
+
+    uint32_t sum = 0;
+    uint32_t worst = 0;
+    for (uint32_t latency : injector.latencies) {
+        sum += latency;
+        worst = std::max(worst, latency);
+    }
+    if (!injector.latencies.empty()) {
+        printf("Resume latency: avg %u ms, max %u ms over %u resumes (link poll %u ms)\n",
+               sum / (uint32_t)injector.latencies.size(), worst, (unsigned)injector.latencies.size(),
+               LINK_POLL);
+    }
+    printf(failures ? "%d check(s) FAILED\n" : "All checks passed\n", failures);
+    return failures ? 1 : 0;
+}
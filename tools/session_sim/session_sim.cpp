@@ -0,0 +1,447 @@
+// Full session simulation. Links the firmware itself (setup() and loop()
+// from src/main.cpp) against the host shim: virtual clock, SPIFFS backed
+// by the data directory, loopback keyboard transport. A scripted operator
+// presses the button through the shim pin, once to start and twice after
+// each completed section, as a person would. Every key the keyboard sends
+// and every operator/engine event goes to a trace file with its virtual
+// time. The typed text of each clip is checked word by word against the
+// parsed task (typos change letters, not word lengths), and the last word
+// of each text must not run into the first of the next. Every '.' that
+// ends a sentence must be followed by the sentence pause. Whenever keys go
+// out, the simulator's progress must name the clip being typed, and its
+// measured speed must keep moving while a text types, not only between
+// texts. In the middle of clip 5's description the operator pauses for a
+// few seconds. The pause must land within PAUSE_LATENCY of the press,
+// not a double-press window later. Keys must stop once it lands, and the
+// clip must still type out whole after resuming. The firmware's event
+// trace (utils/trace.h) is dumped at the end of the --log; the part
+// recorded by setup() also tells which file the task came from, and a
+// loaded task.bin must mean text.txt was never tokenized. Exits non-zero
+// on a mismatch or if the session does not finish. Build and usage are
+// described in tools/README.md.
+#include <Arduino.h>
+#include <SPIFFS.h>
+#include <chrono>
+#include <cstdarg>
+#include <string>
+#include <vector>
+#include "analysis/text_parser.h"
+#include "human_simulator.h"
+#include "keyboard.h"
+#include "utils/log.h"
+#include "utils/scheduler.h"
+
+// From src/main.cpp
+void setup();
+void loop();
+extern Keyboard keyboard;
+extern HumanSimulator simulator;
+extern Utils::Random rng;
+extern int currentClip;
+extern bool paused;
+extern bool sectionComplete;
+extern bool allClipsDone;
+
+static FILE* trace = nullptr;
+
+// Key batches per measured-speed update, at most
+static const uint32_t FEEDBACK_EVERY = 20;
+
+static void event(const char* kind, const char* format = "", ...) __attribute__((format(printf, 2, 3)));
+static void event(const char* kind, const char* format, ...) {
+    fprintf(trace, "%10lu %-10s ", millis(), kind);
+    va_list args;
+    va_start(args, format);
+    vfprintf(trace, format, args);
+    va_end(args);
+    fputc('\n', trace);
+}
+
+// HID usage (+ shift) back to the character that produced it
+class KeyDecoder {
+public:
+    KeyDecoder() {
+        for (int c = 1; c < 128; c++) {
+            Hid::KeyCode code = Hid::KeyMap::lookup(c);
+            bool shift = code.modifiers != 0;
+            if (code.usage && !chars[shift][code.usage]) chars[shift][code.usage] = c;
+        }
+    }
+
+    // Name of the key for the trace, and what it does to the text
+    const char* apply(uint8_t usage, uint8_t modifiers, std::string& text) {
+        static char name[4];
+        switch (usage) {
+            case USAGE_BACKSPACE:
+                if (!text.empty()) text.pop_back();
+                return "<bs>";
+            case USAGE_TAB:
+                return "<tab>";
+            case USAGE_ENTER:
+                text += '\n';
+                return "<enter>";
+        }
+        char c = chars[modifiers ? 1 : 0][usage];
+        if (!c) return "<?>";
+        text += c;
+        snprintf(name, sizeof(name), "'%c'", c);
+        return name;
+    }
+
+private:
+    static constexpr uint8_t USAGE_ENTER = 0x28;
+    static constexpr uint8_t USAGE_BACKSPACE = 0x2A;
+    static constexpr uint8_t USAGE_TAB = 0x2B;
+    char chars[2][256] = {};
+};
+
+// Turns new loopback reports into KEY lines; a key counts when it first
+// appears in a report
+struct ReportTap {
+    KeyDecoder decoder;
+    uint32_t seen = 0;
+    uint8_t held[6] = {};
+    uint32_t keys = 0;
+    uint32_t lost = 0;
+    std::string text;        // Of the clip being typed
+
+    // Sentence ends ('.' then a space or newline) and those whose gap
+    // after the '.' was shorter than the sentence pause
+    uint32_t sentenceEnds = 0;
+    uint32_t shortSentenceGaps = 0;
+    char lastChar = 0;
+    uint32_t lastKeyMillis = 0;
+
+    void drain() {
+        auto& transport = keyboard.getTransport();
+        uint32_t total = transport.total();
+        uint32_t kept = transport.size();
+        if (total - seen > kept) {
+            lost += total - seen - kept;
+            seen = total - kept;
+        }
+        for (; seen < total; seen++) {
+            const auto& record = transport.at(kept - (total - seen));
+            for (uint8_t usage : record.report.keys) {
+                if (!usage || isHeld(usage)) continue;
+                size_t length = text.size();
+                const char* name = decoder.apply(usage, record.report.modifiers, text);
+                uint32_t at = record.timestampMicros / 1000;
+                fprintf(trace, "%10u %-10s %s\n", at, "KEY", name);
+                keys++;
+
+                char c = text.size() > length ? text.back() : 0;
+                if (lastChar == '.' && (c == ' ' || c == '\n')) {
+                    sentenceEnds++;
+                    if (at - lastKeyMillis < (uint32_t)Constants::Typing::SENTENCE_PAUSE) shortSentenceGaps++;
+                }
+                lastChar = c;
+                lastKeyMillis = at;
+            }
+            memcpy(held, record.report.keys, sizeof(held));
+        }
+    }
+
+    bool isHeld(uint8_t usage) const {
+        for (uint8_t h : held) if (h == usage) return true;
+        return false;
+    }
+};
+
+static ReportTap tap;
+
+// Button script: levels to put on the pin at given times
+struct Operator {
+    struct Step {
+        uint32_t at;
+        uint8_t level;
+    };
+    std::vector<Step> steps;
+    bool started = false;
+    int clipsDone = 0;
+    std::vector<std::string> typed;   // Text of each finished clip
+    uint32_t positionChecks = 0;
+    uint32_t wrongPositions = 0;
+    float lastWPM = 0;
+    uint32_t wpmUpdates = 0;       // Speed feedback that moved while keys went out
+
+    // Mid-text pause
+    static constexpr int PAUSE_CLIP = 5;
+    static constexpr size_t PAUSE_AFTER_CHARS = 400;
+    static constexpr uint32_t PAUSE_HOLD = 3000;
+    static constexpr uint32_t PAUSE_LATENCY = 50;   // Press to engine paused, at most
+    enum class Pause { WAITING, PRESSED, HELD, DONE } pause = Pause::WAITING;
+    uint32_t pausePressedAt = 0;
+    uint32_t pausedAt = 0;
+    uint32_t keysAtPause = 0;
+    uint32_t keysWhilePaused = 0;
+    size_t pausedAtChar = 0;
+
+    void press(uint32_t at, uint32_t hold) {
+        steps.push_back({at, LOW});
+        steps.push_back({at + hold, HIGH});
+    }
+
+    uint32_t run() {
+        uint32_t now = millis();
+        uint32_t keys = tap.keys;
+        tap.drain();
+        // Keys read after a pause landed went out before it; a paused
+        // tracker reports no position
+        if (tap.keys != keys && !paused) checkPosition();
+
+        if (!started && paused) {
+            event("BUTTON", "single (start)");
+            press(now, 80);
+            started = true;
+        }
+        if (sectionComplete && steps.empty() && clipsDone < currentClip - 1) {
+            clipsDone = currentClip - 1;
+            event("CLIP_DONE", "%d", clipsDone);
+            typed.push_back(tap.text);
+            tap.text.clear();
+            event("BUTTON", "double (next section)");
+            press(now + 500, 80);
+            press(now + 700, 80);
+        }
+
+        checkPause(now);
+
+        while (!steps.empty() && (int32_t)(now - steps.front().at) >= 0) {
+            setPinInput(Constants::Hardware::BUTTON_PIN, steps.front().level);
+            steps.erase(steps.begin());
+        }
+        return Constants::Ui::POLL;
+    }
+
+    // Keys just went out, so progress must report the clip being typed.
+    // The measured speed the simulator adapts to should follow them too.
+    void checkPosition() {
+        auto progress = simulator.getProgress();
+        positionChecks++;
+        float wpm = simulator.getPerformanceMetrics().averageWPM;
+        if (wpm != lastWPM) wpmUpdates++;
+        lastWPM = wpm;
+        // Keys read after a clip completed are its last ones
+        int typing = sectionComplete ? currentClip - 1 : currentClip;
+        if (progress.clipNumber == typing) return;
+        if (wrongPositions++ == 0) {
+            event("POSITION", "progress reports clip %d while clip %d is typed", progress.clipNumber,
+                  typing);
+        }
+    }
+
+    // A single press well inside a paragraph, another one PAUSE_HOLD after
+    // the engine has paused; keys sent in between are counted
+    void checkPause(uint32_t now) {
+        switch (pause) {
+            case Pause::WAITING:
+                if (started && !paused && steps.empty() && currentClip == PAUSE_CLIP &&
+                    tap.text.size() >= PAUSE_AFTER_CHARS) {
+                    event("BUTTON", "single (pause at char %u)", (unsigned)tap.text.size());
+                    press(now, 80);
+                    pausePressedAt = now;
+                    pause = Pause::PRESSED;
+                }
+                break;
+            case Pause::PRESSED:
+                if (paused) {
+                    pausedAt = now;
+                    keysAtPause = tap.keys;
+                    pausedAtChar = tap.text.size();
+                    event("PAUSED", "%lu ms after the press, at char %u", (unsigned long)(now - pausePressedAt),
+                          (unsigned)pausedAtChar);
+                    pause = Pause::HELD;
+                }
+                break;
+            case Pause::HELD:
+                if (now - pausedAt >= PAUSE_HOLD) {
+                    keysWhilePaused = tap.keys - keysAtPause;
+                    event("BUTTON", "single (resume)");
+                    press(now, 80);
+                    pause = Pause::DONE;
+                }
+                break;
+            case Pause::DONE:
+                break;
+        }
+    }
+
+    static uint32_t scheduled(void* param) { return static_cast<Operator*>(param)->run(); }
+};
+
+// Collects a trace dump in memory
+class Capture : public Print {
+public:
+    std::string text;
+    size_t write(uint8_t c) override {
+        text += (char)c;
+        return 1;
+    }
+    using Print::write;
+};
+
+// Whether the firmware trace so far holds a FILE_BEGIN / FILE_END record
+// for `file`; for FILE_END, `loaded` must match too
+static bool traced(Utils::TraceEvent event, Utils::TraceFile file, bool loaded = true) {
+    Capture dump;
+    Utils::trace().dump(dump);
+    size_t pos = 0;
+    while ((pos = dump.text.find("#T ", pos)) != std::string::npos) {
+        unsigned sequence, micros, kind, core, arg0, arg1;
+        pos += 3;
+        if (sscanf(dump.text.c_str() + pos, "%8x%8x%2x%2x%4x%8x", &sequence, &micros, &kind, &core,
+                   &arg0, &arg1) != 6) {
+            continue;
+        }
+        if (kind == (unsigned)event && arg0 == (unsigned)file &&
+            (event != Utils::TraceEvent::FILE_END || (arg1 != 0) == loaded)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static std::vector<size_t> wordLengths(const std::string& text) {
+    std::vector<size_t> lengths;
+    size_t n = 0;
+    for (char c : text) {
+        if (c == ' ' || c == '\n') {
+            if (n) lengths.push_back(n);
+            n = 0;
+        } else {
+            n++;
+        }
+    }
+    if (n) lengths.push_back(n);
+    return lengths;
+}
+
+int main(int argc, char** argv) {
+    const char* dataDir = "data";
+    const char* tracePath = "session_trace.txt";
+    const char* logPath = nullptr;
+    unsigned long seed = 1;
+    uint32_t limitMinutes = 24 * 60;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--trace") == 0 && i + 1 < argc) tracePath = argv[++i];
+        else if (strcmp(argv[i], "--log") == 0 && i + 1 < argc) logPath = argv[++i];
+        else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) seed = strtoul(argv[++i], nullptr, 10);
+        else if (strcmp(argv[i], "--limit") == 0 && i + 1 < argc) limitMinutes = atoi(argv[++i]);
+        else dataDir = argv[i];
+    }
+
+    trace = fopen(tracePath, "w");
+    if (!trace) {
+        fprintf(stderr, "ERROR: cannot write %s\n", tracePath);
+        return 1;
+    }
+    // Firmware serial output: to a file, or dropped
+    FILE* log = logPath ? fopen(logPath, "w") : nullptr;
+    Serial.setOutput(log);
+
+    SPIFFS.setRoot(dataDir);
+    setVirtualClock(true);
+    rng.seed(seed);
+    auto wall = std::chrono::steady_clock::now();
+    uint32_t start = millis();
+
+    setup();
+    bool fromImage = traced(Utils::TraceEvent::FILE_END, Utils::TraceFile::TASK_IMAGE);
+    bool textParsed = traced(Utils::TraceEvent::FILE_BEGIN, Utils::TraceFile::TEXT);
+    Operator op;
+    Utils::Scheduler::instance().add("operator", Operator::scheduled, &op);
+
+    uint32_t limit = limitMinutes * 60000;
+    while (!allClipsDone && millis() - start < limit) loop();
+    tap.drain();
+    event(allClipsDone ? "FINISHED" : "TIMEOUT", "clip %d", currentClip - 1);
+    fclose(trace);
+    // Log records still queued, then the event trace, as a triple press
+    // would dump it
+    Utils::Logger::instance().drain(Serial);
+    Utils::trace().dump(Serial);
+    if (log) fclose(log);
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - wall).count();
+    uint32_t virtualMillis = millis() - start;
+
+    // Check each clip's output against the parsed text
+    auto parsed = Analysis::TextParser::parseFile();
+    int failures = allClipsDone ? 0 : 1;
+    if (op.wrongPositions > 0 || op.positionChecks == 0) {
+        printf("Progress named the wrong clip %u of %u times\n", op.wrongPositions, op.positionChecks);
+        failures++;
+    }
+    // Typing stats feed the speed adjustment; if they only change between
+    // texts, the typing speed is set without seeing the text being typed
+    if (op.wpmUpdates * FEEDBACK_EVERY < op.positionChecks) {
+        printf("Speed feedback moved %u times in %u key batches\n", op.wpmUpdates, op.positionChecks);
+        failures++;
+    }
+    // The pause must land inside the description, not at its end
+    bool pauseOk = op.pause == Operator::Pause::DONE && op.keysWhilePaused == 0 &&
+                   op.pausedAt - op.pausePressedAt <= Operator::PAUSE_LATENCY &&
+                   (int)parsed.clips.size() >= Operator::PAUSE_CLIP &&
+                   op.pausedAtChar < parsed.clips[Operator::PAUSE_CLIP - 1].mainDescription.length();
+    if (!pauseOk) {
+        printf("Mid-text pause in clip %d: %s at char %u, %lu ms after the press, %u keys while paused\n",
+               Operator::PAUSE_CLIP, op.pause == Operator::Pause::DONE ? "stopped" : "never stopped",
+               (unsigned)op.pausedAtChar, (unsigned long)(op.pausedAt - op.pausePressedAt),
+               op.keysWhilePaused);
+        failures++;
+    }
+    // The sentence pause belongs between the '.' and the next key, not
+    // before the word that ends the sentence
+    if (tap.sentenceEnds == 0 || tap.shortSentenceGaps > 0) {
+        printf("Sentence pause missing after %u of %u sentence ends\n", tap.shortSentenceGaps,
+               tap.sentenceEnds);
+        failures++;
+    }
+    if (fromImage && textParsed) {
+        printf("Task image loaded, but text.txt was tokenized as well\n");
+        failures++;
+    }
+    for (size_t i = 0; i < parsed.clips.size(); i++) {
+        const auto& clip = parsed.clips[i];
+        std::string expected;
+        size_t words = 0;       // Sum over the texts; one word less per pair run together
+        auto addText = [&](const String& text) {
+            if (text.isEmpty()) return;
+            if (!expected.empty()) expected += '\n';
+            expected += text.c_str();
+            words += wordLengths(text.c_str()).size();
+        };
+        addText(clip.mainDescription);
+        for (const auto& frame : clip.timeframes) {
+            if (frame.type == Analysis::TimeFrame::Type::TYPING) addText(frame.content);
+        }
+        bool typed = i < op.typed.size();
+        size_t typedWords = typed ? wordLengths(op.typed[i]).size() : 0;
+        if (typed && typedWords < words) {
+            printf("Clip %d: %u texts run into the next one\n", clip.number, (unsigned)(words - typedWords));
+            failures++;
+            continue;
+        }
+        bool ok = typed && wordLengths(op.typed[i]) == wordLengths(expected);
+        if (!ok) {
+            printf("Clip %d: %s\n", clip.number, typed ? "MISMATCH" : "not typed");
+            if (typed) printf("  got:      %s\n  expected: %s\n", op.typed[i].c_str(), expected.c_str());
+            failures++;
+        }
+    }
+
+    printf("Task from %s\n", fromImage ? "task.bin" : "text.txt");
+    printf("Speed feedback moved %u times in %u key batches\n", op.wpmUpdates, op.positionChecks);
+    printf("Sentence pause after %u of %u sentence ends\n", tap.sentenceEnds - tap.shortSentenceGaps,
+           tap.sentenceEnds);
+    printf("Paused clip %d at char %u, %lu ms after the press\n", Operator::PAUSE_CLIP,
+           (unsigned)op.pausedAtChar, (unsigned long)(op.pausedAt - op.pausePressedAt));
+    printf("%d clips, %u keys, %u reports in %.1f virtual minutes, %.3f s wall (%.0fx)\n",
+           (int)op.typed.size(), tap.keys, keyboard.getTransport().total(),
+           virtualMillis / 60000.0, seconds, virtualMillis / 1000.0 / seconds);
+    if (tap.lost) printf("WARNING: %u reports overwritten before the trace read them\n", tap.lost);
+    printf("Trace written to %s\n", tracePath);
+    printf(failures ? "Session FAILED\n" : "Session OK\n");
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,195 @@
+// Buzzer sequencer check. Plays every SoundType pattern through
+// Ui::BuzzerSequencer into a fake PWM driver that records each tone
+// change with its time, and compares the recorded timeline with the
+// pattern table: stepped exactly as the esp_timer would, and stepped
+// late at the host UI poll period and at an odd period that lands
+// between tone boundaries. Also checks that a new sound cuts off
+// the current one and that Hardware::playSound() returns without waiting.
+// Exits non-zero on a mismatch. Build and usage are described in
+// tools/README.md.
+#include <Arduino.h>
+#include <vector>
+#include "hardware.h"
+
+using SoundType = Hardware::SoundType;
+
+struct Change {
+    uint32_t at;
+    uint16_t hz;
+};
+
+class FakePwm {
+public:
+    std::vector<Change> changes;
+    uint32_t now = 0;
+
+    void tone(uint16_t hz) { changes.push_back({now, hz}); }
+};
+
+using Sequencer = Ui::BuzzerSequencer<FakePwm>;
+
+static int failures = 0;
+
+static const struct {
+    SoundType type;
+    const char* name;
+} SOUNDS[] = {
+    {SoundType::SECTION_COMPLETE, "SECTION_COMPLETE"},
+    {SoundType::ERROR, "ERROR"},
+    {SoundType::SUCCESS, "SUCCESS"},
+    {SoundType::SPEED_WARNING, "SPEED_WARNING"},
+    {SoundType::PROGRESS_MILESTONE, "PROGRESS_MILESTONE"},
+};
+
+// What the driver should see: each tone at its start, then 0 at the end
+static std::vector<Change> expected(const Ui::SoundPattern& pattern, uint32_t start) {
+    std::vector<Change> changes;
+    uint32_t at = start;
+    for (uint8_t i = 0; i < pattern.length; i++) {
+        changes.push_back({at, pattern.tones[i].hz});
+        at += pattern.tones[i].millis;
+    }
+    changes.push_back({at, 0});
+    return changes;
+}
+
+// Runs advance() at the times it asks for (as the one-shot timer does),
+// or only every `poll` ms when poll is non-zero (as update() does on the
+// host). Stops when the sequencer goes idle.
+static void run(Sequencer& sequencer, FakePwm& pwm, uint32_t poll, uint32_t limit) {
+    uint32_t end = pwm.now + limit;
+    while (pwm.now < end) {
+        uint32_t next = sequencer.advance(pwm.now);
+        if (next == Sequencer::IDLE) return;
+        pwm.now += poll ? poll : next;
+    }
+}
+
+// A late poll may start each tone up to `slack` ms late but never earlier
+// or later than that, and never on a drifted timeline
+static bool matches(const std::vector<Change>& got, const std::vector<Change>& want, uint32_t slack) {
+    if (got.size() != want.size()) return false;
+    for (size_t i = 0; i < got.size(); i++) {
+        if (got[i].hz != want[i].hz) return false;
+        if (got[i].at < want[i].at || got[i].at > want[i].at + slack) return false;
+    }
+    return true;
+}
+
+static void print(const char* label, const std::vector<Change>& changes) {
+    printf("  %s:", label);
+    for (const auto& c : changes) printf(" %uHz@%u", c.hz, c.at);
+    printf("\n");
+}
+
+static void check(const char* name, const char* mode, const std::vector<Change>& got,
+                  const std::vector<Change>& want, uint32_t slack) {
+    bool ok = matches(got, want, slack);
+    printf("%-20s %-7s %s\n", name, mode, ok ? "OK" : "FAIL");
+    if (!ok) {
+        print("got", got);
+        print("expected", want);
+        failures++;
+    }
+}
+
+static void checkPatterns() {
+    for (const auto& sound : SOUNDS) {
+        const Ui::SoundPattern& pattern = Hardware::soundPattern(sound.type);
+        // 0 = timer; 7 ms never lines up with the tone lengths, so each
+        // boundary is seen late and any drift would add up
+        const uint32_t modes[] = {0, Constants::Ui::POLL, 7};
+        for (uint32_t poll : modes) {
+            char mode[16];
+            snprintf(mode, sizeof(mode), poll ? "poll %u" : "timer", poll);
+            FakePwm pwm;
+            Sequencer sequencer(pwm);
+            pwm.now = 1000;
+            sequencer.play(pattern);
+            run(sequencer, pwm, poll, 5000);
+            bool idle = !sequencer.isPlaying();
+            check(sound.name, mode, pwm.changes, expected(pattern, 1000),
+                  poll ? poll - 1 : 0);
+            if (!idle) {
+                printf("  still playing after the pattern\n");
+                failures++;
+            }
+        }
+    }
+}
+
+// A sound posted mid-pattern replaces it on the next advance()
+static void checkInterrupt() {
+    FakePwm pwm;
+    Sequencer sequencer(pwm);
+    const Ui::SoundPattern& first = Hardware::soundPattern(SoundType::SECTION_COMPLETE);
+    const Ui::SoundPattern& second = Hardware::soundPattern(SoundType::ERROR);
+
+    sequencer.play(first);
+    sequencer.advance(pwm.now);
+    pwm.now += first.tones[0].millis + 5;
+    sequencer.advance(pwm.now);      // Into the second tone
+    uint32_t cut = pwm.now + 3;
+    pwm.now = cut;
+    sequencer.play(second);
+    run(sequencer, pwm, 0, 5000);
+
+    std::vector<Change> want = expected(first, 0);
+    want.resize(2);                  // First two tones only
+    want[1].at = first.tones[0].millis + 5;
+    std::vector<Change> rest = expected(second, cut);
+    want.insert(want.end(), rest.begin(), rest.end());
+    check("interrupted", "timer", pwm.changes, want, 0);
+
+    // Silence stops at once
+    FakePwm quiet;
+    Sequencer silenced(quiet);
+    silenced.play(first);
+    silenced.advance(0);
+    quiet.now = 10;
+    silenced.play(Sequencer::SILENCE);
+    silenced.advance(quiet.now);
+    check("silenced", "timer", quiet.changes, {{0, first.tones[0].hz}, {10, 0}}, 0);
+}
+
+// Through Hardware on the virtual clock: playSound() takes no time, the
+// LEDC channel carries the tone, update() plays the pattern out
+static void checkHardware() {
+    Hardware hardware;
+    hardware.init();
+    const uint8_t channel = Constants::Hardware::BUZZER_CHANNEL;
+    const Ui::SoundPattern& pattern = Hardware::soundPattern(SoundType::SECTION_COMPLETE);
+
+    uint32_t start = millis();
+    hardware.playSound(SoundType::SECTION_COMPLETE);
+    bool ok = millis() == start && ledcReadFreq(channel) == 0;
+
+    hardware.update();
+    ok &= ledcReadFreq(channel) == pattern.tones[0].hz && ledcRead(channel) > 0;
+
+    uint32_t total = 0;
+    for (uint8_t i = 0; i < pattern.length; i++) total += pattern.tones[i].millis;
+    for (uint32_t t = 0; t <= total + Constants::Ui::POLL; t += Constants::Ui::POLL) {
+        delay(Constants::Ui::POLL);
+        hardware.update();
+    }
+    ok &= ledcRead(channel) == 0;
+
+    hardware.enableSound(false);
+    hardware.playSound(SoundType::ERROR);
+    hardware.update();
+    ok &= ledcRead(channel) == 0;
+
+    printf("%-20s %-7s %s\n", "Hardware", "shim", ok ? "OK" : "FAIL");
+    if (!ok) failures++;
+    detachInterrupt(Constants::Hardware::BUTTON_PIN);
+}
+
+int main() {
+    setVirtualClock(true);
+    checkPatterns();
+    checkInterrupt();
+    checkHardware();
+    printf(failures ? "%d check(s) FAILED\n" : "All checks passed\n", failures);
+    return failures ? 1 : 0;
+}
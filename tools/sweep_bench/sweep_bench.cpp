@@ -0,0 +1,229 @@
+// Interval sweep check and benchmark. Runs Timing::IntervalSweep over
+// timeframe-shaped intervals in sorted, nearly sorted, rotated and
+// shuffled order, and times it against the event-list sweep it replaced
+// (a vector of start/end events, std::sort, vectors of gaps and
+// overlaps). Checks that sortNearlySorted() sorts every order, that
+// both sweeps agree on coverage, overlap and gaps, that a rotated input
+// (one descent, many inversions) costs no more than a shuffled one, and
+// that the sweep allocates nothing. Exits non-zero on a failed check.
+// Build and usage are described in tools/README.md.
+#include <Arduino.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <new>
+#include <vector>
+#include "timing/interval_sweep.h"
+#include "utils/random.h"
+
+static std::atomic<uint32_t> allocations{0};
+
+void* operator new(size_t size) {
+    allocations++;
+    if (void* p = malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+void operator delete(void* p) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { free(p); }
+
+static int failures = 0;
+
+static void report(const char* name, bool ok, const char* detail) {
+    printf("%-30s %s  %s\n", name, ok ? "OK  " : "FAIL", detail);
+    if (!ok) failures++;
+}
+
+struct Interval {
+    uint32_t start;
+    uint32_t end;
+};
+
+enum class Order { SORTED, NEARLY_SORTED, ROTATED, SHUFFLED };
+
+static const char* orderName(Order order) {
+    switch (order) {
+        case Order::SORTED: return "sorted";
+        case Order::NEARLY_SORTED: return "nearly sorted";
+        case Order::ROTATED: return "rotated";
+        case Order::SHUFFLED: return "shuffled";
+    }
+    return "";
+}
+
+// Back-to-back timeframes with some overlaps and gaps, then put in the
+// requested order. Nearly sorted moves 2% of them a few places later, as
+// a timeframe listed out of order in text.txt would be.
+static std::vector<Interval> makeIntervals(size_t n, Order order, Utils::Random& rng) {
+    std::vector<Interval> intervals;
+    uint32_t now = 0;
+    for (size_t i = 0; i < n; i++) {
+        uint32_t length = rng.between(500, 4000);
+        if (rng.chance(0.2f)) now -= std::min<uint32_t>(now, rng.between(100, 600));
+        else if (rng.chance(0.2f)) now += rng.between(100, 900);
+        intervals.push_back({now, now + length});
+        now += length;
+    }
+    switch (order) {
+        case Order::SORTED:
+            break;
+        case Order::NEARLY_SORTED:
+            for (size_t k = 0; k < n / 50; k++) {
+                size_t i = rng.below(n);
+                size_t j = std::min(n - 1, i + 1 + rng.below(4));
+                std::rotate(intervals.begin() + i, intervals.begin() + i + 1, intervals.begin() + j + 1);
+            }
+            break;
+        case Order::ROTATED:
+            std::rotate(intervals.begin(), intervals.begin() + n / 3, intervals.end());
+            break;
+        case Order::SHUFFLED:
+            for (size_t i = n; i > 1; i--) std::swap(intervals[i - 1], intervals[rng.below(i)]);
+            break;
+    }
+    return intervals;
+}
+
+struct Result {
+    uint32_t covered = 0;
+    uint32_t overlap = 0;
+    uint32_t gap = 0;
+    size_t gaps = 0;
+
+    bool operator==(const Result& o) const {
+        return covered == o.covered && overlap == o.overlap && gap == o.gap && gaps == o.gaps;
+    }
+};
+
+// The sweep as it was: one event per interval end, sorted as pairs
+static Result eventSweep(const std::vector<Interval>& intervals) {
+    struct Range {
+        uint32_t start;
+        uint32_t end;
+    };
+    std::vector<std::pair<uint32_t, int>> events;
+    std::vector<Range> gaps;
+    std::vector<Range> overlaps;
+    for (const auto& interval : intervals) {
+        events.push_back(std::make_pair(interval.start, 1));
+        events.push_back(std::make_pair(interval.end, -1));
+    }
+    std::sort(events.begin(), events.end());
+
+    Result result;
+    int active = 0;
+    uint32_t lastTime = events[0].first;
+    Range currentRange = {0, 0};
+    for (const auto& event : events) {
+        uint32_t now = event.first;
+        if (active > 0) result.covered += now - lastTime;
+        if (active > 1) {
+            result.overlap += now - lastTime;
+            if (currentRange.start == 0) currentRange.start = lastTime;
+        } else if (active == 1 && currentRange.start > 0) {
+            currentRange.end = lastTime;
+            overlaps.push_back(currentRange);
+            currentRange = {0, 0};
+        }
+        if (active == 0 && lastTime > events[0].first) {
+            gaps.push_back({lastTime, now});
+            result.gap += now - lastTime;
+            if (now > lastTime) result.gaps++;        // Zero-length gaps are not reported now
+        }
+        active += event.second;
+        lastTime = now;
+    }
+    return result;
+}
+
+struct Counter {
+    size_t gaps = 0;
+    size_t overlaps = 0;
+    void onGap(uint32_t, uint32_t) { gaps++; }
+    void onOverlap(uint32_t, uint32_t) { overlaps++; }
+};
+
+static Result intervalSweep(const std::vector<Interval>& intervals, Timing::SweepScratch scratch) {
+    scratch.clear();
+    for (const auto& interval : intervals) scratch.add(interval.start, interval.end);
+    Counter counter;
+    auto totals = Timing::IntervalSweep::run(scratch, counter);
+    return {totals.coveredMillis, totals.overlapMillis, totals.gapMillis, counter.gaps};
+}
+
+template<typename Run>
+static double microsPerRun(int rounds, Run run) {
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < rounds; i++) run();
+    return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / rounds;
+}
+
+static const size_t MAX_INTERVALS = 100000;
+static Timing::SweepBuffer<MAX_INTERVALS> buffer;
+
+static void checkSort(Utils::Random& rng) {
+    bool ok = true;
+    uint32_t cases = 0;
+    for (size_t n : {0, 1, 2, 3, 17, 100, 5000}) {
+        for (Order order : {Order::SORTED, Order::NEARLY_SORTED, Order::ROTATED, Order::SHUFFLED}) {
+            auto intervals = makeIntervals(n, order, rng);
+            std::vector<uint32_t> values;
+            for (const auto& interval : intervals) values.push_back(interval.start);
+            // Duplicates and a reversed run as well
+            if (n > 4) values[n / 2] = values[n / 4];
+            std::vector<uint32_t> expected = values;
+            std::sort(expected.begin(), expected.end());
+            Timing::IntervalSweep::sortNearlySorted(values.data(), values.size());
+            ok &= values == expected;
+            std::reverse(values.begin(), values.end());
+            Timing::IntervalSweep::sortNearlySorted(values.data(), values.size());
+            ok &= values == expected;
+            cases += 2;
+        }
+    }
+    char detail[96];
+    snprintf(detail, sizeof(detail), "%u arrays, every order, duplicates, reversed", cases);
+    report("sortNearlySorted()", ok, detail);
+}
+
+int main(int argc, char** argv) {
+    int rounds = 20;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--rounds") == 0 && i + 1 < argc) rounds = atoi(argv[++i]);
+    }
+
+    Utils::Random rng(6);
+    checkSort(rng);
+
+    char name[48];
+    char detail[128];
+    for (size_t n : {1000, 10000, 100000}) {
+        printf("\n%zu intervals %20s %14s %8s\n", n, "sweep us", "event sort us", "speedup");
+        double shuffled = 0;
+        double rotated = 0;
+        bool same = true;
+        uint32_t allocated = 0;
+        for (Order order : {Order::SORTED, Order::NEARLY_SORTED, Order::ROTATED, Order::SHUFFLED}) {
+            auto intervals = makeIntervals(n, order, rng);
+            same &= intervalSweep(intervals, buffer.scratch()) == eventSweep(intervals);
+
+            uint32_t before = allocations;
+            double sweep = microsPerRun(rounds, [&] { intervalSweep(intervals, buffer.scratch()); });
+            allocated += allocations - before;
+            double events = microsPerRun(rounds, [&] { eventSweep(intervals); });
+            printf("  %-24s %12.1f %14.1f %7.1fx\n", orderName(order), sweep, events, events / sweep);
+            if (order == Order::SHUFFLED) shuffled = sweep;
+            if (order == Order::ROTATED) rotated = sweep;
+        }
+        snprintf(name, sizeof(name), "results, %zu intervals", n);
+        report(name, same, "coverage, overlap and gaps match the event sweep");
+        snprintf(name, sizeof(name), "rotated cost, %zu intervals", n);
+        snprintf(detail, sizeof(detail), "%.1f us rotated, %.1f us shuffled", rotated, shuffled);
+        report(name, rotated <= shuffled * 1.5, detail);
+        snprintf(name, sizeof(name), "no allocation, %zu intervals", n);
+        snprintf(detail, sizeof(detail), "%u allocations in %d sweeps", allocated, rounds * 4);
+        report(name, allocated == 0, detail);
+    }
+
+    printf(failures ? "%d check(s) FAILED\n" : "All checks passed\n", failures);
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,54 @@
+// Offline task compiler: turns <data dir>/text.txt into <data dir>/task.bin
+// so the device can skip parsing and analysis at boot. Build and usage are
+// described in tools/README.md.
+#include <Arduino.h>
+#include <SPIFFS.h>
+#include "analysis/task_image.h"
+#include "analysis/task_analyzer.h"
+
+int main(int argc, char** argv) {
+    const char* dataDir = argc > 1 ? argv[1] : "data";
+    SPIFFS.setRoot(dataDir);
+
+    Analysis::TaskImage::SourceStamp source;
+    if (!Analysis::TaskImage::stampSource(Analysis::TextParser::DEFAULT_PATH, source)) {
+        fprintf(stderr, "ERROR: cannot open %s%s\n", dataDir, Analysis::TextParser::DEFAULT_PATH);
+        return 1;
+    }
+
+    auto parseResult = Analysis::TextParser::parseFile();
+    if (!parseResult.isValid || parseResult.clips.empty()) {
+        fprintf(stderr, "ERROR: parse failed: %s\n", parseResult.errorMessage.c_str());
+        return 1;
+    }
+
+    auto analysis = Analysis::TaskAnalyzer::analyze(parseResult);
+    if (!analysis.timingValid) {
+        fprintf(stderr, "WARNING: %s\n", analysis.timingError.c_str());
+    }
+
+    Analysis::TaskImageWriter::Inputs inputs;
+    inputs.duration = analysis.duration;
+    inputs.metrics = analysis.metrics;
+    inputs.difficulty = Analysis::DifficultyScorer::calculate(inputs.metrics);
+    inputs.aht = AHT::Calculator::calculate(inputs.duration.totalMillis / 1000.0f);
+    inputs.source = source;
+
+    std::vector<uint8_t> image = Analysis::TaskImageWriter::build(parseResult, inputs);
+
+    File out = SPIFFS.open(Analysis::TaskImage::DEFAULT_PATH, "w");
+    if (!out || out.write(image.data(), image.size()) != image.size()) {
+        fprintf(stderr, "ERROR: cannot write %s%s\n", dataDir, Analysis::TaskImage::DEFAULT_PATH);
+        return 1;
+    }
+    out.close();
+
+    printf("Video %s: %zu clips, %.3f s, difficulty %.2f, target AHT %.1f min\n",
+           parseResult.videoId.c_str(), parseResult.clips.size(),
+           inputs.duration.totalMillis / 1000.0f,
+           inputs.difficulty.normalizedScore, inputs.aht.targetMinutes);
+    printf("Wrote %s%s (%zu bytes from %u bytes of text, CRC-32 %08x)\n",
+           dataDir, Analysis::TaskImage::DEFAULT_PATH, image.size(), (unsigned)source.size,
+           (unsigned)source.crc);
+    return 0;
+}
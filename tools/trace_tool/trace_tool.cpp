@@ -0,0 +1,291 @@
+// Event trace decoder and benchmark. `decode` reads a serial capture that
+// holds a Utils::Trace dump (a triple press or 't' on the console, or the
+// end of a session_sim --log) and writes Chrome trace JSON, for
+// chrome://tracing or ui.perfetto.dev. `bench` measures the cost of
+// recording an event, alone and with several threads writing at once,
+// and checks that concurrent writers neither lose nor tear records and
+// that a dump decodes back to what was recorded. Exits non-zero on a
+// failed check. Build and usage are described in tools/README.md.
+#include <Arduino.h>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+#include "utils/trace.h"
+
+using Utils::TraceEvent;
+
+struct Event {
+    uint32_t sequence;
+    uint64_t micros;        // Unwrapped
+    uint8_t event;
+    uint8_t core;
+    uint16_t arg0;
+    uint32_t arg1;
+};
+
+// Records of the last complete dump in `text`. Lines may carry a prefix
+// (serial monitor timestamps); a record is the 32 hex digits after "#T ".
+static bool parseDump(const std::string& text, std::vector<Event>& events) {
+    std::vector<Event> current;
+    bool found = false;
+    size_t pos = 0;
+    while (pos < text.size()) {
+        size_t end = text.find('\n', pos);
+        if (end == std::string::npos) end = text.size();
+        std::string line = text.substr(pos, end - pos);
+        pos = end + 1;
+
+        if (line.find("=== Trace v") != std::string::npos) {
+            current.clear();
+            continue;
+        }
+        if (line.find("=== End of trace") != std::string::npos) {
+            events = current;
+            found = true;
+            continue;
+        }
+        size_t tag = line.find("#T ");
+        if (tag == std::string::npos || line.size() < tag + 3 + 32) continue;
+        const char* hex = line.c_str() + tag + 3;
+        unsigned sequence, micros, event, core, arg0, arg1;
+        if (sscanf(hex, "%8x%8x%2x%2x%4x%8x", &sequence, &micros, &event, &core, &arg0, &arg1) != 6) {
+            continue;
+        }
+        current.push_back({sequence, micros, (uint8_t)event, (uint8_t)core, (uint16_t)arg0, arg1});
+    }
+
+    // micros() wraps every 71.6 minutes; records are in recording order
+    uint64_t base = 0;
+    uint32_t last = 0;
+    for (size_t i = 0; i < events.size(); i++) {
+        uint32_t raw = (uint32_t)events[i].micros;
+        if (i > 0 && raw < last && last - raw > 0x80000000u) base += 1ull << 32;
+        events[i].micros = base + raw;
+        last = raw;
+    }
+    return found;
+}
+
+static std::string keyName(uint16_t key) {
+    char name[8];
+    if (key == '"' || key == '\\') snprintf(name, sizeof(name), "\\%c", key);
+    else if (key > ' ' && key < 0x7F) snprintf(name, sizeof(name), "%c", key);
+    else snprintf(name, sizeof(name), "0x%02x", key);
+    return name;
+}
+
+static const char* fileName(uint16_t file) {
+    switch ((Utils::TraceFile)file) {
+        case Utils::TraceFile::TASK_IMAGE: return "task.bin";
+        case Utils::TraceFile::TEXT: return "text.txt";
+    }
+    return "file";
+}
+
+// One Chrome trace event per record; the queue depth carried by a key
+// also feeds the counter track
+static void writeJson(FILE* out, const std::vector<Event>& events) {
+    uint64_t origin = events.empty() ? 0 : events.front().micros;
+    fprintf(out, "{\"traceEvents\":[\n");
+    fprintf(out, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"typer\"}}");
+    for (int core = 0; core < 2; core++) {
+        fprintf(out, ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,"
+                     "\"args\":{\"name\":\"core %d\"}}", core, core);
+    }
+    for (const Event& e : events) {
+        unsigned long long ts = e.micros - origin;
+        auto begin = [&](const char* name, const char* phase) {
+            fprintf(out, ",\n{\"name\":\"%s\",\"ph\":\"%s\",\"ts\":%llu,\"pid\":1,\"tid\":%u", name, phase,
+                    ts, e.core);
+        };
+        auto depth = [&](uint32_t keys) {
+            fprintf(out, ",\n{\"name\":\"hid queue\",\"ph\":\"C\",\"ts\":%llu,\"pid\":1,"
+                         "\"args\":{\"keys\":%u}}", ts, keys);
+        };
+        switch ((TraceEvent)e.event) {
+            case TraceEvent::KEY_EMIT:
+                begin("key", "i");
+                fprintf(out, ",\"s\":\"t\",\"args\":{\"key\":\"%s\"}}", keyName(e.arg0).c_str());
+                depth(e.arg1);
+                break;
+            case TraceEvent::QUEUE_DEPTH:
+                depth(e.arg1);
+                break;
+            case TraceEvent::BUTTON_EDGE:
+                begin(e.arg0 ? "button down" : "button up", "i");
+                fprintf(out, ",\"s\":\"p\"}");
+                break;
+            case TraceEvent::CLIP_START:
+                begin("clip", "B");
+                fprintf(out, ",\"args\":{\"clip\":%u}}", e.arg0);
+                break;
+            case TraceEvent::CLIP_END:
+                begin("clip", "E");
+                fprintf(out, ",\"args\":{\"finished\":%s}}", e.arg1 ? "true" : "false");
+                break;
+            case TraceEvent::BLE_CONNECT:
+                begin("connected", "i");
+                fprintf(out, ",\"s\":\"g\"}");
+                break;
+            case TraceEvent::BLE_DISCONNECT:
+                begin("disconnected", "i");
+                fprintf(out, ",\"s\":\"g\"}");
+                break;
+            case TraceEvent::FILE_BEGIN:
+                begin(fileName(e.arg0), "B");
+                fprintf(out, "}");
+                break;
+            case TraceEvent::FILE_END:
+                begin(fileName(e.arg0), "E");
+                fprintf(out, ",\"args\":{\"loaded\":%s}}", e.arg1 ? "true" : "false");
+                break;
+            default:
+                begin("unknown", "i");
+                fprintf(out, ",\"s\":\"t\",\"args\":{\"event\":%u,\"arg0\":%u,\"arg1\":%u}}", e.event,
+                        e.arg0, e.arg1);
+                break;
+        }
+    }
+    fprintf(out, "\n]}\n");
+}
+
+static int decode(const char* capturePath, const char* jsonPath) {
+    FILE* in = fopen(capturePath, "r");
+    if (!in) {
+        fprintf(stderr, "ERROR: cannot read %s\n", capturePath);
+        return 1;
+    }
+    std::string text;
+    char buffer[4096];
+    size_t n;
+    while ((n = fread(buffer, 1, sizeof(buffer), in)) > 0) text.append(buffer, n);
+    fclose(in);
+
+    std::vector<Event> events;
+    if (!parseDump(text, events)) {
+        fprintf(stderr, "ERROR: no complete trace dump in %s\n", capturePath);
+        return 1;
+    }
+    FILE* out = jsonPath ? fopen(jsonPath, "w") : stdout;
+    if (!out) {
+        fprintf(stderr, "ERROR: cannot write %s\n", jsonPath);
+        return 1;
+    }
+    writeJson(out, events);
+    if (jsonPath) {
+        fclose(out);
+        uint64_t span = events.empty() ? 0 : events.back().micros - events.front().micros;
+        printf("%u events over %.3f s written to %s\n", (unsigned)events.size(), span / 1e6, jsonPath);
+    }
+    return 0;
+}
+
+// Collects a dump in memory
+class Capture : public Print {
+public:
+    std::string text;
+    size_t write(uint8_t c) override {
+        text += (char)c;
+        return 1;
+    }
+    using Print::write;
+};
+
+using Ring = Utils::TraceRing<1024>;
+
+static int failures = 0;
+
+static void report(const char* name, bool ok, const char* detail) {
+    printf("%-30s %s  %s\n", name, ok ? "OK  " : "FAIL", detail);
+    if (!ok) failures++;
+}
+
+// Each thread records `count` events tagged with its id and a counter
+static double nanosPerEvent(Ring& ring, int threads, uint32_t count) {
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> writers;
+    for (int t = 0; t < threads; t++) {
+        writers.emplace_back([&ring, t, count] {
+            for (uint32_t i = 0; i < count; i++) ring.record(TraceEvent::KEY_EMIT, t, i);
+        });
+    }
+    for (auto& w : writers) w.join();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return seconds * 1e9 / count;        // Per event per writer: the latency a caller sees
+}
+
+static int bench(uint32_t count) {
+    static Ring ring;
+    char detail[96];
+
+    double alone = nanosPerEvent(ring, 1, count);
+    snprintf(detail, sizeof(detail), "%.1f ns/event, 1 writer", alone);
+    report("record() cost", alone < 1000, detail);
+
+    const int threads = 4;
+    static Ring shared;
+    double contended = nanosPerEvent(shared, threads, count / threads);
+    snprintf(detail, sizeof(detail), "%.1f ns/event, %d writers on one ring", contended, threads);
+    report("record() cost, contended", contended < 1000, detail);
+
+    // After the threads: exactly the last 1024 records, consecutive, each
+    // writer's counters in order
+    Capture capture;
+    shared.dump(capture);
+    std::vector<Event> events;
+    bool ok = parseDump(capture.text, events) && events.size() == 1024 &&
+              shared.total() == (count / threads) * threads;
+    std::vector<int64_t> lastSeen(threads, -1);
+    for (size_t i = 0; ok && i < events.size(); i++) {
+        const Event& e = events[i];
+        ok &= e.sequence == shared.total() - 1024 + i + 1 && e.event == (uint8_t)TraceEvent::KEY_EMIT;
+        ok &= e.arg0 < threads && (int64_t)e.arg1 > lastSeen[e.arg0];
+        if (ok) lastSeen[e.arg0] = e.arg1;
+    }
+    snprintf(detail, sizeof(detail), "%u recorded, %u decoded", shared.total(), (unsigned)events.size());
+    report("concurrent writers", ok, detail);
+
+    // Round trip: a partly filled ring, every event type and wide args
+    static Ring small;
+    for (uint8_t e = 0; e < (uint8_t)TraceEvent::COUNT; e++) {
+        small.record((TraceEvent)e, 0xFFFF - e, 0xFFFFFFF0u + e);
+    }
+    Capture roundTrip;
+    small.dump(roundTrip);
+    ok = parseDump(roundTrip.text, events) && events.size() == (size_t)TraceEvent::COUNT;
+    for (size_t i = 0; ok && i < events.size(); i++) {
+        ok &= events[i].sequence == i + 1 && events[i].event == i;
+        ok &= events[i].arg0 == 0xFFFF - i && events[i].arg1 == 0xFFFFFFF0u + i;
+    }
+    small.record(TraceEvent::BLE_CONNECT);
+    ok &= small.total() == (uint32_t)TraceEvent::COUNT + 1;
+    snprintf(detail, sizeof(detail), "%u events, recording resumes after dump", (unsigned)events.size());
+    report("dump round trip", ok, detail);
+
+    // The decoder unwraps micros() across its 32-bit wrap
+    std::string wrapped = "=== Trace v1: 2 records, 0 overwritten ===\n"
+                          "12:00:01 #T 00000001fffffff00500000000000000\n"
+                          "12:00:02 #T 00000002000000100600000000000000\n"
+                          "=== End of trace ===\n";
+    ok = parseDump(wrapped, events) && events.size() == 2 && events[1].micros - events[0].micros == 0x20;
+    report("micros() wrap", ok, "prefixed lines, 32 us across the wrap");
+
+    printf(failures ? "%d check(s) FAILED\n" : "All checks passed\n", failures);
+    return failures ? 1 : 0;
+}
+
+int main(int argc, char** argv) {
+    if (argc >= 3 && strcmp(argv[1], "decode") == 0) {
+        return decode(argv[2], argc >= 4 ? argv[3] : nullptr);
+    }
+    if (argc >= 2 && strcmp(argv[1], "bench") == 0) {
+        uint32_t count = 20000000;
+        for (int i = 2; i < argc; i++) {
+            if (strcmp(argv[i], "--count") == 0 && i + 1 < argc) count = atoi(argv[++i]);
+        }
+        return bench(count);
+    }
+    fprintf(stderr, "usage: %s decode <capture> [trace.json]\n       %s bench [--count n]\n", argv[0], argv[0]);
+    return 2;
+}
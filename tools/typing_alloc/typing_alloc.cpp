@@ -0,0 +1,143 @@
+// Typing path allocation test. Runs HumanSimulator::processClip, with the
+// real Keyboard, output queue and loopback transport on the shim's
+// virtual clock, and counts every heap allocation on the way from the
+// clip text to the transport. Clip 1 holds the longest description of the
+// data directory's text.txt, clip 3 the same text four times over; clip 2
+// is clip 3 again, typed first so storage sized once per text (pause
+// map, program buffer) is already at its largest. Checks that clip 3
+// allocates no more than clip 1, i.e. nothing per character, that
+// neither allocates at all, and that the text arrives complete. Exits
+// non-zero on a failed check. Build and usage are described in
+// tools/README.md.
+#include <Arduino.h>
+#include <SPIFFS.h>
+#include <atomic>
+#include <new>
+#include <string>
+#include <unistd.h>
+#include "analysis/text_parser.h"
+#include "human_simulator.h"
+#include "keyboard.h"
+
+static std::atomic<uint32_t> allocations{0};
+
+void* operator new(size_t size) {
+    allocations++;
+    if (void* p = malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+void operator delete(void* p) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { free(p); }
+
+static int failures = 0;
+
+static void report(const char* name, bool ok, const char* detail) {
+    printf("%-30s %s  %s\n", name, ok ? "OK  " : "FAIL", detail);
+    if (!ok) failures++;
+}
+
+static Ui::Link uiLink;
+static Keyboard keyboard;
+static Utils::Random rng;
+static HumanSimulator simulator(keyboard, uiLink, rng);
+
+// A clip whose description and only timeframe both hold `text`
+static std::string clipText(int number, uint32_t startMs, const std::string& text) {
+    char header[96];
+    uint32_t endMs = startMs + 10000;
+    snprintf(header, sizeof(header), "Clip #%d <00:%02u.%03u> - <00:%02u.%03u>\n", number, startMs / 1000,
+             startMs % 1000, endMs / 1000, endMs % 1000);
+    char frame[64];
+    snprintf(frame, sizeof(frame), "<00:%02u.%03u> - <00:%02u.%03u>\n", startMs / 1000, startMs % 1000,
+             endMs / 1000, endMs % 1000);
+    return header + text + "\n" + frame + text + "\n";
+}
+
+struct ClipRun {
+    uint32_t allocations = 0;
+    uint32_t chars = 0;       // Typed characters, from the loopback reports
+    bool finished = false;
+};
+
+static ClipRun typeClip(int number) {
+    auto& transport = keyboard.getTransport();
+    uint32_t reports = transport.total();
+    uint32_t before = allocations;
+    ClipRun run;
+    run.finished = simulator.processClip(number);
+    run.allocations = allocations - before;
+    // Two reports (press, release) per key, tabs and typo fixes included
+    run.chars = (transport.total() - reports) / 2;
+    return run;
+}
+
+int main(int argc, char** argv) {
+    const char* dataDir = "data";
+    unsigned long seed = 1;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) seed = strtoul(argv[++i], nullptr, 10);
+        else dataDir = argv[i];
+    }
+
+    SPIFFS.setRoot(dataDir);
+    auto task = Analysis::TextParser::parseFile();
+    if (!task.isValid) {
+        fprintf(stderr, "ERROR: cannot parse %s/text.txt: %s\n", dataDir, task.errorMessage.c_str());
+        return 1;
+    }
+    std::string longest;
+    for (const auto& clip : task.clips) {
+        if (clip.mainDescription.length() > longest.size()) longest = clip.mainDescription.c_str();
+    }
+    std::string longer;
+    for (int i = 0; i < 4; i++) longer += (i ? " " : "") + longest;
+
+    char dir[] = "/tmp/typing_alloc_XXXXXX";
+    if (!mkdtemp(dir)) {
+        fprintf(stderr, "ERROR: cannot create a temporary directory\n");
+        return 1;
+    }
+    std::string path = std::string(dir) + Analysis::TextParser::DEFAULT_PATH;
+    std::string text = "Video typing_alloc\n" + clipText(1, 0, longest) + clipText(2, 10000, longer) +
+                       clipText(3, 20000, longer);
+    FILE* f = fopen(path.c_str(), "wb");
+    fwrite(text.data(), 1, text.size(), f);
+    fclose(f);
+    SPIFFS.setRoot(dir);
+
+    setVirtualClock(true);
+    rng.seed(seed);
+    keyboard.init(Keyboard::OutputMode::SCHEDULER);
+    simulator.init();
+    simulator.loadTask();
+    simulator.resume();
+
+    ClipRun warmup = typeClip(2);
+    ClipRun shortRun = typeClip(1);
+    ClipRun longRun = typeClip(3);
+    unlink(path.c_str());
+    rmdir(dir);
+
+    printf("%-24s %8s %12s\n", "clip", "keys", "allocations");
+    printf("%-24s %8u %12u\n", "2 (warm-up, 4x text)", warmup.chars, warmup.allocations);
+    printf("%-24s %8u %12u\n", "1 (longest text)", shortRun.chars, shortRun.allocations);
+    printf("%-24s %8u %12u\n\n", "3 (4x text)", longRun.chars, longRun.allocations);
+
+    char detail[128];
+    bool typed = warmup.finished && shortRun.finished && longRun.finished &&
+                 longRun.chars >= 4 * 2 * longest.size() && shortRun.chars >= 2 * longest.size();
+    snprintf(detail, sizeof(detail), "%u and %u keys for %zu and %zu characters", shortRun.chars,
+             longRun.chars, 2 * longest.size(), 2 * longer.size());
+    report("clips typed", typed, detail);
+
+    uint32_t extraChars = longRun.chars - shortRun.chars;
+    snprintf(detail, sizeof(detail), "%u more allocations for %u more keys",
+             longRun.allocations - shortRun.allocations, extraChars);
+    report("nothing per character", longRun.allocations <= shortRun.allocations, detail);
+    snprintf(detail, sizeof(detail), "%u allocations in clips 1 and 3, %u in the warm-up",
+             shortRun.allocations + longRun.allocations, warmup.allocations);
+    report("nothing once warmed up", shortRun.allocations + longRun.allocations == 0, detail);
+
+    printf(failures ? "%d check(s) FAILED\n" : "All checks passed\n", failures);
+    return failures ? 1 : 0;
+}